@@ -0,0 +1,3346 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "capture_reader.h"
+#include "crc32c.h"
+#include "event_cache.h"
+#include "inav.h"
+#include "message_builder.h"
+#include "metrics.h"
+#include "mpsc_fabric.h"
+#include "order_gateway.h"
+#include "order_index.h"
+#include "partition.h"
+#include "orderbook.h"
+#include "portfolio.h"
+#include "pre_trade_risk.h"
+#include "scheduler.h"
+#include "sharded_engine.h"
+#include "subscription_filter.h"
+#include "symbol_table.h"
+#include "trigger_index.h"
+#include "warmup.h"
+
+// ============================================================================
+// Benchmark Harness
+// ============================================================================
+// Usage: benchmark_ome [section ...]
+// With no arguments every section runs; otherwise only the named sections.
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsed_ns(Clock::time_point start, Clock::time_point end)
+{
+    return static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+// Deterministic xorshift RNG so every run replays identical traffic
+class FastRng
+{
+   public:
+    explicit FastRng(uint64_t seed) : state_(seed ? seed : 0x9E3779B97F4A7C15ULL) {}
+
+    uint64_t next()
+    {
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 7;
+        state_ ^= state_ << 17;
+        return state_;
+    }
+
+    uint32_t below(uint32_t bound) { return static_cast<uint32_t>(next() % bound); }
+
+   private:
+    uint64_t state_;
+};
+
+// Synthetic ITCH session: adds, partial executes, cancels and replaces against live orders
+// Adds rest within spread price units of the 10000/10001 touch on each side
+static std::vector<std::vector<uint8_t>> generate_feed(size_t message_count, uint64_t seed = 42,
+                                                       uint32_t spread = 50)
+{
+    std::vector<std::vector<uint8_t>> feed;
+    feed.reserve(message_count);
+
+    FastRng rng(seed);
+    std::vector<uint64_t> live;
+    std::vector<uint32_t> live_qty;
+    uint64_t next_id = 1;
+    uint64_t timestamp = 34200000000000ULL;  // 09:30:00.000
+
+    while (feed.size() < message_count)
+    {
+        timestamp += 1 + rng.below(500);
+        uint32_t roll = rng.below(100);
+
+        if (live.empty() || roll < 50)
+        {
+            char side = rng.below(2) ? 'B' : 'S';
+            uint32_t price = (side == 'B') ? 10000 - spread + rng.below(spread) : 10001 + rng.below(spread);
+            uint32_t qty = 100 * (1 + rng.below(10));
+            feed.push_back(MessageBuilder::build_add_order(next_id, price, qty, side, timestamp));
+            live.push_back(next_id++);
+            live_qty.push_back(qty);
+            continue;
+        }
+
+        size_t pick = rng.below(static_cast<uint32_t>(live.size()));
+        uint64_t id = live[pick];
+
+        if (roll < 70 && live_qty[pick] > 100)
+        {
+            feed.push_back(MessageBuilder::build_execute_order(id, 100));
+            live_qty[pick] -= 100;
+            continue;
+        }
+
+        if (roll < 90 || live_qty[pick] <= 100)
+        {
+            feed.push_back(MessageBuilder::build_cancel_order(id));
+        }
+        else
+        {
+            uint32_t price = 10000 - spread + rng.below(2 * spread);
+            feed.push_back(MessageBuilder::build_replace_order(id, next_id, price, live_qty[pick],
+                                                               timestamp));
+            live.push_back(next_id++);
+            live_qty.push_back(live_qty[pick]);
+        }
+
+        live[pick] = live.back();
+        live_qty[pick] = live_qty.back();
+        live.pop_back();
+        live_qty.pop_back();
+    }
+
+    return feed;
+}
+
+// Drive a feed through DataFabric + ITCHParser, one message per chunk
+static void run_parse_path(OrderBook& book, DataFabric& fabric,
+                           const std::vector<std::vector<uint8_t>>& feed)
+{
+    for (const auto& msg : feed)
+    {
+        fabric.write_chunk(msg);
+        book.process();
+    }
+}
+
+// Decode a feed once so engines that take ParseResults skip the parser
+static std::vector<ITCHParser::ParseResult> decode_feed(
+    const std::vector<std::vector<uint8_t>>& feed, uint16_t locate = 0)
+{
+    ITCHParser parser;
+    std::vector<ITCHParser::ParseResult> decoded;
+    decoded.reserve(feed.size());
+    for (const auto& msg : feed)
+    {
+        auto result = parser.parse_one(msg);
+        if (!result) continue;
+        result->locate = locate;
+        decoded.push_back(*result);
+    }
+    return decoded;
+}
+
+static void print_row(const std::string& label, double total_ns, size_t messages)
+{
+    std::cout << "  " << std::left << std::setw(34) << label << std::right << std::fixed
+              << std::setprecision(2) << std::setw(10) << total_ns / 1e6 << " ms"
+              << std::setw(10) << total_ns / messages << " ns/msg" << std::setw(10)
+              << messages / (total_ns / 1e9) / 1e6 << " M msg/s\n";
+}
+
+// ============================================================================
+// Decoded Event Cache
+// ============================================================================
+
+static void bench_event_cache()
+{
+    constexpr size_t MESSAGES = 1000000;
+    std::cout << "--- Decoded Event Cache (" << MESSAGES << " messages) ---\n";
+
+    auto feed = generate_feed(MESSAGES);
+
+    // First replay: parse path with the recorder attached
+    EventCache cache;
+    cache.reserve(MESSAGES);
+    double record_ns;
+    {
+        DataFabric fabric;
+        OrderBook book(fabric);
+        book.set_event_recorder(&cache);
+        auto start = Clock::now();
+        run_parse_path(book, fabric, feed);
+        record_ns = elapsed_ns(start, Clock::now());
+    }
+
+    // Repeat run through the parser (what every experiment pays today)
+    double parse_ns;
+    size_t parse_active;
+    {
+        DataFabric fabric;
+        OrderBook book(fabric);
+        auto start = Clock::now();
+        run_parse_path(book, fabric, feed);
+        parse_ns = elapsed_ns(start, Clock::now());
+        parse_active = book.get_active_order_count();
+    }
+
+    // Repeat run from the in-memory cache
+    double replay_ns;
+    size_t replay_active;
+    {
+        DataFabric fabric;
+        OrderBook book(fabric);
+        auto start = Clock::now();
+        book.replay(cache);
+        replay_ns = elapsed_ns(start, Clock::now());
+        replay_active = book.get_active_order_count();
+    }
+
+    // Repeat run from a memory-mapped cache file
+    const std::string path = "benchmark_event_cache.bin";
+    double mapped_ns = 0;
+    size_t mapped_active = 0;
+    bool mapped_ok = cache.save(path);
+    if (mapped_ok)
+    {
+        EventCache mapped;
+        mapped_ok = mapped.load(path);
+        DataFabric fabric;
+        OrderBook book(fabric);
+        auto start = Clock::now();
+        book.replay(mapped);
+        mapped_ns = elapsed_ns(start, Clock::now());
+        mapped_active = book.get_active_order_count();
+    }
+    std::remove(path.c_str());
+
+    print_row("parse path + recording", record_ns, MESSAGES);
+    print_row("parse path", parse_ns, MESSAGES);
+    print_row("cache replay (memory)", replay_ns, MESSAGES);
+    if (mapped_ok) print_row("cache replay (mmap file)", mapped_ns, MESSAGES);
+
+    std::cout << "  Speedup vs parse path: " << std::setprecision(2) << parse_ns / replay_ns
+              << "x (memory)";
+    if (mapped_ok) std::cout << ", " << parse_ns / mapped_ns << "x (mmap)";
+    std::cout << "\n";
+    std::cout << "  Memory cost: " << sizeof(CachedEvent) << " bytes/event = "
+              << std::setprecision(1) << sizeof(CachedEvent) * 1e6 / (1024.0 * 1024.0)
+              << " MiB per million messages\n";
+    std::cout << "  Final book state matches: "
+              << ((parse_active == replay_active && (!mapped_ok || parse_active == mapped_active))
+                      ? "Yes"
+                      : "No")
+              << " (" << parse_active << " active orders)\n\n";
+}
+
+// ============================================================================
+// Capture Reader Backends (cold cache)
+// ============================================================================
+
+static bool write_capture(const std::string& path, const std::vector<std::vector<uint8_t>>& feed)
+{
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    bool ok = true;
+    for (const auto& msg : feed)
+    {
+        ok = ok && std::fwrite(msg.data(), 1, msg.size(), file) == msg.size();
+    }
+    return (std::fclose(file) == 0) && ok;
+}
+
+// Evict the file from the page cache so the next replay starts cold
+static void drop_page_cache(const std::string& path)
+{
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    ::fdatasync(fd);
+#ifdef POSIX_FADV_DONTNEED
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+    ::close(fd);
+#else
+    (void)path;
+#endif
+}
+
+static void bench_capture_reader()
+{
+    constexpr size_t MESSAGES = 1000000;
+    std::cout << "--- Capture Reader Backends (" << MESSAGES << " messages, cold cache) ---\n";
+
+    const std::string path = "benchmark_capture.itch";
+    if (!write_capture(path, generate_feed(MESSAGES)))
+    {
+        std::cout << "  Could not write capture file\n\n";
+        return;
+    }
+
+    const CaptureReader::Backend backends[] = {CaptureReader::Backend::Mmap,
+                                               CaptureReader::Backend::PreadThread,
+                                               CaptureReader::Backend::IoUring};
+    size_t reference_active = 0;
+    bool all_match = true;
+
+    for (auto backend : backends)
+    {
+        drop_page_cache(path);
+
+        CaptureReader::Config config;
+        config.backend = backend;
+        CaptureReader reader;
+        if (!reader.open(path, config)) continue;
+
+        DataFabric fabric;
+        OrderBook book(fabric);
+        const uint8_t* data;
+        size_t length;
+
+        auto start = Clock::now();
+        while (reader.next_block(data, length))
+        {
+            book.process_bytes(data, length);
+        }
+        double total_ns = elapsed_ns(start, Clock::now());
+
+        const auto& stats = reader.get_stats();
+        std::string label = std::string(CaptureReader::backend_name(stats.backend)) +
+                            (stats.direct_io ? " (O_DIRECT)" : "");
+        print_row(label, total_ns, MESSAGES);
+        std::cout << "      " << stats.blocks << " blocks, " << stats.consumer_waits
+                  << " consumer waits (" << std::setprecision(2) << stats.wait_ns / 1e6
+                  << " ms stalled), " << std::setprecision(1)
+                  << stats.bytes / (total_ns / 1e9) / (1024.0 * 1024.0) << " MiB/s\n";
+
+        if (reference_active == 0) reference_active = book.get_active_order_count();
+        all_match = all_match && (book.get_active_order_count() == reference_active);
+    }
+    std::remove(path.c_str());
+
+    std::cout << "  Final book state matches across backends: " << (all_match ? "Yes" : "No")
+              << " (" << reference_active << " active orders)\n\n";
+}
+
+// ============================================================================
+// Cooperative Scheduler (1,000 feeds on one core)
+// ============================================================================
+
+static void bench_scheduler()
+{
+    constexpr size_t TASKS = 1000;
+    constexpr size_t MESSAGES_PER_TASK = 2000;
+    std::cout << "--- Cooperative Scheduler (" << TASKS << " feed tasks, 1 thread) ---\n";
+
+    // Every task replays the same synthetic session into its own book
+    auto feed = generate_feed(MESSAGES_PER_TASK);
+
+    struct Feed
+    {
+        DataFabric fabric;
+        OrderBook book{fabric};
+        size_t cursor = 0;
+    };
+    std::vector<std::unique_ptr<Feed>> feeds;
+    CooperativeScheduler scheduler;
+    for (size_t i = 0; i < TASKS; ++i)
+    {
+        feeds.push_back(std::make_unique<Feed>());
+        scheduler.add_feed("feed-" + std::to_string(i), feeds.back()->fabric, feeds.back()->book);
+    }
+
+    // Idle cost: every fabric empty
+    constexpr size_t IDLE_PASSES = 10000;
+    auto idle_start = Clock::now();
+    for (size_t i = 0; i < IDLE_PASSES; ++i) scheduler.run_once();
+    double idle_ns = elapsed_ns(idle_start, Clock::now());
+    scheduler.reset_stats();
+
+    // Skewed arrivals: the first 5% of feeds receive half of all messages
+    FastRng rng(7);
+    size_t delivered = 0;
+    size_t total = TASKS * MESSAGES_PER_TASK;
+    auto start = Clock::now();
+    while (delivered < total)
+    {
+        for (size_t burst = 0; burst < 256 && delivered < total; ++burst)
+        {
+            size_t id = rng.below(2) ? rng.below(TASKS / 20) : rng.below(TASKS);
+            Feed& f = *feeds[id];
+            if (f.cursor == MESSAGES_PER_TASK)
+            {
+                // This feed is finished - hand the message to the next unfinished one
+                auto it = std::find_if(feeds.begin(), feeds.end(), [](const auto& other) {
+                    return other->cursor < MESSAGES_PER_TASK;
+                });
+                if (it == feeds.end()) break;
+                id = static_cast<size_t>(it - feeds.begin());
+            }
+            Feed& target = *feeds[id];
+            if (target.fabric.write_chunk(feed[target.cursor]))
+            {
+                ++target.cursor;
+                ++delivered;
+            }
+        }
+        scheduler.run_once();
+    }
+    scheduler.run_until_idle();
+    double busy_ns = elapsed_ns(start, Clock::now());
+
+    std::vector<uint64_t> max_waits;
+    uint64_t total_wait = 0;
+    uint64_t slices = 0;
+    uint64_t max_run = 0;
+    for (size_t i = 0; i < TASKS; ++i)
+    {
+        const auto& stats = scheduler.get_task_stats(i);
+        max_waits.push_back(stats.max_wait_ns);
+        total_wait += stats.total_wait_ns;
+        slices += stats.slices;
+        max_run = std::max(max_run, stats.max_run_ns);
+    }
+    std::sort(max_waits.begin(), max_waits.end());
+
+    print_row("scheduled replay (skewed load)", busy_ns, total);
+    std::cout << std::setprecision(1) << "  Idle pass cost: " << idle_ns / IDLE_PASSES / TASKS
+              << " ns per empty task (" << idle_ns / IDLE_PASSES / 1000.0 << " us per pass)\n";
+    std::cout << "  Busy slices: " << slices << ", passes: " << scheduler.passes()
+              << ", longest slice: " << max_run / 1000.0 << " us\n";
+    std::cout << "  Scheduling latency: mean " << (slices ? total_wait / slices / 1000.0 : 0.0)
+              << " us, per-task max p50 " << max_waits[TASKS / 2] / 1000.0 << " us, p99 "
+              << max_waits[TASKS * 99 / 100] / 1000.0 << " us\n";
+    std::cout << std::setprecision(3) << "  Fairness (Jain, backlogged tasks): "
+              << scheduler.fairness_index() << "\n";
+
+    size_t matches = 0;
+    size_t reference = 0;
+    {
+        DataFabric fabric;
+        OrderBook book(fabric);
+        run_parse_path(book, fabric, feed);
+        reference = book.get_active_order_count();
+    }
+    for (const auto& f : feeds) matches += (f->book.get_active_order_count() == reference);
+    std::cout << "  Books matching single-feed reference: " << matches << "/" << TASKS << "\n\n";
+}
+
+// ============================================================================
+// Sharded Engine - hot symbol rebalancing
+// ============================================================================
+
+static void bench_sharded_rebalance()
+{
+    constexpr size_t WORKERS = 4;
+    constexpr size_t SYMBOLS = 64;
+    constexpr size_t MESSAGES_PER_SYMBOL = 20000;
+    constexpr uint16_t HOT = 5;
+    std::cout << "--- Sharded Engine Rebalancing (" << WORKERS << " workers, " << SYMBOLS
+              << " symbols) ---\n";
+
+    std::vector<std::vector<ITCHParser::ParseResult>> per_symbol;
+    for (size_t sym = 0; sym < SYMBOLS; ++sym)
+    {
+        size_t count = (sym == HOT) ? MESSAGES_PER_SYMBOL * 20 : MESSAGES_PER_SYMBOL;
+        per_symbol.push_back(
+            decode_feed(generate_feed(count, 1000 + sym), static_cast<uint16_t>(sym)));
+    }
+
+    // Interleave: uniform at first, then the hot symbol takes ~60% of the flow
+    std::vector<ITCHParser::ParseResult> stream;
+    std::vector<size_t> cursor(SYMBOLS, 0);
+    FastRng rng(99);
+    size_t remaining = 0;
+    for (const auto& f : per_symbol) remaining += f.size();
+    while (remaining > 0)
+    {
+        bool news = stream.size() > remaining / 4;
+        size_t sym = (news && rng.below(10) < 6) ? HOT : rng.below(SYMBOLS);
+        if (cursor[sym] == per_symbol[sym].size())
+        {
+            sym = 0;
+            while (cursor[sym] == per_symbol[sym].size()) ++sym;
+        }
+        stream.push_back(per_symbol[sym][cursor[sym]++]);
+        --remaining;
+    }
+
+    auto run = [&](bool rebalance, ShardedEngine::MigrationStats& stats,
+                   std::vector<uint64_t>& per_worker) {
+        ShardedEngine::Config config;
+        config.workers = WORKERS;
+        config.min_window_messages = 20000;
+        ShardedEngine engine(config);
+        engine.start();
+        auto start = Clock::now();
+        for (size_t i = 0; i < stream.size(); ++i)
+        {
+            engine.route(stream[i]);
+            if (rebalance && (i + 1) % 20000 == 0) engine.rebalance();
+        }
+        engine.flush();
+        double ns = elapsed_ns(start, Clock::now());
+
+        stats = engine.get_migration_stats();
+        per_worker.clear();
+        for (size_t w = 0; w < WORKERS; ++w) per_worker.push_back(engine.worker_messages(w));
+
+        // Every symbol book must match a single-threaded replay
+        bool ok = true;
+        for (size_t sym = 0; sym < SYMBOLS; ++sym)
+        {
+            DataFabric fabric;
+            OrderBook reference(fabric);
+            for (const auto& msg : per_symbol[sym]) reference.handle_message(msg);
+            const OrderBook* book = engine.find_book(static_cast<uint16_t>(sym));
+            ok = ok && book && book->get_order_count() == reference.get_order_count();
+        }
+        engine.stop();
+        return std::make_pair(ns, ok);
+    };
+
+    ShardedEngine::MigrationStats static_stats, dynamic_stats;
+    std::vector<uint64_t> static_load, dynamic_load;
+    auto [static_ns, static_ok] = run(false, static_stats, static_load);
+    auto [dynamic_ns, dynamic_ok] = run(true, dynamic_stats, dynamic_load);
+
+    print_row("static routing", static_ns, stream.size());
+    print_row("dynamic rebalancing", dynamic_ns, stream.size());
+
+    auto print_load = [](const char* label, const std::vector<uint64_t>& load) {
+        std::cout << "  " << label << " messages per worker:";
+        for (auto l : load) std::cout << " " << l;
+        std::cout << "\n";
+    };
+    print_load("Static ", static_load);
+    print_load("Dynamic", dynamic_load);
+
+    std::cout << std::setprecision(1) << "  Migrations: " << dynamic_stats.migrations
+              << ", pause mean "
+              << (dynamic_stats.migrations
+                      ? dynamic_stats.total_pause_ns / dynamic_stats.migrations / 1000.0
+                      : 0.0)
+              << " us, max " << dynamic_stats.max_pause_ns / 1000.0 << " us, "
+              << dynamic_stats.messages_stashed << " messages stashed in transit\n";
+    std::cout << "  Books match single-threaded replay: "
+              << (static_ok && dynamic_ok ? "Yes" : "No") << "\n\n";
+}
+
+// ============================================================================
+// Driver
+// ============================================================================
+
+// ============================================================================
+// Metrics Registry
+// ============================================================================
+
+#ifndef _WIN32
+// Minimal HTTP GET against the exporter; returns the response body size
+static size_t scrape_once(uint16_t port)
+{
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return 0;
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    size_t received = 0;
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0)
+    {
+        const char request[] = "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n";
+        ::send(fd, request, sizeof(request) - 1, 0);
+        char buf[4096];
+        ssize_t n;
+        while ((n = ::recv(fd, buf, sizeof(buf), 0)) > 0) received += static_cast<size_t>(n);
+    }
+    ::close(fd);
+    return received;
+}
+#endif
+
+static void bench_metrics()
+{
+    constexpr size_t INCREMENTS = 5000000;
+    std::cout << "--- Metrics Registry ---\n";
+
+    // Contended increments: one shared atomic vs per-thread slabs
+    for (size_t threads : {1, 2, 4})
+    {
+        std::atomic<uint64_t> shared{0};
+        auto start = Clock::now();
+        {
+            std::vector<std::thread> pool;
+            for (size_t t = 0; t < threads; ++t)
+            {
+                pool.emplace_back([&] {
+                    for (size_t i = 0; i < INCREMENTS; ++i) shared.fetch_add(1, std::memory_order_relaxed);
+                });
+            }
+            for (auto& th : pool) th.join();
+        }
+        double shared_ns = elapsed_ns(start, Clock::now());
+
+        MetricsRegistry registry;
+        auto counter = registry.counter("bench_increments_total", "Benchmark increments");
+        start = Clock::now();
+        {
+            std::vector<std::thread> pool;
+            for (size_t t = 0; t < threads; ++t)
+            {
+                pool.emplace_back([&] {
+                    for (size_t i = 0; i < INCREMENTS; ++i) counter.inc();
+                });
+            }
+            for (auto& th : pool) th.join();
+        }
+        double slab_ns = elapsed_ns(start, Clock::now());
+
+        std::string suffix = " (" + std::to_string(threads) + " thr)";
+        print_row("shared atomic fetch_add" + suffix, shared_ns, threads * INCREMENTS);
+        print_row("per-thread counter" + suffix, slab_ns, threads * INCREMENTS);
+        if (registry.read(counter) != threads * INCREMENTS || shared.load() != threads * INCREMENTS)
+        {
+            std::cout << "  [MISMATCH] aggregated count is wrong\n";
+        }
+    }
+
+    // Hot-path cost on the parse path: unbound vs bound book + fabric
+    auto feed = generate_feed(500000);
+    double unbound_ns = 0;
+    double bound_ns = 0;
+    MetricsRegistry registry;
+    for (int round = 0; round < 4; ++round)
+    {
+        DataFabric fabric;
+        OrderBook book(fabric);
+        if (round % 2 == 1)
+        {
+            fabric.bind_metrics(registry, "fabric=\"bench\"");
+            book.bind_metrics(registry, "book=\"bench\"");
+        }
+        auto start = Clock::now();
+        run_parse_path(book, fabric, feed);
+        (round % 2 == 0 ? unbound_ns : bound_ns) = elapsed_ns(start, Clock::now());  // Keep the warm pair
+    }
+    print_row("parse path, metrics unbound", unbound_ns, feed.size());
+    print_row("parse path, metrics bound", bound_ns, feed.size());
+
+    // Export cost
+    auto latency = registry.histogram("bench_latency_ns", "Synthetic latency samples");
+    FastRng rng(11);
+    for (size_t i = 0; i < 100000; ++i) latency.observe(100 + rng.below(10000));
+
+    constexpr size_t RENDERS = 1000;
+    size_t bytes = 0;
+    auto start = Clock::now();
+    for (size_t i = 0; i < RENDERS; ++i)
+    {
+        std::ostringstream os;
+        registry.write_prometheus(os);
+        bytes = os.str().size();
+    }
+    double render_ns = elapsed_ns(start, Clock::now());
+    std::cout << std::setprecision(1) << "  Prometheus render: " << render_ns / RENDERS / 1000.0
+              << " us per scrape (" << bytes << " bytes, " << registry.thread_slab_count()
+              << " thread slabs)\n";
+
+#ifndef _WIN32
+    MetricsExporter exporter(registry);
+    if (exporter.start_http(0))
+    {
+        constexpr size_t SCRAPES = 200;
+        size_t received = 0;
+        start = Clock::now();
+        for (size_t i = 0; i < SCRAPES; ++i) received = scrape_once(exporter.http_port());
+        double scrape_ns = elapsed_ns(start, Clock::now());
+        exporter.stop();
+        std::cout << "  HTTP scrape (loopback): " << scrape_ns / SCRAPES / 1000.0 << " us per request ("
+                  << received << " bytes, " << exporter.scrapes() << " served)\n";
+    }
+#endif
+    std::cout << "\n";
+}
+
+// ============================================================================
+// DataFabric Telemetry - dwell time and occupancy
+// ============================================================================
+
+static void bench_fabric_telemetry()
+{
+    std::cout << "--- DataFabric Telemetry ---\n";
+    auto feed = generate_feed(500000);
+
+    // Overhead: off, default sampling, every chunk stamped; best of 3 rounds each
+    double best_ns[3] = {1e30, 1e30, 1e30};
+    for (int round = 0; round < 9; ++round)
+    {
+        int mode = round % 3;
+        DataFabric fabric;
+        fabric.set_telemetry(mode != 0, mode == 2 ? 1 : DataFabric::DEFAULT_TELEMETRY_SAMPLE);
+        OrderBook book(fabric);
+        auto start = Clock::now();
+        run_parse_path(book, fabric, feed);
+        best_ns[mode] = std::min(best_ns[mode], elapsed_ns(start, Clock::now()));
+    }
+    print_row("parse path, telemetry off", best_ns[0], feed.size());
+    print_row("parse path, on (1 in 16, default)", best_ns[1], feed.size());
+    print_row("parse path, on (every chunk)", best_ns[2], feed.size());
+
+    // Bursty producer, budgeted consumer: bursts of 1-32 messages, 16 chunks per slice
+    DataFabric fabric;
+    OrderBook book(fabric);
+    FastRng rng(5);
+    size_t cursor = 0;
+    while (cursor < feed.size())
+    {
+        size_t burst = 1 + rng.below(32);
+        for (size_t i = 0; i < burst && cursor < feed.size(); ++i)
+        {
+            if (!fabric.write_chunk(feed[cursor])) break;
+            ++cursor;
+        }
+        book.process_some(16);
+    }
+    while (book.process_some(16)) {}
+
+    const auto& stats = fabric.get_stats();
+    std::cout << "  Dwell (bursty, budget 16): mean "
+              << std::setprecision(0) << static_cast<double>(stats.dwell_total_ns) / stats.dwell_count
+              << " ns, p50 <= " << stats.dwell_percentile_ns(0.50) << " ns, p99 <= "
+              << stats.dwell_percentile_ns(0.99) << " ns, max " << stats.dwell_max_ns << " ns\n";
+
+    uint64_t total_ns = 0;
+    for (uint64_t ns : stats.occupancy_ns) total_ns += ns;
+    static const char* const QUARTERS[] = {"<=25%", "<=50%", "<=75%", "<=100%"};
+    std::cout << std::setprecision(1) << "  Occupancy (time share): empty "
+              << 100.0 * static_cast<double>(stats.occupancy_ns[0]) / static_cast<double>(total_ns)
+              << "%";
+    for (size_t q = 0; q < 4; ++q)
+    {
+        uint64_t ns = 0;
+        for (size_t k = 1 + 4 * q; k <= 4 + 4 * q; ++k) ns += stats.occupancy_ns[k];
+        std::cout << ", " << QUARTERS[q] << " "
+                  << 100.0 * static_cast<double>(ns) / static_cast<double>(total_ns) << "%";
+    }
+    std::cout << "\n  Backpressure events: " << stats.backpressure_events << "\n\n";
+}
+
+// ============================================================================
+// Adaptive Consumer - watermark-driven batching
+// ============================================================================
+
+static void bench_adaptive_consumer()
+{
+    constexpr size_t MESSAGES = 200000;
+    std::cout << "--- Adaptive Consumer (bursts of 1-96 msgs, analytics callback) ---\n";
+    auto feed = generate_feed(MESSAGES);
+
+    struct Mode
+    {
+        const char* label;
+        OrderBook::AdaptiveConfig config;
+    };
+    const Mode modes[] = {
+        {"small batches, inline callbacks", {1, 1, false, 1 << 16}},
+        {"large batches, inline callbacks", {1, 64, false, 1 << 16}},
+        {"adaptive (large + deferred)", {1, 64, true, 1 << 16}},
+    };
+
+    for (const auto& mode : modes)
+    {
+        DataFabric fabric;
+        fabric.set_watermarks(2048, 512);
+        OrderBook book(fabric);
+        volatile uint64_t sink = 0;
+        book.set_event_callback([&sink](char, const Order& order) {
+            // Stand-in for downstream analytics
+            uint64_t h = order.order_id;
+            for (int i = 0; i < 100; ++i) h = h * 6364136223846793005ULL + 1442695040888963407ULL;
+            sink = sink + h;
+        });
+        book.enable_adaptive(mode.config);
+
+        FastRng rng(9);
+        size_t cursor = 0;
+        auto start = Clock::now();
+        while (cursor < feed.size())
+        {
+            size_t burst = 1 + rng.below(96);
+            for (size_t i = 0; i < burst && cursor < feed.size(); ++i)
+            {
+                if (!fabric.write_chunk(feed[cursor])) break;
+                ++cursor;
+            }
+            book.process();  // One batch, then back to the producer
+        }
+        while (!fabric.empty()) book.process();
+        double total_ns = elapsed_ns(start, Clock::now());
+
+        const auto& fifo = fabric.get_stats();
+        const auto& adaptive = book.get_adaptive_stats();
+        print_row(mode.label, total_ns, MESSAGES);
+        std::cout << std::setprecision(0) << "    dwell mean "
+                  << static_cast<double>(fifo.dwell_total_ns) / fifo.dwell_count << " ns, p99 <= "
+                  << fifo.dwell_percentile_ns(0.99) << " ns | pressure episodes "
+                  << adaptive.pressure_episodes << ", deferred " << adaptive.callbacks_deferred
+                  << " (max backlog " << adaptive.max_deferred_backlog << "), watermark edges "
+                  << fifo.almost_full_events << "/" << fifo.almost_empty_events << ", batches "
+                  << adaptive.low_latency_batches << " calm / " << adaptive.pressure_batches
+                  << " pressure, backpressure " << fifo.backpressure_events << "\n";
+    }
+    std::cout << "\n";
+}
+
+// ============================================================================
+// MPSC Fabric - several feed handlers, one book thread
+// ============================================================================
+
+// Shift every order reference in a feed so producers never share order ids
+static void offset_order_ids(std::vector<std::vector<uint8_t>>& feed, uint64_t base)
+{
+    auto patch = [base](std::vector<uint8_t>& msg, size_t offset) {
+        uint64_t id = 0;
+        for (int i = 0; i < 8; ++i) id |= static_cast<uint64_t>(msg[offset + i]) << (8 * i);
+        id += base;
+        for (int i = 0; i < 8; ++i) msg[offset + i] = static_cast<uint8_t>(id >> (8 * i));
+    };
+    for (auto& msg : feed)
+    {
+        patch(msg, 11);                     // Order reference (A/X/E) or original (U)
+        if (msg[0] == 'U') patch(msg, 19);  // New order reference
+    }
+}
+
+static void bench_mpsc_fabric()
+{
+    constexpr size_t MESSAGES_PER_PRODUCER = 200000;
+    std::cout << "--- MPSC Fabric (" << MESSAGES_PER_PRODUCER
+              << " msgs per producer, 1 consumer) ---\n";
+
+    size_t reference_active = 0;
+    {
+        DataFabric fabric;
+        OrderBook book(fabric);
+        run_parse_path(book, fabric, generate_feed(MESSAGES_PER_PRODUCER, 1));
+        reference_active = book.get_active_order_count();
+    }
+
+    for (size_t producers : {2, 4, 8})
+    {
+        std::vector<std::vector<std::vector<uint8_t>>> feeds;
+        for (size_t p = 0; p < producers; ++p)
+        {
+            feeds.push_back(generate_feed(MESSAGES_PER_PRODUCER, 1));
+            offset_order_ids(feeds.back(), static_cast<uint64_t>(p) << 40);
+        }
+
+        MpscFabric::Config config;
+        config.producers = producers;
+        MpscFabric fabric(config);
+        DataFabric unused(0);
+        OrderBook book(unused);
+
+        std::atomic<size_t> finished{0};
+        auto start = Clock::now();
+        std::vector<std::thread> threads;
+        for (size_t p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&, p] {
+                for (const auto& msg : feeds[p])
+                {
+                    while (!fabric.write_chunk(p, msg)) std::this_thread::yield();
+                }
+                finished.fetch_add(1, std::memory_order_release);
+            });
+        }
+
+        DataFabric::Chunk chunk;
+        size_t consumed = 0;
+        while (true)
+        {
+            if (fabric.read_chunk(chunk))
+            {
+                book.process_bytes(chunk.data(), chunk.size());
+                ++consumed;
+                continue;
+            }
+            if (finished.load(std::memory_order_acquire) == producers && fabric.empty()) break;
+            std::this_thread::yield();
+        }
+        double total_ns = elapsed_ns(start, Clock::now());
+        for (auto& t : threads) t.join();
+
+        print_row(std::to_string(producers) + " producers", total_ns, consumed);
+        std::cout << "    backpressure events per lane:";
+        for (size_t p = 0; p < producers; ++p)
+        {
+            std::cout << " " << fabric.get_lane_stats(p).backpressure_events;
+        }
+        bool match = book.get_active_order_count() == reference_active * producers;
+        std::cout << " | active orders " << book.get_active_order_count()
+                  << (match ? " (matches)" : " (MISMATCH)") << "\n";
+    }
+    std::cout << "\n";
+}
+
+// ============================================================================
+// Concurrent Order Reads - seqlock order view
+// ============================================================================
+
+static void bench_concurrent_reads()
+{
+    constexpr size_t MESSAGES = 1000000;
+    std::cout << "--- Concurrent Order Reads (" << MESSAGES << " msgs, decoded replay) ---\n";
+    auto decoded = decode_feed(generate_feed(MESSAGES));
+    uint64_t max_id = 0;
+    for (const auto& msg : decoded) max_id = std::max({max_id, msg.order_id, msg.new_order_id});
+
+    // Writer overhead, warm pair of runs
+    double off_ns = 0;
+    double on_ns = 0;
+    for (int round = 0; round < 4; ++round)
+    {
+        DataFabric fabric(0);
+        OrderBook book(fabric);
+        if (round % 2 == 1) book.enable_concurrent_reads(1 << 20);
+        auto start = Clock::now();
+        for (const auto& msg : decoded) book.handle_message(msg);
+        (round % 2 == 0 ? off_ns : on_ns) = elapsed_ns(start, Clock::now());
+    }
+    print_row("writer, view off", off_ns, MESSAGES);
+    print_row("writer, view on", on_ns, MESSAGES);
+
+    for (size_t readers : {1, 2})
+    {
+        DataFabric fabric(0);
+        OrderBook book(fabric);
+        book.enable_concurrent_reads(1 << 20);
+        const ConcurrentOrderView& view = *book.concurrent_view();
+
+        std::atomic<bool> done{false};
+        std::vector<size_t> reads(readers, 0), hits(readers, 0), retries(readers, 0),
+            violations(readers, 0);
+        std::vector<std::thread> threads;
+        for (size_t r = 0; r < readers; ++r)
+        {
+            threads.emplace_back([&, r] {
+                FastRng rng(100 + r);
+                ConcurrentOrderView::OrderSnapshot snap;
+                while (!done.load(std::memory_order_acquire))
+                {
+                    uint64_t id = 1 + rng.next() % max_id;
+                    ++reads[r];
+                    if (!view.find(id, snap, retries[r])) continue;
+                    ++hits[r];
+                    // A torn read would break these
+                    bool ok = snap.order_id == id && snap.quantity > 0 &&
+                              (snap.side == 'B' || snap.side == 'S') && snap.level_orders >= 1 &&
+                              snap.level_quantity >= snap.quantity;
+                    violations[r] += !ok;
+                }
+            });
+        }
+
+        auto start = Clock::now();
+        for (const auto& msg : decoded) book.handle_message(msg);
+        double writer_ns = elapsed_ns(start, Clock::now());
+        done.store(true, std::memory_order_release);
+        for (auto& t : threads) t.join();
+
+        size_t total_reads = 0, total_hits = 0, total_retries = 0, total_violations = 0;
+        for (size_t r = 0; r < readers; ++r)
+        {
+            total_reads += reads[r];
+            total_hits += hits[r];
+            total_retries += retries[r];
+            total_violations += violations[r];
+        }
+        print_row("writer + " + std::to_string(readers) + " reader thread(s)", writer_ns, MESSAGES);
+        std::cout << std::setprecision(2) << "    reads " << total_reads << " ("
+                  << total_reads / (writer_ns / 1e9) / 1e6 << " M/s), hits " << total_hits
+                  << ", retries/read " << static_cast<double>(total_retries) / total_reads
+                  << ", inconsistent snapshots " << total_violations << "\n";
+
+        // Quiescent cross-check against the book
+        size_t mismatches = 0;
+        ConcurrentOrderView::OrderSnapshot snap;
+        for (uint64_t id = 1; id <= max_id; ++id)
+        {
+            const Order* order = book.find_order(id);
+            bool found = view.find(id, snap);
+            if (found != (order != nullptr) ||
+                (order && (snap.price != order->price || snap.quantity != order->quantity)))
+            {
+                ++mismatches;
+            }
+        }
+        std::cout << "    view vs book after replay: " << mismatches << " mismatches\n";
+    }
+    std::cout << "\n";
+}
+
+// ============================================================================
+// Tick Grid - price normalization
+// ============================================================================
+
+static void bench_tick_grid()
+{
+    constexpr size_t CONVERSIONS = 10000000;
+    std::cout << "--- Tick Grid (Reg NMS: $0.0001 < $1 <= $0.01) ---\n";
+    const TickGrid& grid = TickGrids::REG_NMS;
+
+    // Exactness against plain division: every price below 2^24 plus random 32-bit prices
+    size_t errors = 0;
+    FastRng rng(3);
+    auto check = [&](uint32_t price) {
+        uint32_t tick = 0;
+        bool on_grid = grid.to_tick(price, tick);
+        bool expect_on = price < 10000 || (price - 10000) % 100 == 0;
+        uint32_t expect_tick = price < 10000 ? price : 10000 + (price - 10000) / 100;
+        errors += (on_grid != expect_on) || (on_grid && (tick != expect_tick || grid.to_price(tick) != price));
+    };
+    for (uint32_t price = 0; price < (1u << 24); ++price) check(price);
+    for (size_t i = 0; i < CONVERSIONS; ++i) check(static_cast<uint32_t>(rng.next()));
+    std::cout << "  Exactness vs. division: " << errors << " errors over " << (1u << 24) + CONVERSIONS
+              << " prices\n";
+
+    // Conversion cost: multiply-shift vs. runtime division
+    std::vector<uint32_t> prices(CONVERSIONS);
+    for (auto& p : prices) p = 10000 + 100 * rng.below(100000);
+    volatile uint32_t divisor = 100;
+    uint64_t sum = 0;
+    auto start = Clock::now();
+    for (uint32_t p : prices)
+    {
+        uint32_t tick = 0;
+        grid.to_tick(p, tick);
+        sum += tick;
+    }
+    double grid_ns = elapsed_ns(start, Clock::now());
+    uint32_t d = divisor;
+    start = Clock::now();
+    for (uint32_t p : prices)
+    {
+        uint32_t offset = p - 10000;
+        uint32_t q = offset / d;
+        sum += (q * d == offset) ? 10000 + q : 0;
+    }
+    double div_ns = elapsed_ns(start, Clock::now());
+    print_row("to_tick (multiply-shift + check)", grid_ns, CONVERSIONS);
+    print_row("runtime divide + check", div_ns, CONVERSIONS);
+
+    // Book on tick keys vs. raw prices (feed re-priced onto the penny grid above $1)
+    auto decoded = decode_feed(generate_feed(1000000));
+    for (auto& msg : decoded)
+    {
+        if (msg.price) msg.price = 10000 + (msg.price - 9900) * 100;
+    }
+    double raw_ns = 0;
+    double tick_ns = 0;
+    OrderBook::MarketDepth depth[2];
+    for (int round = 0; round < 4; ++round)
+    {
+        DataFabric fabric(0);
+        OrderBook book(fabric);
+        if (round % 2 == 1) book.set_tick_grid(&grid);
+        auto begin = Clock::now();
+        for (const auto& msg : decoded) book.handle_message(msg);
+        (round % 2 == 0 ? raw_ns : tick_ns) = elapsed_ns(begin, Clock::now());
+        depth[round % 2] = book.get_depth(10);
+    }
+    print_row("book replay, raw price keys", raw_ns, decoded.size());
+    print_row("book replay, tick keys", tick_ns, decoded.size());
+    bool same = depth[0].bids == depth[1].bids && depth[0].asks == depth[1].asks;
+    std::cout << "  Top-10 depth identical at the API: " << (same ? "yes" : "NO")
+              << ", sizeof(OrderInfo) " << sizeof(OrderInfo) << " bytes (checksum " << sum % 10
+              << ")\n\n";
+}
+
+// ============================================================================
+// MPID Attribution - per-firm liquidity at the touch
+// ============================================================================
+
+static void bench_mpid_attribution()
+{
+    constexpr size_t MESSAGES = 1000000;
+    static const char* const FIRMS[] = {"GSCO", "MSCO", "CDEL", "VIRT", "JPMS", "UBSS",
+                                        "NITE", "SUSQ", "TMBR", "CITD", "HRTF", "JSTR"};
+    std::cout << "--- MPID Attribution (40% of adds as 'F', 12 firms) ---\n";
+
+    // Re-encode a share of the adds as 'F', biased towards the first few firms
+    auto plain = generate_feed(MESSAGES);
+    auto attributed = plain;
+    FastRng rng(21);
+    for (auto& msg : attributed)
+    {
+        if (msg[0] != 'A' || rng.below(100) >= 40) continue;
+        const char* firm = FIRMS[std::min(rng.below(12), rng.below(12))];
+        msg[0] = 'F';
+        for (int i = 0; i < 4; ++i) msg.push_back(static_cast<uint8_t>(firm[i]));
+    }
+    auto plain_decoded = decode_feed(plain);
+    auto attributed_decoded = decode_feed(attributed);
+
+    double plain_ns = 0;
+    double attributed_ns = 0;
+    for (int round = 0; round < 4; ++round)
+    {
+        DataFabric fabric(0);
+        OrderBook book(fabric);
+        const auto& feed = (round % 2 == 0) ? plain_decoded : attributed_decoded;
+        auto start = Clock::now();
+        for (const auto& msg : feed) book.handle_message(msg);
+        (round % 2 == 0 ? plain_ns : attributed_ns) = elapsed_ns(start, Clock::now());
+    }
+    print_row("replay, all 'A'", plain_ns, MESSAGES);
+    print_row("replay, 40% 'F' attributed", attributed_ns, MESSAGES);
+
+    // Touch queries, and a brute-force cross-check from the decoded stream
+    DataFabric fabric(0);
+    OrderBook book(fabric);
+    for (const auto& msg : attributed_decoded) book.handle_message(msg);
+
+    constexpr size_t QUERIES = 1000000;
+    MpidAttribution::MpidShare top[5];
+    size_t written = 0;
+    auto start = Clock::now();
+    for (size_t i = 0; i < QUERIES; ++i)
+    {
+        written += book.get_top_mpids((i & 1) ? Side::Ask : Side::Bid, 5, top);
+    }
+    double query_ns = elapsed_ns(start, Clock::now());
+    print_row("top-5 MPIDs at touch", query_ns, QUERIES);
+
+    struct Live
+    {
+        uint32_t mpid;
+        char side;
+        uint32_t price;
+        uint32_t qty;
+    };
+    std::unordered_map<uint64_t, Live> live;
+    for (const auto& msg : attributed_decoded)
+    {
+        auto it = live.find(msg.order_id);
+        switch (msg.type)
+        {
+            case 'A':
+            case 'F':
+                live[msg.order_id] = Live{msg.mpid, msg.side, msg.price, msg.quantity};
+                break;
+            case 'X':
+                if (it != live.end()) live.erase(it);
+                break;
+            case 'E':
+                if (it != live.end() && (it->second.qty -= msg.quantity) == 0) live.erase(it);
+                break;
+            case 'U':
+                if (it != live.end())
+                {
+                    Live moved{it->second.mpid, it->second.side, msg.price, msg.quantity};
+                    live.erase(it);
+                    live[msg.new_order_id] = moved;
+                }
+                break;
+        }
+    }
+
+    size_t mismatches = 0;
+    for (Side side : {Side::Bid, Side::Ask})
+    {
+        uint64_t touch = 0;
+        MpidAttribution::MpidShare all[64];
+        size_t n = book.get_top_mpids(side, 64, all, &touch);
+        std::unordered_map<uint32_t, uint64_t> expected;
+        for (const auto& [id, order] : live)
+        {
+            bool on_side = (order.side == 'B') == (side == Side::Bid);
+            if (order.mpid && on_side && order.price == touch) expected[order.mpid] += order.qty;
+        }
+        mismatches += (n != expected.size());
+        for (size_t i = 0; i < n; ++i)
+        {
+            mismatches += expected[book.get_attribution().code(all[i].mpid)] != all[i].quantity;
+            mismatches += (i > 0 && all[i].quantity > all[i - 1].quantity);
+        }
+        std::cout << "  " << (side == Side::Bid ? "Bid" : "Ask") << " touch " << touch << ": ";
+        for (size_t i = 0; i < std::min<size_t>(n, 3); ++i)
+        {
+            std::cout << book.get_attribution().name(all[i].mpid) << " " << all[i].quantity << "  ";
+        }
+        std::cout << "(set by "
+                  << (book.get_touch_setter(side) ? book.get_attribution().name(book.get_touch_setter(side))
+                                                   : std::string("anonymous"))
+                  << ")\n";
+    }
+    std::cout << "  Cross-check vs. brute force: " << mismatches << " mismatches (" << written
+              << " shares returned)\n\n";
+}
+
+// ============================================================================
+// Subscription Filter
+// ============================================================================
+
+static void bench_subscription_filter()
+{
+    constexpr size_t MESSAGES = 2000000;
+    constexpr uint32_t SYMBOLS = 1000;
+    std::cout << "--- Subscription Filter (" << SYMBOLS
+              << " symbols, locate on adds only) ---\n";
+
+    // Spread adds over the universe; follow-ons carry no locate, as after a
+    // normalizer, so only the dropped-id bitmap can reject them
+    auto decoded = decode_feed(generate_feed(MESSAGES));
+    std::unordered_map<uint64_t, uint16_t> symbol_of;
+    for (auto& msg : decoded)
+    {
+        if (msg.type == 'A')
+        {
+            msg.locate = static_cast<uint16_t>(1 + (msg.order_id * 0x9E3779B97F4A7C15ULL >> 32) % SYMBOLS);
+            symbol_of[msg.order_id] = msg.locate;
+        }
+        else if (msg.type == 'U')
+        {
+            symbol_of[msg.new_order_id] = symbol_of[msg.order_id];
+        }
+    }
+
+    for (uint32_t percent : {1u, 10u, 50u})
+    {
+        uint32_t subscribed = SYMBOLS * percent / 100;
+
+        double all_ns = 0;
+        double filtered_ns = 0;
+        size_t active = 0;
+        SubscriptionFilter::FilterStats stats;
+        size_t bitmap_bytes = 0;
+        for (int round = 0; round < 4; ++round)
+        {
+            bool filtered = (round % 2 == 1);
+            SubscriptionFilter filter;
+            for (uint32_t locate = 1; locate <= subscribed; ++locate)
+            {
+                filter.subscribe(static_cast<uint16_t>(locate));
+            }
+
+            DataFabric fabric(0);
+            OrderBook book(fabric);
+            if (filtered) book.set_subscription_filter(&filter);
+            auto start = Clock::now();
+            for (const auto& msg : decoded) book.handle_message(msg);
+            (filtered ? filtered_ns : all_ns) = elapsed_ns(start, Clock::now());
+
+            if (filtered)
+            {
+                active = book.get_active_order_count();
+                stats = filter.get_stats();
+                bitmap_bytes = filter.memory_bytes();
+            }
+        }
+
+        // Reference: replay only the subscribed symbols' messages
+        DataFabric fabric(0);
+        OrderBook reference(fabric);
+        for (const auto& msg : decoded)
+        {
+            if (symbol_of[msg.order_id] <= subscribed) reference.handle_message(msg);
+        }
+
+        std::cout << "  " << percent << "% subscribed (" << subscribed << " symbols):\n";
+        print_row("  replay, no filter", all_ns, MESSAGES);
+        print_row("  replay, filtered", filtered_ns, MESSAGES);
+        std::cout << "    Speedup " << std::setprecision(2) << all_ns / filtered_ns << "x, "
+                  << stats.dropped_adds << " adds + " << stats.dropped_followups
+                  << " follow-ons dropped, bitmap " << bitmap_bytes / 1024 << " KB\n"
+                  << "    Active orders " << active << " (reference "
+                  << reference.get_active_order_count() << ")\n";
+    }
+    std::cout << "\n";
+}
+
+// ============================================================================
+// Batched Event Delivery
+// ============================================================================
+
+// Hand-off queue to a writer thread (file/network/queue consumers look like
+// this): every delivery takes the lock once, however many records it carries
+class EventSink
+{
+   public:
+    void put(const BookEvent* events, size_t count)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pending_.size() + count > 1 << 16) pending_.clear();  // Writer drained it
+        pending_.insert(pending_.end(), events, events + count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            digest_ += events[i].order_id * 31 + events[i].quantity + static_cast<uint8_t>(events[i].type);
+        }
+        records_ += count;
+        deliveries_++;
+    }
+
+    uint64_t digest() const { return digest_; }
+    size_t records() const { return records_; }
+    size_t deliveries() const { return deliveries_; }
+
+   private:
+    std::mutex mutex_;
+    std::vector<BookEvent> pending_;
+    uint64_t digest_ = 0;
+    size_t records_ = 0;
+    size_t deliveries_ = 0;
+};
+
+static void bench_batch_listener()
+{
+    constexpr size_t MESSAGES = 500000;
+    constexpr size_t BLOCK = 64 * 1024;
+    std::cout << "--- Batched Event Delivery (" << MESSAGES << " messages, " << BLOCK / 1024
+              << " KB blocks, locked hand-off sink) ---\n";
+
+    std::vector<uint8_t> bytes;
+    for (const auto& msg : generate_feed(MESSAGES)) bytes.insert(bytes.end(), msg.begin(), msg.end());
+
+    enum Mode { None, PerEvent, Batch };
+    const char* labels[] = {"process_bytes, no listener", "per-event std::function",
+                            "batch listener (span)"};
+    double best_ns[3] = {1e30, 1e30, 1e30};
+    uint64_t digest[3] = {};
+    size_t records[3] = {};
+    size_t deliveries[3] = {};
+
+    for (int round = 0; round < 15; ++round)
+    {
+        Mode mode = static_cast<Mode>(round % 3);
+        EventSink sink;
+
+        DataFabric fabric(0);
+        OrderBook book(fabric);
+        if (mode == PerEvent)
+        {
+            book.set_event_callback([&](char type, const Order& o) {
+                BookEvent e{o.order_id, o.timestamp, o.price, o.quantity, type, o.side, o.mpid};
+                sink.put(&e, 1);
+            });
+        }
+        else if (mode == Batch)
+        {
+            book.set_batch_listener([&](const BookEvent* batch, size_t count) { sink.put(batch, count); });
+        }
+
+        auto start = Clock::now();
+        for (size_t offset = 0; offset < bytes.size(); offset += BLOCK)
+        {
+            book.process_bytes(bytes.data() + offset, std::min(BLOCK, bytes.size() - offset));
+        }
+        best_ns[mode] = std::min(best_ns[mode], elapsed_ns(start, Clock::now()));
+        digest[mode] = sink.digest();
+        records[mode] = sink.records();
+        deliveries[mode] = sink.deliveries();
+    }
+
+    for (int mode = 0; mode < 3; ++mode)
+    {
+        print_row(labels[mode], best_ns[mode], MESSAGES);
+        if (mode != None)
+        {
+            std::cout << "      " << records[mode] << " events in " << deliveries[mode]
+                      << " deliveries, listener cost " << std::setprecision(2)
+                      << (best_ns[mode] - best_ns[None]) / MESSAGES << " ns/msg\n";
+        }
+    }
+    std::cout << "  Same events delivered: " << (digest[PerEvent] == digest[Batch] ? "Yes" : "No")
+              << "\n";
+
+    // Delivery alone, without the book's hash-map work drowning it out:
+    // the same record stream through each interface, as emit() produces it
+    constexpr size_t DELIVERIES = 10000000;
+    constexpr size_t SPAN = 256;  // set_batch_listener() default
+    std::vector<Order> orders;
+    FastRng rng(5);
+    for (size_t i = 0; i < 4096; ++i)
+    {
+        orders.emplace_back(i + 1, 9950 + rng.below(100), 100 * (1 + rng.below(10)),
+                            rng.below(2) ? 'B' : 'S', 34200000000000ULL + i);
+    }
+
+    EventSink per_event_sink;
+    OrderBook::EventCallback per_event = [&](char type, const Order& o) {
+        BookEvent e{o.order_id, o.timestamp, o.price, o.quantity, type, o.side, o.mpid};
+        per_event_sink.put(&e, 1);
+    };
+    auto start = Clock::now();
+    for (size_t i = 0; i < DELIVERIES; ++i) per_event('A', orders[i & 4095]);
+    double per_event_ns = elapsed_ns(start, Clock::now());
+
+    EventSink batch_sink;
+    OrderBook::BatchCallback per_batch = [&](const BookEvent* batch, size_t count) {
+        batch_sink.put(batch, count);
+    };
+    BookEvent batch[SPAN];
+    size_t queued = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < DELIVERIES; ++i)
+    {
+        const Order& o = orders[i & 4095];
+        BookEvent& e = batch[queued++];
+        e.order_id = o.order_id;
+        e.timestamp = o.timestamp;
+        e.price = o.price;
+        e.quantity = o.quantity;
+        e.type = 'A';
+        e.side = o.side;
+        e.mpid = o.mpid;
+        if (queued == SPAN)
+        {
+            per_batch(batch, queued);
+            queued = 0;
+        }
+    }
+    if (queued) per_batch(batch, queued);
+    double batch_ns = elapsed_ns(start, Clock::now());
+
+    print_row("delivery only, per-event", per_event_ns, DELIVERIES);
+    print_row("delivery only, 256-event spans", batch_ns, DELIVERIES);
+    std::cout << "  Digests match: " << (per_event_sink.digest() == batch_sink.digest() ? "Yes" : "No")
+              << "\n\n";
+}
+
+// ============================================================================
+// Thin / Thick Level Layouts
+// ============================================================================
+
+static void bench_book_layout()
+{
+    constexpr size_t MESSAGES = 1000000;
+    std::cout << "--- Thin / Thick Level Layouts (" << MESSAGES << " messages per book) ---\n";
+
+    LayoutConfig thin_only;
+    thin_only.promote_levels = SIZE_MAX;
+    thin_only.demote_levels = SIZE_MAX;
+    LayoutConfig thick_only;
+    thick_only.promote_levels = 0;
+    thick_only.demote_levels = 0;
+    const LayoutConfig adaptive;
+
+    // The last mode keys the book by a 1-unit tick grid, so thick sides are ladders
+    static constexpr TickBand UNIT_BANDS[] = {{0, 1}};
+    static constexpr TickGrid unit_grid{UNIT_BANDS};
+    constexpr int MODES = 4;
+    const std::pair<const char*, const LayoutConfig*> modes[MODES] = {{"thin only", &thin_only},
+                                                                      {"thick only", &thick_only},
+                                                                      {"adaptive", &adaptive},
+                                                                      {"adaptive, tick grid", &adaptive}};
+
+    // Illiquid name, mid-size name, ETF-style deep book
+    for (uint32_t spread : {3u, 12u, 2000u})
+    {
+        auto decoded = decode_feed(generate_feed(MESSAGES, 42, spread));
+        std::cout << "  Adds within " << spread << " price units of the touch:\n";
+
+        uint64_t max_id = 0;
+        for (const auto& msg : decoded) max_id = std::max({max_id, msg.order_id, msg.new_order_id});
+
+        double best_ns[MODES] = {1e30, 1e30, 1e30, 1e30};
+        double engine_ns[MODES] = {1e30, 1e30, 1e30, 1e30};
+        OrderBook::MarketDepth depth[MODES];
+        LayoutStats stats[MODES];
+        size_t levels = 0;
+        for (int round = 0; round < 2 * MODES; ++round)
+        {
+            int mode = round % MODES;
+            bool grid = (mode == MODES - 1);
+            DataFabric fabric(0);
+            OrderBook book(fabric);
+            book.set_layout_config(*modes[mode].second);
+            if (grid) book.set_tick_grid(&unit_grid);
+
+            auto start = Clock::now();
+            for (const auto& msg : decoded) book.handle_message(msg);
+            best_ns[mode] = std::min(best_ns[mode], elapsed_ns(start, Clock::now()));
+
+            // Level structure alone: OrderBookEngine behind a flat id-indexed table
+            OrderBookEngine engine;
+            engine.setLayoutConfig(*modes[mode].second);
+            engine.setDenseKeys(grid);
+            std::vector<OrderInfo> info(max_id + 1);
+            start = Clock::now();
+            for (const auto& msg : decoded)
+            {
+                OrderInfo& order = info[msg.order_id];
+                switch (msg.type)
+                {
+                    case 'A':
+                        engine.onAdd(msg.order_id, msg.side == 'B' ? Side::Bid : Side::Ask, msg.price,
+                                     msg.quantity, order);
+                        break;
+                    case 'X':
+                        engine.onCancel(msg.order_id, order);
+                        break;
+                    case 'E':
+                        engine.onExecute(msg.order_id, order, msg.quantity);
+                        break;
+                    case 'U':
+                        if (!order.node) break;
+                        engine.onCancel(msg.order_id, order);
+                        engine.onAdd(msg.new_order_id, order.side, msg.price, msg.quantity,
+                                     info[msg.new_order_id]);
+                        break;
+                }
+            }
+            engine_ns[mode] = std::min(engine_ns[mode], elapsed_ns(start, Clock::now()));
+
+            depth[mode] = book.get_depth(100000);
+            stats[mode] = book.get_layout_stats();
+            levels = depth[mode].bids.size() + depth[mode].asks.size();
+        }
+
+        for (int mode = 0; mode < MODES; ++mode)
+        {
+            print_row(std::string("  book, ") + modes[mode].first, best_ns[mode], MESSAGES);
+        }
+        for (int mode = 0; mode < MODES; ++mode)
+        {
+            print_row(std::string("  levels only, ") + modes[mode].first, engine_ns[mode], MESSAGES);
+        }
+        bool same = true;
+        for (int mode = 1; mode < MODES; ++mode)
+        {
+            same = same && depth[0].bids == depth[mode].bids && depth[0].asks == depth[mode].asks;
+        }
+        std::cout << "    Adaptive: " << stats[2].promotions << " promotions, " << stats[2].demotions
+                  << " demotions, " << stats[2].thick_sides << "/2 sides thick at end; on the grid "
+                  << stats[3].ladder_sides << "/2 sides on a ladder, " << stats[3].ladder_spills
+                  << " spills (" << levels << " levels); depth identical across layouts: "
+                  << (same ? "Yes" : "No") << "\n";
+    }
+
+    // Hysteresis: a book hovering around the promote threshold
+    auto decoded = decode_feed(generate_feed(MESSAGES, 7, 12));
+    for (bool hysteresis : {false, true})
+    {
+        LayoutConfig config;
+        if (!hysteresis) config.demote_levels = config.promote_levels;
+        DataFabric fabric(0);
+        OrderBook book(fabric);
+        book.set_layout_config(config);
+        for (size_t i = 0; i < decoded.size(); ++i)
+        {
+            book.handle_message(decoded[i]);
+            // Periodically sweep the deep half away so depth keeps crossing the threshold
+            if (i % 50000 == 49999)
+            {
+                for (size_t j = 0; j <= i; ++j)
+                {
+                    const auto& msg = decoded[j];
+                    uint64_t id = (msg.type == 'U') ? msg.new_order_id : msg.order_id;
+                    const Order* order = book.find_order(id);
+                    if (order && order->active && (order->price < 9994 || order->price > 10007))
+                    {
+                        book.cancel_order(id);
+                    }
+                }
+            }
+        }
+        LayoutStats stats = book.get_layout_stats();
+        std::cout << "  Threshold churn, " << (hysteresis ? "promote 24 / demote 8" : "promote = demote = 24")
+                  << ": " << stats.promotions << " promotions, " << stats.demotions << " demotions\n";
+    }
+    std::cout << "\n";
+}
+
+// ============================================================================
+// Trigger Index
+// ============================================================================
+
+// One armed condition per slot; a slot re-arms from (slot, generation) alone,
+// so both evaluators below see identical triggers whatever order they fire in
+struct TriggerSlot
+{
+    TriggerIndex::Kind kind;
+    Side side;
+    uint32_t price;
+    int64_t threshold;
+    uint32_t generation;
+};
+
+static TriggerSlot make_trigger_slot(size_t slot, uint32_t generation)
+{
+    FastRng rng(slot * 1000003ULL + generation * 7919ULL + 1);
+    TriggerSlot t{};
+    t.kind = static_cast<TriggerIndex::Kind>(slot % 3);
+    t.side = rng.below(2) ? Side::Bid : Side::Ask;
+    t.price = 9950 + rng.below(101);
+    t.threshold = (t.kind == TriggerIndex::Kind::SpreadAbove) ? static_cast<int64_t>(rng.below(101)) - 50
+                                                              : 100 + rng.below(3000);
+    t.generation = generation;
+    return t;
+}
+
+static uint64_t trigger_digest(size_t slot, uint32_t generation, size_t message)
+{
+    return (slot * 2654435761ULL) ^ (generation * 40503ULL) ^ (message * 0x9E3779B97F4A7C15ULL);
+}
+
+static void bench_trigger_index()
+{
+    constexpr size_t MESSAGES = 200000;
+    std::cout << "--- Trigger Index (" << MESSAGES
+              << " messages, one-shot triggers re-armed on fire) ---\n";
+    auto decoded = decode_feed(generate_feed(MESSAGES));
+
+    double baseline_ns = 1e30;
+    for (int round = 0; round < 3; ++round)
+    {
+        DataFabric fabric(0);
+        OrderBook book(fabric);
+        auto start = Clock::now();
+        for (const auto& msg : decoded) book.handle_message(msg);
+        baseline_ns = std::min(baseline_ns, elapsed_ns(start, Clock::now()));
+    }
+    print_row("no triggers", baseline_ns, MESSAGES);
+
+    for (size_t count : {size_t{100}, size_t{1000}, size_t{10000}})
+    {
+        // ---- Index inside the engine ----
+        std::vector<TriggerSlot> slots(count);
+        size_t message = 0;
+        uint64_t index_digest = 0;
+        size_t index_fires = 0;
+
+        DataFabric fabric(0);
+        OrderBook book(fabric);
+        auto arm = [&](size_t slot) {
+            const TriggerSlot& t = slots[slot];
+            switch (t.kind)
+            {
+                case TriggerIndex::Kind::BestPrice:
+                    book.add_best_price_trigger(t.side, t.price, slot);
+                    break;
+                case TriggerIndex::Kind::LevelSizeBelow:
+                    book.add_level_size_trigger(t.side, t.price, static_cast<uint64_t>(t.threshold), slot);
+                    break;
+                case TriggerIndex::Kind::SpreadAbove:
+                    book.add_spread_trigger(t.threshold, slot);
+                    break;
+            }
+        };
+        book.set_trigger_callback([&](const TriggerIndex::Fired& fired) {
+            size_t slot = static_cast<size_t>(fired.tag);
+            index_fires++;
+            index_digest += trigger_digest(slot, slots[slot].generation, message);
+            slots[slot] = make_trigger_slot(slot, slots[slot].generation + 1);
+            arm(slot);
+        });
+        for (size_t slot = 0; slot < count; ++slot)
+        {
+            slots[slot] = make_trigger_slot(slot, 0);
+            arm(slot);
+        }
+
+        auto start = Clock::now();
+        for (const auto& msg : decoded)
+        {
+            ++message;
+            book.handle_message(msg);
+        }
+        double index_ns = elapsed_ns(start, Clock::now());
+        auto stats = book.get_trigger_stats();
+
+        // ---- Generic per-event scan of every condition ----
+        for (size_t slot = 0; slot < count; ++slot) slots[slot] = make_trigger_slot(slot, 0);
+        uint64_t scan_digest = 0;
+        size_t scan_fires = 0;
+
+        DataFabric scan_fabric(0);
+        OrderBook scan_book(scan_fabric);
+        uint64_t bid = 0, ask = 0, qty = 0;
+        bool has_bid = false, has_ask = false;
+        auto satisfied = [&](const TriggerSlot& t) {
+            if (t.kind == TriggerIndex::Kind::SpreadAbove)
+            {
+                return has_bid && has_ask &&
+                       static_cast<int64_t>(ask) - static_cast<int64_t>(bid) > t.threshold;
+            }
+            return (t.side == Side::Bid) ? has_bid && bid >= t.price : has_ask && ask <= t.price;
+        };
+
+        start = Clock::now();
+        message = 0;
+        for (const auto& msg : decoded)
+        {
+            ++message;
+
+            // Levels this message changes (looked up before it applies)
+            std::pair<Side, uint32_t> touched[2];
+            size_t touched_count = 0;
+            const Order* order = scan_book.find_order(msg.order_id);
+            Side order_side = (order && order->side == 'B') ? Side::Bid : Side::Ask;
+            if (msg.type == 'A' || msg.type == 'F')
+            {
+                touched[touched_count++] = {msg.side == 'B' ? Side::Bid : Side::Ask, msg.price};
+            }
+            else if (order && order->active)
+            {
+                touched[touched_count++] = {order_side, order->price};
+                if (msg.type == 'U') touched[touched_count++] = {order_side, msg.price};
+            }
+
+            scan_book.handle_message(msg);
+            has_bid = scan_book.get_best_bid(bid, qty);
+            has_ask = scan_book.get_best_ask(ask, qty);
+
+            for (size_t slot = 0; slot < count; ++slot)
+            {
+                while (true)
+                {
+                    const TriggerSlot& t = slots[slot];
+                    bool fire;
+                    if (t.kind == TriggerIndex::Kind::LevelSizeBelow)
+                    {
+                        bool hit = false;
+                        for (size_t i = 0; i < touched_count; ++i)
+                        {
+                            hit |= touched[i].first == t.side && touched[i].second == t.price;
+                        }
+                        fire = hit && scan_book.get_level_quantity(t.side, t.price) <
+                                          static_cast<uint64_t>(t.threshold);
+                    }
+                    else
+                    {
+                        fire = satisfied(t);
+                    }
+                    if (!fire) break;
+
+                    scan_fires++;
+                    scan_digest += trigger_digest(slot, t.generation, message);
+                    bool level = (t.kind == TriggerIndex::Kind::LevelSizeBelow);
+                    slots[slot] = make_trigger_slot(slot, t.generation + 1);
+                    if (level) break;  // A new level trigger waits for the next change
+                }
+            }
+        }
+        double scan_ns = elapsed_ns(start, Clock::now());
+
+        std::cout << "  " << count << " triggers:\n";
+        print_row("  scan all per event", scan_ns, MESSAGES);
+        print_row("  trigger index", index_ns, MESSAGES);
+        std::cout << "    " << index_fires << " fires (scan " << scan_fires << "), identical: "
+                  << (index_fires == scan_fires && index_digest == scan_digest ? "Yes" : "No")
+                  << "; " << stats.evaluations << " evaluations, " << book.get_bbo_changes()
+                  << " BBO changes\n";
+    }
+    std::cout << "\n";
+}
+
+// ============================================================================
+// Order Index Growth
+// ============================================================================
+
+struct LatencySummary
+{
+    double p50, p99, p999, p9999, max, total_ms;
+};
+
+static LatencySummary summarize_latency(std::vector<uint32_t>& ns)
+{
+    double total = 0;
+    for (uint32_t v : ns) total += v;
+    std::sort(ns.begin(), ns.end());
+    auto at = [&](double q) { return static_cast<double>(ns[static_cast<size_t>(q * (ns.size() - 1))]); };
+    return {at(0.50), at(0.99), at(0.999), at(0.9999), static_cast<double>(ns.back()), total / 1e6};
+}
+
+static void print_latency(const char* label, const LatencySummary& l)
+{
+    std::cout << "  " << std::left << std::setw(26) << label << std::right << std::fixed
+              << std::setprecision(0) << "p50 " << std::setw(4) << l.p50 << "  p99 " << std::setw(5)
+              << l.p99 << "  p99.9 " << std::setw(6) << l.p999 << "  p99.99 " << std::setw(7)
+              << l.p9999 << "  max " << std::setw(9) << l.max << " ns  (total " << std::setprecision(1)
+              << l.total_ms << " ms)\n";
+}
+
+// Times every insert of an opening-auction build-up (ids ascending with gaps)
+template <typename Map>
+static LatencySummary time_inserts(size_t count)
+{
+    std::vector<uint32_t> ns(count);
+    Map map;
+    FastRng rng(7);
+    uint64_t id = 1000;
+    for (size_t i = 0; i < count; ++i)
+    {
+        id += 1 + rng.below(4);
+        Order order(id, 10000 + rng.below(50), 100, (i & 1) ? 'B' : 'S', i);
+        auto start = Clock::now();
+        map.emplace(id, order);
+        ns[i] = static_cast<uint32_t>(std::min(elapsed_ns(start, Clock::now()), 4e9));
+    }
+    return summarize_latency(ns);
+}
+
+static void bench_order_index()
+{
+    constexpr size_t ORDERS = 4000000;
+    std::cout << "--- Order Index Growth (" << ORDERS << " inserts, per-insert latency) ---\n";
+
+    // Interleaved, keeping each mode's best tail; the index itself
+    LatencySummary best[2];
+    for (int round = 0; round < 4; ++round)
+    {
+        int mode = round % 2;
+        LatencySummary l = (mode == 0) ? time_inserts<std::unordered_map<uint64_t, Order>>(ORDERS)
+                                      : time_inserts<OrderIndex<Order>>(ORDERS);
+        if (round < 2 || l.p9999 < best[mode].p9999) best[mode] = l;
+    }
+    print_latency("std::unordered_map", best[0]);
+    print_latency("OrderIndex (incremental)", best[1]);
+
+    // Through the book: add_order updates both indices plus the level engine
+    std::vector<uint32_t> ns(ORDERS);
+    DataFabric fabric(0);
+    OrderBook book(fabric);
+    FastRng rng(7);
+    for (size_t i = 0; i < ORDERS; ++i)
+    {
+        bool bid = (i & 1) != 0;
+        Order order(i + 1, bid ? 9999 - rng.below(50) : 10001 + rng.below(50), 100, bid ? 'B' : 'S', i);
+        auto start = Clock::now();
+        book.add_order(order);
+        ns[i] = static_cast<uint32_t>(std::min(elapsed_ns(start, Clock::now()), 4e9));
+    }
+    print_latency("OrderBook::add_order", summarize_latency(ns));
+
+    // Venue-striped ids (every 4096th): identical low bits
+    constexpr size_t STRIPED = 1000000;
+    OrderIndex<uint64_t> striped;
+    for (uint64_t i = 1; i <= STRIPED; ++i) striped.emplace(i << 12, i);
+    uint64_t found = 0;
+    auto start = Clock::now();
+    for (uint64_t i = 1; i <= STRIPED; ++i) found += striped.find(i << 12)->second;
+    print_row("OrderIndex::find, ids step 4096", elapsed_ns(start, Clock::now()), STRIPED);
+    std::cout << "  All striped ids found: " << (found == STRIPED * (STRIPED + 1) / 2 ? "Yes" : "NO") << "\n\n";
+}
+
+// ============================================================================
+// Empty-Level Retention
+// ============================================================================
+
+// Touch-heavy flow: a handful of live orders within 4 units of the 10000 /
+// 10001 touch, so levels empty and refill constantly. With deep_levels > 0 a
+// resting background 100+ units away keeps both sides in the thick layout.
+static std::vector<ITCHParser::ParseResult> touch_flicker_feed(size_t count, size_t deep_levels)
+{
+    std::vector<ITCHParser::ParseResult> out;
+    out.reserve(count + 2 * deep_levels);
+    auto make = [](char type, uint64_t id, uint32_t price, uint32_t qty, char side) {
+        ITCHParser::ParseResult r{};
+        r.valid = true;
+        r.type = type;
+        r.order_id = id;
+        r.price = price;
+        r.quantity = qty;
+        r.side = side;
+        return r;
+    };
+
+    uint64_t next_id = 1;
+    for (size_t i = 0; i < deep_levels; ++i)
+    {
+        out.push_back(make('A', next_id++, 9900 - static_cast<uint32_t>(i), 500, 'B'));
+        out.push_back(make('A', next_id++, 10101 + static_cast<uint32_t>(i), 500, 'S'));
+    }
+
+    FastRng rng(11);
+    struct Live
+    {
+        uint64_t id;
+        uint32_t qty;
+    };
+    std::vector<Live> live;
+    while (out.size() < count + 2 * deep_levels)
+    {
+        if (live.size() < 8 || (live.size() < 24 && rng.below(2) == 0))
+        {
+            bool bid = rng.below(2) == 0;
+            uint32_t price = bid ? 10000 - rng.below(4) : 10001 + rng.below(4);
+            uint32_t qty = 100 * (1 + rng.below(5));
+            out.push_back(make('A', next_id, price, qty, bid ? 'B' : 'S'));
+            live.push_back({next_id++, qty});
+            continue;
+        }
+        size_t pick = rng.below(static_cast<uint32_t>(live.size()));
+        if (rng.below(4) == 0)
+            out.push_back(make('E', live[pick].id, 0, live[pick].qty, 0));  // Full fill
+        else
+            out.push_back(make('X', live[pick].id, 0, 0, 0));
+        live[pick] = live.back();
+        live.pop_back();
+    }
+    return out;
+}
+
+static void bench_level_retention()
+{
+    constexpr size_t MESSAGES = 2000000;
+    std::cout << "--- Empty-Level Retention (" << MESSAGES << " touch-heavy messages) ---\n";
+
+    LevelRetention off;
+    off.max_empty = 0;
+    const LevelRetention on;
+
+    for (size_t deep : {size_t{0}, size_t{200}})
+    {
+        auto decoded = touch_flicker_feed(MESSAGES, deep);
+        std::cout << "  " << (deep ? "Thick sides (200 resting levels behind the touch):"
+                                   : "Thin sides (touch only):") << "\n";
+
+        double best_ns[2] = {1e30, 1e30};
+        RetentionStats stats[2];
+        for (int round = 0; round < 6; ++round)
+        {
+            int mode = round % 2;
+            DataFabric fabric(0);
+            OrderBook book(fabric);
+            book.set_level_retention(mode ? on : off);
+
+            auto start = Clock::now();
+            for (const auto& msg : decoded) book.handle_message(msg);
+            best_ns[mode] = std::min(best_ns[mode], elapsed_ns(start, Clock::now()));
+            stats[mode] = book.get_retention_stats();
+        }
+        for (int mode = 0; mode < 2; ++mode)
+        {
+            print_row(mode ? "retain up to 8 empty levels" : "erase on empty", best_ns[mode],
+                      decoded.size());
+            std::cout << "    levels created " << stats[mode].created << ", revived "
+                      << stats[mode].revived << ", reclaimed " << stats[mode].reclaimed << "\n";
+        }
+    }
+
+    // Cross-check: both policies must expose the same book after every message
+    auto decoded = touch_flicker_feed(200000, 200);
+    DataFabric fabric_a(0), fabric_b(0);
+    OrderBook erase_book(fabric_a), retain_book(fabric_b);
+    erase_book.set_level_retention(off);
+    size_t mismatches = 0;
+    for (const auto& msg : decoded)
+    {
+        erase_book.handle_message(msg);
+        retain_book.handle_message(msg);
+        auto a = erase_book.get_depth(5);
+        auto b = retain_book.get_depth(5);
+        if (a.bids != b.bids || a.asks != b.asks) ++mismatches;
+    }
+    std::cout << "  Top-5 depth after each of " << decoded.size() << " messages: " << mismatches
+              << " mismatches\n\n";
+}
+
+// ============================================================================
+// Tick-to-Trade Loopback
+// ============================================================================
+
+// One packet per tick alternately improves the best bid and pulls it back,
+// so every tick changes the BBO and the strategy sends one OUCH order. Each
+// tick runs to completion (the exchange has the order) before the next.
+static void run_tick_to_trade(const char* label, OrderTransport& transport, LocalExchange& exchange,
+                              const std::vector<uint64_t>& recv_ns, size_t ticks, size_t warmup)
+{
+    std::vector<std::vector<uint8_t>> packets;
+    for (size_t i = 0; i < ticks + warmup; ++i)
+    {
+        uint64_t id = 1000 + i / 2;
+        packets.push_back((i % 2 == 0) ? MessageBuilder::build_add_order(id, 10001, 100, 'B', i)
+                                       : MessageBuilder::build_cancel_order(id));
+    }
+
+    DataFabric fabric;
+    OrderBook book(fabric);
+    book.add_order(Order(1, 10000, 500, 'B', 0));
+    book.add_order(Order(2, 10010, 500, 'S', 0));
+
+    OuchEncoder encoder("TEST");
+    const OuchSymbol stock("TEST");
+    std::vector<uint64_t> in_ns(packets.size()), book_ns(packets.size()), encoded_ns(packets.size());
+    size_t tick = 0;
+    auto now_ns = [] {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+    };
+
+    // Strategy: join the new best bid with an IOC order
+    uint8_t order[OuchEncoder::MAX_MESSAGE_SIZE];
+    book.set_bbo_callback([&](const TopOfBook& top) {
+        book_ns[tick] = now_ns();
+        size_t length = encoder.enter_order(order, 'B', 100, stock, static_cast<uint32_t>(top.bid_price));
+        // Stamped before send: over loopback the exchange may run (and stamp
+        // receipt) before send() returns on a busy core
+        encoded_ns[tick] = now_ns();
+        transport.send(order, length);
+    });
+
+    uint64_t base = exchange.messages();
+    for (tick = 0; tick < packets.size(); ++tick)
+    {
+        in_ns[tick] = now_ns();
+        fabric.write_chunk(packets[tick]);
+        book.process();
+
+        auto deadline = Clock::now() + std::chrono::seconds(2);
+        while (exchange.messages() < base + tick + 1)
+        {
+            if (Clock::now() > deadline)
+            {
+                std::cout << "  " << label << ": order " << tick << " never reached the exchange\n";
+                return;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    // Token counters start at 1, one order per tick
+    std::vector<uint32_t> stage[4];
+    for (size_t i = warmup; i < packets.size(); ++i)
+    {
+        stage[0].push_back(static_cast<uint32_t>(book_ns[i] - in_ns[i]));
+        stage[1].push_back(static_cast<uint32_t>(encoded_ns[i] - book_ns[i]));
+        stage[2].push_back(static_cast<uint32_t>(recv_ns[i + 1] - encoded_ns[i]));
+        stage[3].push_back(static_cast<uint32_t>(recv_ns[i + 1] - in_ns[i]));
+    }
+
+    static const char* const STAGES[] = {"fabric + parse + book", "strategy + OUCH encode",
+                                         "send + transport", "tick-to-trade"};
+    std::cout << "  " << label << " (" << ticks << " ticks):\n";
+    for (int s = 0; s < 4; ++s)
+    {
+        LatencySummary l = summarize_latency(stage[s]);
+        std::cout << "    " << std::left << std::setw(26) << STAGES[s] << std::right << std::fixed
+                  << std::setprecision(0) << "p50 " << std::setw(6) << l.p50 << "  p99 " << std::setw(6)
+                  << l.p99 << "  p99.9 " << std::setw(7) << l.p999 << "  max " << std::setw(8) << l.max
+                  << " ns\n";
+    }
+}
+
+static void bench_tick_to_trade()
+{
+    constexpr size_t TICKS = 20000;
+    constexpr size_t WARMUP = 2000;
+    std::cout << "--- Tick-to-Trade (ITCH packet in -> OUCH order at a local exchange) ---\n";
+
+    // Exchange callbacks index receive times by token counter
+    std::vector<uint64_t> recv_ns(TICKS + WARMUP + 1);
+    auto record = [&recv_ns](const OuchMessage& msg, uint64_t ns) {
+        uint64_t n = OuchDecoder::token_number(msg.token);
+        if (n < recv_ns.size()) recv_ns[n] = ns;
+    };
+
+    {
+        ShmOrderRing ring(1024);
+        LocalExchange exchange(record);
+        exchange.attach(&ring);
+        if (ring.valid() && exchange.start())
+        {
+            run_tick_to_trade("shared-memory ring", ring, exchange, recv_ns, TICKS, WARMUP);
+        }
+        else
+        {
+            std::cout << "  shared-memory ring unavailable\n";
+        }
+    }
+
+    {
+        LocalExchange exchange(record);
+        LoopbackOrderSession session;
+        if (exchange.listen(0) && exchange.start() && session.connect(exchange.port()))
+        {
+            run_tick_to_trade("loopback TCP (SoupBinTCP)", session, exchange, recv_ns, TICKS, WARMUP);
+        }
+        else
+        {
+            std::cout << "  loopback TCP unavailable\n";
+        }
+        session.close();
+        exchange.stop();
+        LocalExchange::Stats stats = exchange.get_stats();
+        std::cout << "  Exchange decoded " << stats.enters << " enter orders, " << stats.malformed
+                  << " malformed\n";
+    }
+    std::cout << "\n";
+}
+
+// ============================================================================
+// Pre-Trade Risk
+// ============================================================================
+
+// The same rules through the usual generic shape: one mutex, a hash map of
+// per-symbol records, a chain of virtual rule objects, band computed per check
+class GenericRisk
+{
+   public:
+    struct State
+    {
+        RiskLimits limits;
+        TopOfBook top;
+        int64_t position = 0, open_buy = 0, open_sell = 0;
+        uint64_t tat = 0;
+    };
+    struct Request
+    {
+        bool buy;
+        uint32_t qty, price;
+        uint64_t now_ns;
+    };
+    struct Rule
+    {
+        virtual ~Rule() = default;
+        virtual uint32_t evaluate(const State& st, const Request& r) const = 0;
+    };
+
+    GenericRisk()
+    {
+        struct Band : Rule
+        {
+            uint32_t evaluate(const State& st, const Request& r) const override
+            {
+                if (!st.top.bid_qty && !st.top.ask_qty) return RISK_PRICE_BAND;
+                uint64_t bid = st.top.bid_qty ? st.top.bid_price : st.top.ask_price;
+                uint64_t ask = st.top.ask_qty ? st.top.ask_price : st.top.bid_price;
+                uint64_t below = bid * st.limits.band_bps / 10000, above = ask * st.limits.band_bps / 10000;
+                uint64_t lo = bid > below ? bid - below : 0;
+                return (r.price < lo || r.price > ask + above) ? RISK_PRICE_BAND : 0;
+            }
+        };
+        struct Quantity : Rule
+        {
+            uint32_t evaluate(const State& st, const Request& r) const override
+            {
+                return r.qty > st.limits.max_order_qty ? RISK_MAX_QUANTITY : 0;
+            }
+        };
+        struct Notional : Rule
+        {
+            uint32_t evaluate(const State& st, const Request& r) const override
+            {
+                return static_cast<uint64_t>(r.price) * r.qty > st.limits.max_notional ? RISK_MAX_NOTIONAL : 0;
+            }
+        };
+        struct Position : Rule
+        {
+            uint32_t evaluate(const State& st, const Request& r) const override
+            {
+                int64_t projected = r.buy ? st.position + st.open_buy + r.qty : st.open_sell + r.qty - st.position;
+                return projected > st.limits.max_position ? RISK_POSITION : 0;
+            }
+        };
+        struct Rate : Rule
+        {
+            uint32_t evaluate(const State& st, const Request& r) const override
+            {
+                uint64_t interval = 1000000000ull / st.limits.orders_per_second;
+                return r.now_ns + interval * (st.limits.burst - 1) < st.tat ? RISK_ORDER_RATE : 0;
+            }
+        };
+        rules_.emplace_back(new Band);
+        rules_.emplace_back(new Quantity);
+        rules_.emplace_back(new Notional);
+        rules_.emplace_back(new Position);
+        rules_.emplace_back(new Rate);
+    }
+
+    void set_limits(uint16_t symbol, const RiskLimits& limits)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        symbols_[symbol].limits = limits;
+    }
+    void on_bbo(uint16_t symbol, const TopOfBook& top)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        symbols_[symbol].top = top;
+    }
+    uint32_t check(uint16_t symbol, char side, uint32_t qty, uint32_t price, uint64_t now_ns)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = symbols_.find(symbol);
+        if (it == symbols_.end()) return RISK_UNKNOWN_SYMBOL;
+        State& st = it->second;
+        Request r{side == 'B', qty, price, now_ns};
+        uint32_t flags = 0;
+        for (const auto& rule : rules_) flags |= rule->evaluate(st, r);
+        if (flags == 0)
+        {
+            (r.buy ? st.open_buy : st.open_sell) += qty;
+            st.tat = std::max(st.tat, now_ns) + 1000000000ull / st.limits.orders_per_second;
+        }
+        return flags;
+    }
+    void on_fill(uint16_t symbol, char side, uint32_t qty)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        State& st = symbols_[symbol];
+        if (side == 'B')
+        {
+            st.open_buy -= qty;
+            st.position += qty;
+        }
+        else
+        {
+            st.open_sell -= qty;
+            st.position -= qty;
+        }
+    }
+    void on_done(uint16_t symbol, char side, uint32_t leaves)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        State& st = symbols_[symbol];
+        (side == 'B' ? st.open_buy : st.open_sell) -= leaves;
+    }
+
+   private:
+    std::mutex mutex_;
+    std::unordered_map<uint16_t, State> symbols_;
+    std::vector<std::unique_ptr<Rule>> rules_;
+};
+
+struct RiskEvent
+{
+    uint8_t kind;  // 0 = BBO update, 1 = order check
+    uint16_t symbol;
+    char side;
+    uint32_t qty;
+    uint32_t price;
+    uint32_t fill;  // Shares filled if accepted (rest released)
+    uint64_t now_ns;
+};
+
+template <typename Risk>
+static uint64_t run_risk(Risk& risk, const std::vector<RiskEvent>& events, std::vector<uint32_t>* results)
+{
+    uint64_t digest = 0;
+    for (const RiskEvent& e : events)
+    {
+        if (e.kind == 0)
+        {
+            TopOfBook top{e.price, 100, e.price + 2, 100};
+            risk.on_bbo(e.symbol, top);
+            continue;
+        }
+        uint32_t flags = risk.check(e.symbol, e.side, e.qty, e.price, e.now_ns);
+        digest = digest * 31 + flags;
+        if (results) results->push_back(flags);
+        if (flags == 0)
+        {
+            if (e.fill) risk.on_fill(e.symbol, e.side, e.fill);
+            if (e.fill < e.qty) risk.on_done(e.symbol, e.side, e.qty - e.fill);
+        }
+    }
+    return digest;
+}
+
+static void bench_pre_trade_risk()
+{
+    constexpr size_t SYMBOLS = 512;
+    constexpr size_t EVENTS = 2000000;
+    std::cout << "--- Pre-Trade Risk (" << SYMBOLS << " symbols, " << EVENTS << " events) ---\n";
+
+    RiskLimits limits;
+    limits.orders_per_second = 20000;
+    limits.burst = 4;
+
+    // 10% BBO moves, 90% orders: mostly near the touch, some far through it,
+    // some oversized; fills accumulate positions until the limit bites
+    std::vector<RiskEvent> events;
+    events.reserve(EVENTS);
+    std::vector<uint32_t> mid(SYMBOLS);
+    FastRng rng(5);
+    for (size_t s = 0; s < SYMBOLS; ++s)
+    {
+        mid[s] = 100000 + rng.below(4000000);
+        events.push_back({0, static_cast<uint16_t>(s), 0, 0, mid[s], 0, 0});
+    }
+    uint64_t now = 1000000;
+    while (events.size() < EVENTS)
+    {
+        uint16_t s = static_cast<uint16_t>(rng.below(SYMBOLS));
+        now += 150;
+        if (rng.below(10) == 0)
+        {
+            mid[s] = mid[s] + rng.below(201) - 100;
+            events.push_back({0, s, 0, 0, mid[s], 0, now});
+            continue;
+        }
+        char side = rng.below(2) ? 'B' : 'S';
+        uint32_t qty = (rng.below(50) == 0) ? 20000 : 100 * (1 + rng.below(20));
+        int32_t offset = (rng.below(40) == 0) ? static_cast<int32_t>(mid[s] / 10) : static_cast<int32_t>(rng.below(50));
+        uint32_t price = (side == 'B') ? mid[s] + offset : mid[s] - static_cast<uint32_t>(std::min<int32_t>(offset, mid[s] / 2));
+        uint32_t fill = rng.below(2) ? qty : 0;
+        events.push_back({1, s, side, qty, price, fill, now});
+    }
+    size_t checks = 0;
+    for (const RiskEvent& e : events) checks += e.kind;
+
+    double best_ns[2] = {1e30, 1e30};
+    uint64_t digest[2] = {0, 0};
+    for (int round = 0; round < 6; ++round)
+    {
+        int mode = round % 2;
+        auto start = Clock::now();
+        if (mode == 0)
+        {
+            GenericRisk risk;
+            for (size_t s = 0; s < SYMBOLS; ++s) risk.set_limits(static_cast<uint16_t>(s), limits);
+            start = Clock::now();
+            digest[0] = run_risk(risk, events, nullptr);
+        }
+        else
+        {
+            PreTradeRisk risk(SYMBOLS);
+            for (size_t s = 0; s < SYMBOLS; ++s) risk.set_limits(static_cast<uint16_t>(s), limits);
+            start = Clock::now();
+            digest[1] = run_risk(risk, events, nullptr);
+        }
+        best_ns[mode] = std::min(best_ns[mode], elapsed_ns(start, Clock::now()));
+    }
+    print_row("mutex + map + virtual rules", best_ns[0], events.size());
+    print_row("PreTradeRisk (SoA, branch-light)", best_ns[1], events.size());
+
+    // Check cost alone: back-to-back checks on fresh state, no BBO or fill traffic
+    std::vector<RiskEvent> orders;
+    for (const RiskEvent& e : events)
+    {
+        if (e.kind == 1) orders.push_back(e);
+    }
+    double check_ns = 1e30;
+    uint64_t sink = 0;
+    for (int round = 0; round < 3; ++round)
+    {
+        PreTradeRisk risk(SYMBOLS);
+        for (size_t s = 0; s < SYMBOLS; ++s)
+        {
+            risk.set_limits(static_cast<uint16_t>(s), limits);
+            risk.on_bbo(static_cast<uint16_t>(s), TopOfBook{mid[s], 100, mid[s] + 2, 100});
+        }
+        auto start = Clock::now();
+        for (const RiskEvent& e : orders) sink += risk.check(e.symbol, e.side, e.qty, e.price, e.now_ns);
+        check_ns = std::min(check_ns, elapsed_ns(start, Clock::now()));
+    }
+    std::cout << "  check() alone: " << std::fixed << std::setprecision(1) << check_ns / orders.size()
+              << " ns per check (" << orders.size() << " checks, flag sum " << sink << ")\n";
+
+    // Cross-check decisions, and show the reject mix
+    PreTradeRisk risk(SYMBOLS);
+    for (size_t s = 0; s < SYMBOLS; ++s) risk.set_limits(static_cast<uint16_t>(s), limits);
+    std::vector<uint32_t> flags;
+    run_risk(risk, events, &flags);
+    const auto& stats = risk.get_stats();
+    static const char* const REASONS[] = {"band", "qty", "notional", "position", "rate", "halted", "unknown"};
+    std::cout << "  " << checks << " checks, " << stats.accepted << " accepted; rejects:";
+    for (size_t i = 0; i < PreTradeRisk::REJECT_REASONS; ++i)
+    {
+        if (stats.rejects[i]) std::cout << " " << REASONS[i] << " " << stats.rejects[i];
+    }
+    std::cout << "\n  Decisions identical to the generic path: " << (digest[0] == digest[1] ? "Yes" : "NO")
+              << "\n\n";
+}
+
+// ============================================================================
+// Portfolio mark-to-market: delta updates vs timed sweeps over the books
+// ============================================================================
+
+struct MarkEvent
+{
+    uint16_t symbol;
+    TopOfBook top;
+};
+
+// Plain loop with a single accumulator per total: what recompute() replaces
+static Portfolio::Totals sweep_scalar(const std::vector<double>& q, const std::vector<double>& m,
+                                      const std::vector<double>& c)
+{
+    Portfolio::Totals t;
+    for (size_t i = 0; i < q.size(); ++i)
+    {
+        t.net_value += q[i] * m[i];
+        t.gross_value += std::fabs(q[i]) * m[i];
+        t.cost += c[i];
+    }
+    return t;
+}
+
+static void bench_portfolio()
+{
+    constexpr size_t SYMBOLS = 8000;
+    constexpr size_t UPDATES = 4000000;
+    std::cout << "--- Portfolio Mark-to-Market (" << SYMBOLS << " positions, " << UPDATES
+              << " BBO changes) ---\n";
+
+    FastRng rng(11);
+    std::vector<uint32_t> mid(SYMBOLS);
+    std::vector<int64_t> qty(SYMBOLS);
+    std::vector<double> avg(SYMBOLS);
+    for (size_t s = 0; s < SYMBOLS; ++s)
+    {
+        mid[s] = 100000 + rng.below(4000000);
+        qty[s] = static_cast<int64_t>(100 * (1 + rng.below(100))) * (rng.below(3) == 0 ? -1 : 1);
+        avg[s] = mid[s] * (0.9 + 0.2 * rng.below(1000) / 1000.0);
+    }
+
+    std::vector<MarkEvent> events;
+    events.reserve(UPDATES);
+    std::vector<TopOfBook> last(SYMBOLS);
+    for (size_t i = 0; i < UPDATES; ++i)
+    {
+        uint16_t s = static_cast<uint16_t>(rng.below(SYMBOLS));
+        mid[s] = std::max<uint32_t>(mid[s] + rng.below(201) - 100, 1000);
+        uint32_t half = 1 + rng.below(10);
+        last[s] = TopOfBook{mid[s] - half, 100 + rng.below(900), mid[s] + half, 100 + rng.below(900)};
+        events.push_back({s, last[s]});
+    }
+
+    auto make_portfolio = [&](Portfolio& p)
+    {
+        for (size_t s = 0; s < SYMBOLS; ++s) p.set_position(static_cast<uint16_t>(s), qty[s], avg[s]);
+    };
+
+    // Delta updates: every change is applied as it arrives
+    double delta_ns = 1e30;
+    for (int round = 0; round < 3; ++round)
+    {
+        Portfolio p(SYMBOLS);
+        make_portfolio(p);
+        auto start = Clock::now();
+        for (const MarkEvent& e : events) p.on_bbo(e.symbol, e.top);
+        delta_ns = std::min(delta_ns, elapsed_ns(start, Clock::now()));
+    }
+    print_row("delta update per BBO change", delta_ns, UPDATES);
+
+    // Timer baseline: query every book's touch and reprice every position
+    std::vector<std::unique_ptr<OrderBookEngine>> books;
+    OrderInfo info;
+    for (size_t s = 0; s < SYMBOLS; ++s)
+    {
+        books.push_back(std::make_unique<OrderBookEngine>());
+        books.back()->onAdd(2 * s + 1, Side::Bid, mid[s] - 1, 100, info);
+        books.back()->onAdd(2 * s + 2, Side::Ask, mid[s] + 1, 100, info);
+    }
+    constexpr int PASSES = 200;
+    double query_ns = 1e30;
+    volatile double query_sink = 0;
+    for (int round = 0; round < 3; ++round)
+    {
+        auto start = Clock::now();
+        for (int pass = 0; pass < PASSES; ++pass)
+        {
+            double value = 0;
+            for (size_t s = 0; s < SYMBOLS; ++s)
+            {
+                uint64_t bid = 0, ask = 0, bq = 0, aq = 0;
+                books[s]->getBestBid(bid, bq);
+                books[s]->getBestAsk(ask, aq);
+                value += static_cast<double>(qty[s]) * 0.5 * static_cast<double>(bid + ask) - qty[s] * avg[s];
+            }
+            query_sink = query_sink + value;
+        }
+        query_ns = std::min(query_ns, elapsed_ns(start, Clock::now()) / PASSES);
+    }
+
+    // Full recompute over the SoA arrays, scalar loop vs recompute()
+    Portfolio p(SYMBOLS);
+    make_portfolio(p);
+    for (const MarkEvent& e : events) p.on_bbo(e.symbol, e.top);
+    std::vector<double> q(SYMBOLS), m(SYMBOLS), c(SYMBOLS);
+    for (size_t s = 0; s < SYMBOLS; ++s)
+    {
+        q[s] = static_cast<double>(qty[s]);
+        m[s] = p.mark(static_cast<uint16_t>(s));
+        c[s] = qty[s] * avg[s];
+    }
+    double scalar_ns = 1e30, simd_ns = 1e30;
+    volatile double sink = 0;
+    Portfolio copy = p;
+    for (int round = 0; round < 3; ++round)
+    {
+        auto start = Clock::now();
+        for (int pass = 0; pass < PASSES; ++pass) sink = sink + sweep_scalar(q, m, c).pnl();
+        scalar_ns = std::min(scalar_ns, elapsed_ns(start, Clock::now()) / PASSES);
+        start = Clock::now();
+        for (int pass = 0; pass < PASSES; ++pass) sink = sink + copy.recompute();
+        simd_ns = std::min(simd_ns, elapsed_ns(start, Clock::now()) / PASSES);
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  Timer sweep via getBestBid/getBestAsk: " << query_ns / 1000 << " us per pass ("
+              << query_ns / SYMBOLS << " ns per position)\n";
+    std::cout << "  Full recompute, scalar loop:           " << scalar_ns / 1000 << " us per pass\n";
+    std::cout << "  Full recompute, recompute():           " << simd_ns / 1000 << " us per pass\n";
+    std::cout << "  A sweep costs as much as " << std::setprecision(0) << query_ns / (delta_ns / UPDATES)
+              << " delta updates\n";
+
+    // Accuracy: running totals after every change vs the final books, in long double
+    long double expect = 0;
+    for (size_t s = 0; s < SYMBOLS; ++s)
+    {
+        // A symbol with no BBO change stays marked at its cost
+        long double mark = last[s].bid_qty ? 0.5L * (last[s].bid_price + last[s].ask_price) : avg[s];
+        expect += qty[s] * mark - qty[s] * static_cast<long double>(avg[s]);
+    }
+    double running = p.totals().pnl();
+    double drift = p.recompute();
+    std::cout << std::setprecision(4) << "  P&L $" << running / 10000 << " running, $" << p.totals().pnl() / 10000
+              << " recomputed, $" << static_cast<double>(expect / 10000) << " reference; drift corrected "
+              << std::scientific << std::setprecision(2) << drift << " units\n\n"
+              << std::defaultfloat;
+}
+
+// ============================================================================
+// ETF iNAV: delta updates vs full basket recompute per constituent change
+// ============================================================================
+
+struct InavBasket
+{
+    uint32_t creation_unit;
+    int64_t cash;
+    std::vector<std::pair<uint16_t, int64_t>> holdings;  // (symbol, shares)
+};
+
+// Reference: reprice every constituent of every basket that holds the symbol
+static void full_inav(const std::vector<InavBasket>& baskets, const std::vector<std::vector<uint32_t>>& holders,
+                      const std::vector<TopOfBook>& tops, uint16_t symbol, std::vector<int64_t>& value2)
+{
+    for (uint32_t b : holders[symbol])
+    {
+        int64_t v = 2 * baskets[b].cash;
+        for (const auto& [s, shares] : baskets[b].holdings)
+        {
+            if (tops[s].bid_qty) v += shares * static_cast<int64_t>(tops[s].bid_price + tops[s].ask_price);
+        }
+        value2[b] = v;
+    }
+}
+
+static void bench_inav()
+{
+    constexpr size_t SYMBOLS = 3000;
+    constexpr size_t BASKETS = 8;
+    constexpr size_t CONSTITUENTS = 500;
+    constexpr size_t UPDATES = 4000000;
+    constexpr size_t FULL_UPDATES = 100000;  // The recompute-per-change baseline is slow
+    std::cout << "--- ETF iNAV (" << BASKETS << " baskets x " << CONSTITUENTS << " constituents, " << SYMBOLS
+              << " symbols) ---\n";
+
+    FastRng rng(23);
+    std::vector<InavBasket> baskets(BASKETS);
+    std::vector<std::vector<uint32_t>> holders(SYMBOLS);
+    for (uint32_t b = 0; b < BASKETS; ++b)
+    {
+        baskets[b].creation_unit = 50000;
+        baskets[b].cash = rng.below(100000000);
+        std::vector<uint16_t> pool(SYMBOLS);
+        for (size_t s = 0; s < SYMBOLS; ++s) pool[s] = static_cast<uint16_t>(s);
+        for (size_t i = 0; i < CONSTITUENTS; ++i)
+        {
+            std::swap(pool[i], pool[i + rng.below(static_cast<uint32_t>(SYMBOLS - i))]);
+            baskets[b].holdings.push_back({pool[i], 1 + rng.below(5000)});
+            holders[pool[i]].push_back(b);
+        }
+    }
+
+    std::vector<uint32_t> mid(SYMBOLS);
+    for (size_t s = 0; s < SYMBOLS; ++s) mid[s] = 100000 + rng.below(4000000);
+    std::vector<MarkEvent> events;
+    events.reserve(UPDATES);
+    for (size_t s = 0; s < SYMBOLS; ++s)
+    {
+        events.push_back({static_cast<uint16_t>(s), TopOfBook{mid[s] - 1, 100, mid[s] + 1, 100}});
+    }
+    while (events.size() < UPDATES)
+    {
+        uint16_t s = static_cast<uint16_t>(rng.below(SYMBOLS));
+        mid[s] = std::max<uint32_t>(mid[s] + rng.below(201) - 100, 1000);
+        uint32_t half = 1 + rng.below(10);
+        events.push_back({s, TopOfBook{mid[s] - half, 100, mid[s] + half, 100}});
+    }
+
+    auto make_calculator = [&](InavCalculator& calc)
+    {
+        for (const InavBasket& basket : baskets)
+        {
+            uint32_t id = calc.add_basket(basket.creation_unit, basket.cash);
+            for (const auto& [s, shares] : basket.holdings) calc.add_constituent(id, s, shares);
+        }
+    };
+
+    // Delta updates with seqlock publish, all changes
+    double delta_ns = 1e30;
+    for (int round = 0; round < 3; ++round)
+    {
+        InavCalculator calc(SYMBOLS, BASKETS);
+        make_calculator(calc);
+        auto start = Clock::now();
+        for (const MarkEvent& e : events) calc.on_bbo(e.symbol, e.top);
+        delta_ns = std::min(delta_ns, elapsed_ns(start, Clock::now()));
+    }
+    print_row("InavCalculator (delta + publish)", delta_ns, UPDATES);
+
+    // Baseline on a prefix: reprice the affected baskets from every constituent's BBO
+    std::vector<TopOfBook> tops(SYMBOLS);
+    std::vector<int64_t> full_value2(BASKETS);
+    double full_ns = 1e30;
+    for (int round = 0; round < 2; ++round)
+    {
+        std::fill(tops.begin(), tops.end(), TopOfBook{});
+        auto start = Clock::now();
+        for (size_t i = 0; i < FULL_UPDATES; ++i)
+        {
+            tops[events[i].symbol] = events[i].top;
+            full_inav(baskets, holders, tops, events[i].symbol, full_value2);
+        }
+        full_ns = std::min(full_ns, elapsed_ns(start, Clock::now()));
+    }
+    print_row("full recompute per change", full_ns, FULL_UPDATES);
+
+    InavCalculator calc(SYMBOLS, BASKETS);
+    make_calculator(calc);
+    for (size_t i = 0; i < FULL_UPDATES; ++i) calc.on_bbo(events[i].symbol, events[i].top);
+    bool same = true;
+    for (uint32_t b = 0; b < BASKETS; ++b)
+    {
+        InavCalculator::Snapshot snap;
+        same = same && calc.read(b, snap) && snap.value2 == full_value2[b] && snap.missing == 0;
+    }
+
+    // Concurrent reader on basket 0 while the writer runs the rest of the feed
+    std::atomic<bool> done{false};
+    uint64_t reads = 0, regressions = 0;
+    size_t retries = 0;
+    std::thread reader([&]
+    {
+        uint64_t last_version = 0;
+        while (!done.load(std::memory_order_acquire))
+        {
+            InavCalculator::Snapshot snap;
+            calc.read(0, snap, retries);
+            regressions += snap.version < last_version;
+            last_version = snap.version;
+            reads++;
+        }
+    });
+    for (size_t i = FULL_UPDATES; i < UPDATES; ++i) calc.on_bbo(events[i].symbol, events[i].top);
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    auto start = Clock::now();
+    size_t corrected = calc.recompute();
+    double recompute_ns = elapsed_ns(start, Clock::now());
+
+    InavCalculator::Snapshot snap;
+    calc.read(0, snap);
+    const auto& stats = calc.get_stats();
+    std::cout << std::fixed << std::setprecision(1) << "  Speedup: " << (full_ns / FULL_UPDATES) / (delta_ns / UPDATES)
+              << "x; values identical to the full recompute: " << (same ? "Yes" : "NO") << "\n";
+    std::cout << "  Basket 0 iNAV $" << std::setprecision(4) << snap.nav() / 10000.0 << " after " << snap.version
+              << " publishes; " << stats.publishes << " publishes total\n";
+    std::cout << "  Reader: " << reads << " snapshots, " << retries << " retries, " << regressions
+              << " version regressions\n";
+    std::cout << "  recompute(): " << std::setprecision(1) << recompute_ns / 1000 << " us, " << corrected
+              << " baskets corrected\n\n";
+    std::cout << std::defaultfloat;
+}
+
+// ============================================================================
+// Partitioned book processes: coordinator routing over shm / Unix sockets
+// ============================================================================
+
+struct PartitionRun
+{
+    double ns = 0;
+    PartitionCoordinator::Stats stats;
+};
+
+static PartitionRun run_partitions(PartitionCoordinator::Transport transport, size_t partitions,
+                                   const std::vector<uint8_t>& stream,
+                                   const std::vector<std::pair<size_t, size_t>>& packets, size_t symbols,
+                                   size_t reassign_every)
+{
+    PartitionCoordinator::Config config;
+    config.partitions = partitions;
+    config.transport = transport;
+    PartitionCoordinator coordinator(config);
+    PartitionRun run;
+    if (!coordinator.start()) return run;
+
+    // Steady rotation: every reassign_every packets, move the next symbol on
+    size_t next_symbol = 0;
+    auto start = Clock::now();
+    for (size_t i = 0; i < packets.size(); ++i)
+    {
+        coordinator.route(stream.data() + packets[i].first, packets[i].second);
+        if (reassign_every && i % reassign_every == reassign_every - 1)
+        {
+            uint16_t locate = static_cast<uint16_t>(1 + next_symbol++ % symbols);
+            coordinator.reassign(locate, (coordinator.owner(locate) + 1) % partitions);
+        }
+        if (i % 64 == 0) coordinator.poll();
+    }
+    run.stats = coordinator.collect_stats();  // Barrier: every partition has applied everything
+    run.ns = elapsed_ns(start, Clock::now());
+    coordinator.stop();
+    return run;
+}
+
+static void bench_partitions()
+{
+    constexpr size_t SYMBOLS = 64;
+    constexpr size_t PER_SYMBOL = 25000;
+    constexpr size_t PACKET_BYTES = 1400;
+    std::cout << "--- Partitioned Book Processes (" << SYMBOLS << " symbols, " << SYMBOLS * PER_SYMBOL
+              << " messages) ---\n";
+
+    // Interleave per-symbol sessions into one stream of ~MTU packets
+    std::vector<std::vector<std::vector<uint8_t>>> sessions;
+    for (size_t s = 0; s < SYMBOLS; ++s)
+    {
+        sessions.push_back(generate_feed(PER_SYMBOL, 100 + s));
+        offset_order_ids(sessions.back(), static_cast<uint64_t>(s) << 32);
+        for (auto& msg : sessions.back())
+        {
+            msg[1] = static_cast<uint8_t>(s + 1);
+            msg[2] = 0;
+        }
+    }
+    std::vector<uint8_t> stream;
+    std::vector<std::pair<size_t, size_t>> packets;
+    size_t packet_start = 0;
+    for (size_t i = 0; i < PER_SYMBOL; ++i)
+    {
+        for (size_t s = 0; s < SYMBOLS; ++s)
+        {
+            const auto& msg = sessions[s][i];
+            if (stream.size() + msg.size() - packet_start > PACKET_BYTES)
+            {
+                packets.push_back({packet_start, stream.size() - packet_start});
+                packet_start = stream.size();
+            }
+            stream.insert(stream.end(), msg.begin(), msg.end());
+        }
+    }
+    packets.push_back({packet_start, stream.size() - packet_start});
+    sessions.clear();
+
+    // Single-process reference: parse and apply to per-locate books
+    std::vector<std::unique_ptr<DataFabric>> fabrics;
+    std::vector<std::unique_ptr<OrderBook>> books;
+    for (size_t s = 0; s <= SYMBOLS; ++s)
+    {
+        fabrics.push_back(std::make_unique<DataFabric>(0));
+        books.push_back(std::make_unique<OrderBook>(*fabrics.back()));
+    }
+    ITCHParser parser;
+    auto start = Clock::now();
+    for (size_t offset = 0; offset < stream.size();)
+    {
+        auto msg = parser.parse_one(stream.data() + offset, stream.size() - offset);
+        books[msg->locate]->handle_message(*msg);
+        offset += msg->bytes_consumed;
+    }
+    double single_ns = elapsed_ns(start, Clock::now());
+    uint64_t digest = 0, orders = 0;
+    for (size_t s = 1; s <= SYMBOLS; ++s)
+    {
+        digest += PartitionCoordinator::book_digest(static_cast<uint16_t>(s), *books[s]);
+        orders += books[s]->get_active_order_count();
+    }
+    books.clear();
+    fabrics.clear();
+
+    const size_t messages = SYMBOLS * PER_SYMBOL;
+    print_row("single process, one book per symbol", single_ns, messages);
+
+    struct Case
+    {
+        const char* label;
+        PartitionCoordinator::Transport transport;
+        size_t partitions;
+        size_t reassign_every;
+    };
+    const Case cases[] = {
+        {"2 partitions, shared memory", PartitionCoordinator::Transport::SharedMemory, 2, 0},
+        {"2 partitions, Unix sockets", PartitionCoordinator::Transport::UnixSocket, 2, 0},
+        {"4 partitions, shared memory", PartitionCoordinator::Transport::SharedMemory, 4, 0},
+        {"2 partitions, shm + reassigning", PartitionCoordinator::Transport::SharedMemory, 2, 500},
+    };
+    for (const Case& c : cases)
+    {
+        PartitionRun best;
+        best.ns = 1e30;
+        for (int round = 0; round < 2; ++round)
+        {
+            PartitionRun run = run_partitions(c.transport, c.partitions, stream, packets, SYMBOLS, c.reassign_every);
+            if (run.ns > 0 && run.ns < best.ns) best = run;
+        }
+        if (best.stats.partitions.empty())
+        {
+            std::cout << "  " << c.label << ": could not start partitions\n";
+            continue;
+        }
+        print_row(c.label, best.ns, messages);
+
+        const auto& st = best.stats;
+        std::cout << "    per partition (symbols / messages):";
+        for (const auto& p : st.partitions) std::cout << " " << p.symbols << "/" << p.messages;
+        std::cout << "\n    books match single process: "
+                  << (st.total.digest == digest && st.total.orders == orders ? "Yes" : "NO") << " ("
+                  << st.total.orders << " live orders), send waits " << st.send_retries;
+        if (st.reassignments)
+        {
+            std::cout << "\n    " << st.reassignments << " reassignments, " << st.stashed
+                      << " messages stashed, pause mean " << std::fixed << std::setprecision(1)
+                      << st.total_pause_ns / 1000.0 / st.reassignments << " us, max "
+                      << st.max_pause_ns / 1000.0 << " us" << std::defaultfloat;
+        }
+        std::cout << "\n";
+    }
+    std::cout << "\n";
+}
+
+// ============================================================================
+// Symbol interning: 8-byte stock field -> dense index
+// ============================================================================
+
+static void bench_symbol_table()
+{
+    constexpr size_t SYMBOLS = 8000;
+    constexpr size_t MESSAGES = 1000000;
+    constexpr size_t STOCK_OFFSET = 24;  // In an 'A' message
+    std::cout << "--- Symbol Interning (" << SYMBOLS << " symbols, " << MESSAGES << " adds, probe "
+              << SymbolTable::probe_isa() << ") ---\n";
+
+    // Unique 1-5 letter tickers
+    FastRng rng(31);
+    std::vector<std::string> tickers;
+    std::unordered_map<std::string, uint16_t> seen;
+    while (tickers.size() < SYMBOLS)
+    {
+        std::string t;
+        size_t len = 1 + rng.below(5);
+        for (size_t i = 0; i < len; ++i) t.push_back(static_cast<char>('A' + rng.below(26)));
+        if (seen.emplace(t, 0).second) tickers.push_back(t);
+    }
+
+    // Adds skewed toward low symbol numbers, locate set to the symbol number
+    std::vector<uint8_t> stream;
+    stream.reserve(MESSAGES * ITCHParser::ADD_MSG_SIZE);
+    for (size_t i = 0; i < MESSAGES; ++i)
+    {
+        uint32_t s = rng.below(1 + rng.below(SYMBOLS));
+        auto msg = MessageBuilder::build_add_order(i + 1, 10000, 100, 'B', i);
+        msg[1] = static_cast<uint8_t>((s + 1) & 0xFF);
+        msg[2] = static_cast<uint8_t>((s + 1) >> 8);
+        uint64_t k = SymbolTable::key(tickers[s].c_str());
+        std::memcpy(msg.data() + STOCK_OFFSET, &k, 8);
+        stream.insert(stream.end(), msg.begin(), msg.end());
+    }
+
+    auto build_start = Clock::now();
+    SymbolTable table;
+    for (const std::string& t : tickers) table.intern(SymbolTable::key(t.c_str()));
+    double build_ns = elapsed_ns(build_start, Clock::now());
+
+    std::unordered_map<std::string, uint16_t> by_string;
+    std::unordered_map<uint64_t, uint16_t> by_key;
+    std::vector<uint16_t> by_locate(SymbolTable::MAX_SYMBOLS + 1, 0);
+    for (size_t s = 0; s < SYMBOLS; ++s)
+    {
+        uint64_t k = SymbolTable::key(tickers[s].c_str());
+        uint16_t id = table.find(k);
+        by_string.emplace(std::string(reinterpret_cast<const char*>(&k), 8), id);
+        by_key.emplace(k, id);
+        by_locate[s + 1] = id;
+    }
+
+    const uint8_t* base = stream.data();
+    auto resolve_locate = [&](const uint8_t* m) { return by_locate[static_cast<uint16_t>(m[1] | (m[2] << 8))]; };
+    auto resolve_string = [&](const uint8_t* m) {
+        return by_string.find(std::string(reinterpret_cast<const char*>(m + STOCK_OFFSET), 8))->second;
+    };
+    auto resolve_key = [&](const uint8_t* m) { return by_key.find(SymbolTable::key(m + STOCK_OFFSET))->second; };
+    auto resolve_table = [&](const uint8_t* m) { return table.find(SymbolTable::key(m + STOCK_OFFSET)); };
+
+    auto time_resolve = [&](auto&& resolve, uint64_t& sum) {
+        double best = 1e30;
+        for (int round = 0; round < 5; ++round)
+        {
+            uint64_t s = 0;
+            auto start = Clock::now();
+            for (size_t i = 0; i < MESSAGES; ++i) s += resolve(base + i * ITCHParser::ADD_MSG_SIZE);
+            best = std::min(best, elapsed_ns(start, Clock::now()));
+            sum = s;
+        }
+        return best;
+    };
+
+    uint64_t sums[4] = {};
+    double ns_locate = time_resolve(resolve_locate, sums[0]);
+    double ns_string = time_resolve(resolve_string, sums[1]);
+    double ns_key = time_resolve(resolve_key, sums[2]);
+    double ns_table = time_resolve(resolve_table, sums[3]);
+
+    print_row("Stock Locate array index", ns_locate, MESSAGES);
+    print_row("std::string + unordered_map", ns_string, MESSAGES);
+    print_row("uint64 key + unordered_map", ns_key, MESSAGES);
+    print_row("SymbolTable::find", ns_table, MESSAGES);
+    std::cout << "  Interning " << SYMBOLS << " symbols from empty: " << std::fixed << std::setprecision(1)
+              << build_ns / 1000 << " us (" << table.size() << " ids, e.g. " << table.name(1) << ")\n"
+              << std::defaultfloat;
+    std::cout << "  Same symbol for every message: "
+              << (sums[0] == sums[1] && sums[1] == sums[2] && sums[2] == sums[3] ? "Yes" : "NO") << "\n";
+
+    // Full feed: X/E/U carry no Stock field and route through OrderSymbols
+    struct Resting
+    {
+        uint64_t id;
+        uint32_t qty;
+        uint16_t locate;
+    };
+    std::vector<ITCHParser::ParseResult> feed;
+    std::vector<Resting> resting;
+    feed.reserve(MESSAGES);
+    uint64_t next_id = 1;
+    while (feed.size() < MESSAGES)
+    {
+        ITCHParser::ParseResult r{};
+        r.valid = true;
+        uint32_t roll = rng.below(100);
+        if (resting.size() < 1000 || roll < 40)
+        {
+            uint32_t sym = rng.below(1 + rng.below(SYMBOLS));
+            r.type = 'A';
+            r.order_id = next_id++;
+            r.quantity = 100 * (1 + rng.below(5));
+            r.locate = static_cast<uint16_t>(sym + 1);
+            r.stock = SymbolTable::key(tickers[sym].c_str());
+            resting.push_back(Resting{r.order_id, r.quantity, r.locate});
+            feed.push_back(r);
+            continue;
+        }
+        size_t pick = rng.below(static_cast<uint32_t>(resting.size()));
+        Resting& order = resting[pick];
+        r.order_id = order.id;
+        r.locate = order.locate;
+        bool gone = false;
+        if (roll < 60)
+        {
+            r.type = 'X';
+            gone = true;
+        }
+        else if (roll < 80)
+        {
+            r.type = 'E';
+            r.quantity = (order.qty > 100 && rng.below(2)) ? 100 : order.qty;
+            order.qty -= r.quantity;
+            gone = order.qty == 0;
+        }
+        else
+        {
+            r.type = 'U';
+            r.new_order_id = next_id++;
+            r.quantity = order.qty;
+            order.id = r.new_order_id;
+        }
+        if (gone)
+        {
+            resting[pick] = resting.back();
+            resting.pop_back();
+        }
+        feed.push_back(r);
+    }
+
+    double route_ns = 1e30;
+    size_t mismatches = 0;
+    size_t tracked = 0;
+    uint64_t route_sum = 0;
+    for (int round = 0; round < 3; ++round)
+    {
+        OrderSymbols orders;
+        uint64_t s = 0;
+        auto start = Clock::now();
+        for (const auto& msg : feed) s += orders.route(table, msg);
+        route_ns = std::min(route_ns, elapsed_ns(start, Clock::now()));
+        route_sum = s;
+        tracked = orders.size();
+    }
+    OrderSymbols orders;
+    uint64_t expected_sum = 0;
+    for (const auto& msg : feed)
+    {
+        mismatches += orders.route(table, msg) != by_locate[msg.locate];
+        expected_sum += by_locate[msg.locate];
+    }
+    print_row("OrderSymbols::route, A/X/E/U", route_ns, MESSAGES);
+    std::cout << "  Every message routed to its locate's symbol: " << (mismatches == 0 && route_sum == expected_sum ? "Yes" : "NO") << " ("
+              << mismatches << " mismatches, " << tracked << " resting at the end vs. " << resting.size()
+              << ")\n\n";
+}
+
+// ============================================================================
+// Pre-Open Warm-Up and Idle Keep-Warm
+// ============================================================================
+
+// Stand-in for whatever else the core ran while the book sat idle: writes a
+// buffer well beyond the LLC, evicting caches and TLB entries
+static void pollute(std::vector<uint8_t>& buffer, size_t pass)
+{
+    for (size_t i = 0; i < buffer.size(); i += 64) buffer[i] = static_cast<uint8_t>(i + pass);
+}
+
+static void bench_warmup()
+{
+    constexpr size_t FIRST = 1000;  // Messages timed after the open / after each gap
+    constexpr size_t TRIALS = 12;
+    constexpr size_t STEADY = 200000;
+    std::cout << "--- Warm-Up (first " << FIRST << " messages, " << TRIALS
+              << " trials, 64 MB sweep before each) ---\n";
+
+    std::vector<uint8_t> sweep(64 << 20, 1);
+    auto feed = generate_feed(FIRST, 77);
+
+    // Open: a fresh book per trial, cold vs warm_up() just before the first message
+    std::vector<uint32_t> open_ns[2];
+    std::vector<uint32_t> open_head[2][2];  // First 10 / 100 of each trial
+    BookWarmer::Stats warm_stats;
+    for (size_t trial = 0; trial < 2 * TRIALS; ++trial)
+    {
+        int warmed = static_cast<int>(trial % 2);
+        DataFabric fabric;
+        OrderBook book(fabric);
+        BookWarmer::Config config;
+        config.reserve_orders = 1 << 16;
+        BookWarmer warmer(config);
+        pollute(sweep, trial);
+        if (warmed)
+        {
+            warmer.warm_up(&book);
+            warm_stats = warmer.get_stats();
+        }
+
+        for (size_t i = 0; i < FIRST; ++i)
+        {
+            auto start = Clock::now();
+            fabric.write_chunk(feed[i]);
+            book.process();
+            uint32_t ns = static_cast<uint32_t>(elapsed_ns(start, Clock::now()));
+            open_ns[warmed].push_back(ns);
+            if (i < 10) open_head[0][warmed].push_back(ns);
+            if (i < 100) open_head[1][warmed].push_back(ns);
+        }
+    }
+
+    // Quiet period: a running book behind the scheduler; after each gap the
+    // next messages arrive, with and without keep_warm() on idle passes
+    auto session = generate_feed(STEADY + 2 * TRIALS * FIRST, 78);
+    DataFabric fabric;
+    OrderBook book(fabric);
+    BookWarmer warmer;
+    warmer.warm_up(&book);
+    CooperativeScheduler scheduler;
+    scheduler.add_feed("feed", fabric, book);
+    bool keep_warm = false;
+    scheduler.set_idle_callback([&]() {
+        if (keep_warm) warmer.keep_warm(&book);
+    });
+    size_t next = 0;
+    for (; next < STEADY; ++next)
+    {
+        fabric.write_chunk(session[next]);
+        scheduler.run_once();
+    }
+
+    std::vector<uint32_t> gap_ns[2];
+    std::vector<uint32_t> gap_head[2][2];
+    for (size_t trial = 0; trial < 2 * TRIALS; ++trial)
+    {
+        int warmed = static_cast<int>(trial % 2);
+        keep_warm = (warmed != 0);
+        pollute(sweep, trial);
+        auto idle_until = Clock::now() + std::chrono::microseconds(500);
+        while (Clock::now() < idle_until) scheduler.run_once();
+
+        for (size_t i = 0; i < FIRST; ++i, ++next)
+        {
+            auto start = Clock::now();
+            fabric.write_chunk(session[next]);
+            scheduler.run_once();
+            uint32_t ns = static_cast<uint32_t>(elapsed_ns(start, Clock::now()));
+            gap_ns[warmed].push_back(ns);
+            if (i < 10) gap_head[0][warmed].push_back(ns);
+            if (i < 100) gap_head[1][warmed].push_back(ns);
+        }
+    }
+
+    auto mean = [](const std::vector<uint32_t>& v) {
+        double sum = 0;
+        for (uint32_t x : v) sum += x;
+        return sum / static_cast<double>(v.size());
+    };
+    auto report = [&](const char* label, std::vector<uint32_t>* all, std::vector<uint32_t> (*head)[2]) {
+        std::cout << "  " << label << "\n";
+        print_latency("  cold", summarize_latency(all[0]));
+        print_latency("  warmed", summarize_latency(all[1]));
+        std::cout << std::fixed << std::setprecision(0) << "    mean of the first 10: " << mean(head[0][0])
+                  << " ns cold vs " << mean(head[0][1]) << " ns warmed; first 100: " << mean(head[1][0])
+                  << " vs " << mean(head[1][1]) << " ns\n" << std::defaultfloat;
+    };
+    report("Session open (warm_up() + reserve() vs nothing)", open_ns, open_head);
+    report("After a 500 us quiet period (keep_warm() on idle passes vs plain polling)", gap_ns, gap_head);
+
+    std::cout << std::fixed << std::setprecision(1) << "  warm_up(): " << warm_stats.warm_up_messages
+              << " shadow messages in " << warm_stats.warm_up_ns / 1e6 << " ms (script "
+              << warmer.script_length() << " messages/cycle, " << warm_stats.shadow_errors << " shadow errors)\n";
+    const BookWarmer::Stats& idle = warmer.get_stats();
+    std::cout << "  keep_warm(): " << idle.keep_warm_runs << " runs, "
+              << (idle.keep_warm_runs ? static_cast<double>(idle.keep_warm_ns) / idle.keep_warm_runs : 0.0)
+              << " ns each, " << idle.keep_warm_skipped << " idle calls inside the interval\n\n"
+              << std::defaultfloat;
+}
+
+// ============================================================================
+// Chunk Integrity (CRC32C)
+// ============================================================================
+
+struct IntegrityRun
+{
+    double ns = 0;
+    DataFabric::FIFOStats fabric;
+    OrderBook::ErrorStats errors;
+    size_t orders = 0;
+    uint64_t bid = 0;
+    uint64_t ask = 0;
+};
+
+// mode 0: no check; 1: fabric seals at write; 2: producer seals, then the
+// bytes in corrupt (if any) have one bit flipped on the way in
+static IntegrityRun run_integrity(const std::vector<std::vector<uint8_t>>& feed, int mode,
+                                  const std::vector<uint8_t>* corrupt = nullptr)
+{
+    IntegrityRun run;
+    DataFabric fabric;
+    OrderBook book(fabric);
+    fabric.set_integrity_check(mode == 1);
+    std::vector<uint8_t> wire;
+    auto start = Clock::now();
+    for (size_t i = 0; i < feed.size(); ++i)
+    {
+        if (mode == 2)
+        {
+            uint32_t crc = Crc32c::compute(feed[i].data(), feed[i].size());
+            if (corrupt && (*corrupt)[i])
+            {
+                wire = feed[i];
+                wire[(i * 7) % wire.size()] ^= static_cast<uint8_t>(1u << (i % 8));
+                fabric.write_chunk(wire, crc);
+            }
+            else
+            {
+                fabric.write_chunk(feed[i], crc);
+            }
+        }
+        else
+        {
+            fabric.write_chunk(feed[i]);
+        }
+        book.process();
+    }
+    run.ns = elapsed_ns(start, Clock::now());
+    run.fabric = fabric.get_stats();
+    run.errors = book.get_error_stats();
+    run.orders = book.get_order_count();
+    uint64_t qty;
+    book.get_best_bid(run.bid, qty);
+    book.get_best_ask(run.ask, qty);
+    return run;
+}
+
+static void bench_crc32c()
+{
+    constexpr size_t MESSAGES = 1000000;
+    std::cout << "--- Chunk Integrity (CRC32C, compute() = " << Crc32c::isa() << ") ---\n";
+
+    // Raw checksum speed on a message-sized and a FIFO-sized buffer
+    std::vector<uint8_t> bytes(4096);
+    FastRng rng(41);
+    for (auto& b : bytes) b = static_cast<uint8_t>(rng.next());
+    for (size_t length : {size_t(36), size_t(4096)})
+    {
+        size_t reps = (64u << 20) / length;
+        double best[2] = {1e30, 1e30};
+        uint32_t sums[2] = {};
+        for (int round = 0; round < 3; ++round)
+        {
+            for (int path = 0; path < 2; ++path)
+            {
+                uint32_t sum = 0;
+                auto start = Clock::now();
+                for (size_t r = 0; r < reps; ++r)
+                {
+                    const uint8_t* p = bytes.data() + (r & 7);
+                    size_t n = std::min(length, bytes.size() - 8);
+                    sum ^= path ? Crc32c::compute(p, n, sum) : Crc32c::compute_table(p, n, sum);
+                }
+                best[path] = std::min(best[path], elapsed_ns(start, Clock::now()));
+                sums[path] = sum;
+            }
+        }
+        size_t n = std::min(length, bytes.size() - 8);
+        std::cout << std::fixed << std::setprecision(1) << "  " << std::setw(4) << n << "-byte buffer: table "
+                  << best[0] / reps << " ns (" << n * reps / best[0] << " GB/s), compute() " << best[1] / reps
+                  << " ns (" << n * reps / best[1] << " GB/s)" << (sums[0] == sums[1] ? "" : "  MISMATCH")
+                  << "\n" << std::defaultfloat;
+    }
+
+    // Fabric alone, write + read of message-sized chunks
+    auto feed = generate_feed(MESSAGES, 42);
+    double fabric_best[2] = {1e30, 1e30};
+    for (int round = 0; round < 6; ++round)
+    {
+        int sealed = round % 2;
+        DataFabric fabric;
+        fabric.set_integrity_check(sealed != 0);
+        DataFabric::Chunk out;
+        size_t bytes_read = 0;
+        auto start = Clock::now();
+        for (const auto& msg : feed)
+        {
+            fabric.write_chunk(msg);
+            fabric.read_chunk(out);
+            bytes_read += out.size();
+        }
+        fabric_best[sealed] = std::min(fabric_best[sealed], elapsed_ns(start, Clock::now()));
+        if (bytes_read != fabric.get_stats().total_bytes_read) std::cout << "  fabric byte count MISMATCH\n";
+    }
+    print_row("DataFabric write+read", fabric_best[0], MESSAGES);
+    print_row("DataFabric write+read, sealed", fabric_best[1], MESSAGES);
+
+    // Full parse path, one message per chunk: the worst ratio of checksum to work
+    IntegrityRun best[3];
+    for (int round = 0; round < 6; ++round)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            int mode = (round + k) % 3;  // Rotated: whichever runs first in a round pays for the last teardown
+            IntegrityRun run = run_integrity(feed, mode);
+            if (round < 3 || run.ns < best[mode].ns) best[mode] = run;
+        }
+    }
+    print_row("No integrity check", best[0].ns, MESSAGES);
+    print_row("Fabric seals at write_chunk", best[1].ns, MESSAGES);
+    print_row("Producer seals (CRC passed in)", best[2].ns, MESSAGES);
+    double overhead = (fabric_best[1] - fabric_best[0]) / MESSAGES;
+    std::cout << "  Overhead per message: " << std::fixed << std::setprecision(1) << overhead
+              << " ns in the fabric alone, " << 100.0 * overhead * MESSAGES / best[0].ns
+              << "% of the parse path; " << best[2].fabric.crc_checked << " chunks verified\n"
+              << std::defaultfloat;
+
+    // One chunk in 1,000 gets a bit flipped after sealing
+    std::vector<uint8_t> corrupt(MESSAGES, 0);
+    size_t injected = 0;
+    for (size_t i = 0; i < MESSAGES; ++i)
+    {
+        if (rng.below(1000) == 0)
+        {
+            corrupt[i] = 1;
+            ++injected;
+        }
+    }
+    IntegrityRun checked = run_integrity(feed, 2, &corrupt);
+
+    // Same flips with nothing checking: the parser's type guess is all that is left
+    auto damaged = feed;
+    for (size_t i = 0; i < MESSAGES; ++i)
+    {
+        if (corrupt[i]) damaged[i][(i * 7) % damaged[i].size()] ^= static_cast<uint8_t>(1u << (i % 8));
+    }
+    std::streambuf* cerr_buf = std::cerr.rdbuf(nullptr);  // The parser logs every bad byte
+    IntegrityRun unchecked = run_integrity(damaged, 0);
+    std::cerr.rdbuf(cerr_buf);
+
+    auto errors = [](const IntegrityRun& r) {
+        return r.errors.unknown_message_types + r.errors.invalid_operations + r.errors.buffer_overflows;
+    };
+    std::cout << "  Corruption: " << injected << " chunks flipped after sealing, " << checked.fabric.crc_failures
+              << " quarantined (" << checked.fabric.quarantined_bytes << " bytes)\n";
+    std::cout << "    unchecked: " << errors(unchecked) << " parse/book errors, " << unchecked.orders
+              << " orders, touch " << unchecked.bid << "/" << unchecked.ask << "\n";
+    std::cout << "    checked:   " << errors(checked) << " parse/book errors, " << checked.orders
+              << " orders, touch " << checked.bid << "/" << checked.ask << "  (clean run: " << best[0].orders
+              << " orders, touch " << best[0].bid << "/" << best[0].ask << ")\n\n";
+}
+
+int main(int argc, char** argv)
+{
+    const std::vector<std::pair<std::string, std::function<void()>>> sections = {
+        {"event_cache", bench_event_cache},
+        {"capture_reader", bench_capture_reader},
+        {"scheduler", bench_scheduler},
+        {"sharded_rebalance", bench_sharded_rebalance},
+        {"metrics", bench_metrics},
+        {"fabric_telemetry", bench_fabric_telemetry},
+        {"adaptive_consumer", bench_adaptive_consumer},
+        {"mpsc_fabric", bench_mpsc_fabric},
+        {"concurrent_reads", bench_concurrent_reads},
+        {"tick_grid", bench_tick_grid},
+        {"mpid_attribution", bench_mpid_attribution},
+        {"subscription_filter", bench_subscription_filter},
+        {"batch_listener", bench_batch_listener},
+        {"book_layout", bench_book_layout},
+        {"trigger_index", bench_trigger_index},
+        {"order_index", bench_order_index},
+        {"level_retention", bench_level_retention},
+        {"tick_to_trade", bench_tick_to_trade},
+        {"pre_trade_risk", bench_pre_trade_risk},
+        {"portfolio", bench_portfolio},
+        {"inav", bench_inav},
+        {"partitions", bench_partitions},
+        {"symbol_table", bench_symbol_table},
+        {"warmup", bench_warmup},
+        {"crc32c", bench_crc32c},
+    };
+
+    std::cout << "=== OrderBook Benchmarks ===\n\n";
+    for (const auto& [name, run] : sections)
+    {
+        bool selected = (argc <= 1);
+        for (int i = 1; i < argc && !selected; ++i)
+        {
+            selected = (name == argv[i]);
+        }
+        if (selected) run();
+    }
+    return 0;
+}
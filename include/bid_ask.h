@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <map>
+#include <memory>
 #include <vector>
 #include <tuple>
 
@@ -11,13 +14,16 @@
 
 enum class Side : uint8_t { Bid = 0, Ask = 1 };
 
-// Forward declaration
+// Forward declarations
 struct OrderNode;
+class TriggerIndex;
 
 // Shared order table entry
+// Prices are 32-bit keys: the raw ITCH price, or a tick index when the
+// owning OrderBook normalizes prices with a TickGrid
 struct OrderInfo {
     Side side;
-    uint64_t price;
+    uint32_t price;
     uint64_t quantity;
     OrderNode* node;
 
@@ -38,28 +44,115 @@ struct OrderNode {
 
 // One price level: FIFO + aggregate qty
 struct PriceLevel {
-    uint64_t price;
+    uint32_t price;
     uint64_t total_qty;
     OrderNode* head;
     OrderNode* tail;
 
-    PriceLevel(uint64_t p = 0)
+    PriceLevel(uint32_t p = 0)
         : price(p), total_qty(0), head(nullptr), tail(nullptr) {}
 };
 
+// Free-list allocator for FIFO nodes; slabs grow geometrically so thin
+// books stay small. Node addresses are stable for the pool's lifetime.
+class OrderNodePool {
+public:
+    OrderNode* allocate(uint64_t order_id, uint64_t qty);
+    void release(OrderNode* node);
+    void reserve(size_t nodes);  // Carve slabs up front (session warm-up)
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    void grow(size_t count);
+
+    static constexpr size_t FIRST_SLAB = 16;
+    static constexpr size_t MAX_SLAB = 4096;
+
+    std::vector<std::unique_ptr<OrderNode[]>> slabs_;
+    OrderNode* free_ = nullptr;  // Linked through next
+    size_t capacity_ = 0;
+};
+
+// ----------------------------
+// Level layout switching
+// ----------------------------
+// Thin: levels in a sorted vector, best level last - no allocation per
+//       level, and touch-side inserts/erases move few elements.
+// Thick: levels in an ordered map - O(log P) anywhere in a deep book.
+// Ladder: thick for dense keys (tick indices, see setDenseKeys) - a vector
+//       slot per key from base_, O(1) to any level. A side whose levels
+//       spread over more than ladder_span keys spills to the map instead.
+// A side starts thin, promotes once it holds more than promote_levels levels
+// and demotes once it drops below demote_levels (hysteresis). FIFO nodes
+// live in the side's pool in every layout, so OrderInfo::node pointers
+// survive a switch.
+enum class BookLayout : uint8_t { Thin = 0, Thick = 1, Ladder = 2 };
+
+struct LayoutConfig {
+    size_t promote_levels = 24;  // Thin -> thick above this many levels
+    size_t demote_levels = 8;    // Thick -> thin below this many levels
+    size_t ladder_span = 4096;   // Widest key range kept as a ladder, 32 bytes per key (0 = map only)
+};
+
+struct LayoutStats {
+    size_t promotions = 0;
+    size_t demotions = 0;
+    size_t thick_sides = 0;    // Sides currently thick (map or ladder)
+    size_t ladder_sides = 0;   // Of those, sides on a ladder
+    size_t ladder_spills = 0;  // Ladders moved to the map when levels spread past ladder_span
+};
+
+// ----------------------------
+// Empty-level retention
+// ----------------------------
+// Near the touch a level's last order often leaves moments before the next
+// one arrives. Instead of erasing it (a map node free + alloc when thick, a
+// vector shift when thin) the side keeps up to max_empty empty levels among
+// its best max_depth stored levels, and revives them in place. Retained
+// levels are reclaimed oldest-first once max_age side operations old or when
+// a newer one needs the slot. Empty levels are invisible to queries: best
+// price, depth, hasLevel and level counts skip them. max_empty = 0 erases
+// immediately. A ladder never frees a slot, so it retains nothing.
+struct LevelRetention {
+    size_t max_empty = 8;     // Empty levels held per side
+    size_t max_depth = 8;     // Only retain among the best max_depth levels
+    uint64_t max_age = 4096;  // Side operations before a retained level is reclaimed
+};
+
+struct RetentionStats {
+    size_t created = 0;    // Levels inserted into storage
+    size_t revived = 0;    // Empty levels reused instead of created
+    size_t reclaimed = 0;  // Retained levels erased later (age / slot pressure)
+    size_t held = 0;       // Empty levels currently retained
+};
+
 // ----------------------------
 // BookSide: one side of book
 // ----------------------------
 class BookSide {
 public:
-    using LevelMap = std::map<uint64_t, PriceLevel>;
+    using LevelMap = std::map<uint32_t, PriceLevel>;
 
     explicit BookSide(Side s) : side_(s) {}
 
+    void setLayoutConfig(const LayoutConfig& config);
+    BookLayout layout() const { return layout_; }
+    size_t levelCount() const { return live_; }  // Non-empty levels
+    size_t promotions() const { return promotions_; }
+    size_t demotions() const { return demotions_; }
+    size_t spills() const { return spills_; }
+
+    // Keys are dense tick indices: promote to a ladder instead of the map
+    void setDenseKeys(bool dense) { dense_ = dense; }
+
+    void setRetention(const LevelRetention& retention);
+    const RetentionStats& retentionStats() const { return reuse_; }
+
     // return pointer to FIFO node
-    OrderNode* addOrder(uint64_t order_id, uint64_t price, uint64_t qty);
+    OrderNode* addOrder(uint64_t order_id, uint32_t price, uint64_t qty);
 
-    void cancelOrder(OrderNode* node, uint64_t price);
+    void cancelOrder(OrderNode* node, uint32_t price);
 
     // Match an aggressive order against this side's best prices
     uint64_t matchAtBest(
@@ -67,20 +160,113 @@ public:
         std::vector<std::tuple<uint64_t,uint64_t,uint64_t>>& trades
     );
 
-    bool empty() const { return levels_.empty(); }
+    bool empty() const { return live_ == 0; }
+    bool hasLevel(uint32_t price) const;
+    uint64_t levelQuantity(uint32_t price) const;  // 0 if no level
 
     bool bestPrice(uint64_t& price_out, uint64_t& qty_out) const;
 
     // Get top-K (price, total_qty) depth for this side
     std::vector<std::pair<uint64_t,uint64_t>> topK(std::size_t k) const;
 
-    void updateQuantity(OrderNode* node, uint64_t price, uint64_t new_qty);
+    void updateQuantity(OrderNode* node, uint32_t price, uint64_t new_qty);
+
+    // Pre-allocate FIFO nodes and thin-layout level slots
+    void reserve(size_t orders, size_t levels) {
+        pool_.reserve(orders);
+        thin_.reserve(levels);
+    }
+
+    // Every stored level (retained empty ones included), in no particular
+    // order; walk level.head -> next for the queue in time priority
+    template <typename Fn>
+    void forEachLevel(Fn&& fn) const {
+        if (layout_ == BookLayout::Thin) {
+            for (const PriceLevel& level : thin_) fn(level);
+        } else if (layout_ == BookLayout::Ladder) {
+            for (const PriceLevel& level : ladder_) {
+                if (level.head) fn(level);
+            }
+        } else {
+            for (const auto& entry : levels_) fn(entry.second);
+        }
+    }
 
 private:
     Side side_;
-    LevelMap levels_;
+    BookLayout layout_ = BookLayout::Thin;
+    LayoutConfig config_;
+    std::vector<PriceLevel> thin_;    // Thin layout, worst..best
+    LevelMap levels_;                 // Thick layout
+    std::vector<PriceLevel> ladder_;  // Ladder layout, slot i holds key base_ + i
+    uint32_t base_ = 0;
+    uint32_t bestKey_ = 0;            // Ladder: best non-empty level while live_ > 0
+    bool dense_ = false;              // Keys are tick indices
+    OrderNodePool pool_;
+    size_t promotions_ = 0;
+    size_t demotions_ = 0;
+    size_t spills_ = 0;
+
+    size_t live_ = 0;  // Levels with at least one order
+    LevelRetention retention_;
+    std::vector<std::pair<uint32_t, uint64_t>> retained_;  // (price, ops_ when emptied), oldest first
+    uint64_t ops_ = 0;
+    RetentionStats reuse_;
+
+    size_t storedLevels() const {
+        if (layout_ == BookLayout::Ladder) return live_;
+        return (layout_ == BookLayout::Thin) ? thin_.size() : levels_.size();
+    }
+    // True if a is a better price than b on this side
+    bool better(uint32_t a, uint32_t b) const { return (side_ == Side::Bid) ? a > b : a < b; }
+    // Thin: index of the first level better than price (scans from the touch)
+    size_t thinSlot(uint32_t price) const;
+
+    PriceLevel* findLevel(uint32_t price);
+    const PriceLevel* bestLevel() const;  // Best non-empty level, or null
+    PriceLevel& getOrCreateLevel(uint32_t price);
+    void eraseLevel(uint32_t price);
+    void unlink(PriceLevel& level, OrderNode* node);
 
-    PriceLevel& getOrCreateLevel(uint64_t price);
+    // The level at price just lost its last order: retain or erase it
+    void levelEmptied(uint32_t price);
+    void revive(uint32_t price);  // An empty retained level takes an order again
+    bool withinDepth(uint32_t price) const;
+    void reclaimOldest();
+    // One side operation: reclaim the oldest retained level once it ages out
+    void age() {
+        ++ops_;
+        if (!retained_.empty() && ops_ - retained_.front().second > retention_.max_age) reclaimOldest();
+    }
+
+    void promote();
+    void demote();
+    // Ladder: slot for price, or null outside the window
+    PriceLevel* ladderSlot(uint32_t price) {
+        uint32_t i = price - base_;
+        return (i < ladder_.size()) ? &ladder_[i] : nullptr;
+    }
+    const PriceLevel* ladderSlot(uint32_t price) const {
+        uint32_t i = price - base_;
+        return (i < ladder_.size()) ? &ladder_[i] : nullptr;
+    }
+    bool fitLadder(uint32_t lo, uint32_t hi);  // Re-window over [lo, hi]; false if wider than ladder_span
+    bool growLadder(uint32_t price);           // Widen the window to take price
+    void spill();                              // Ladder -> map
+};
+
+// Best bid/ask in engine keys; a zero quantity means that side is empty
+struct TopOfBook {
+    uint64_t bid_price = 0;
+    uint64_t bid_qty = 0;
+    uint64_t ask_price = 0;
+    uint64_t ask_qty = 0;
+
+    bool operator==(const TopOfBook& o) const {
+        return bid_price == o.bid_price && bid_qty == o.bid_qty &&
+               ask_price == o.ask_price && ask_qty == o.ask_qty;
+    }
+    bool operator!=(const TopOfBook& o) const { return !(*this == o); }
 };
 
 // ----------------------------
@@ -88,12 +274,17 @@ private:
 // ----------------------------
 class OrderBookEngine {
 public:
-    OrderBookEngine()
-        : bids_(Side::Bid), asks_(Side::Ask) {}
+    using BboCallback = std::function<void(const TopOfBook&)>;
+
+    OrderBookEngine();
+    ~OrderBookEngine();
+
+    OrderBookEngine(const OrderBookEngine&) = delete;
+    OrderBookEngine& operator=(const OrderBookEngine&) = delete;
 
     void onAdd(uint64_t order_id,
                Side side,
-               uint64_t price,
+               uint32_t price,
                uint64_t qty,
                OrderInfo& info_out);
 
@@ -106,13 +297,94 @@ public:
                           uint64_t qty,
                           std::vector<std::tuple<uint64_t,uint64_t,uint64_t>>& trades);
 
+    bool hasLevel(Side side, uint32_t price) const {
+        return (side == Side::Bid) ? bids_.hasLevel(price) : asks_.hasLevel(price);
+    }
+
     bool getBestBid(uint64_t& price_out, uint64_t& qty_out) const;
     bool getBestAsk(uint64_t& price_out, uint64_t& qty_out) const;
+
+    void setLayoutConfig(const LayoutConfig& config) {
+        bids_.setLayoutConfig(config);
+        asks_.setLayoutConfig(config);
+    }
+    void setDenseKeys(bool dense) {
+        bids_.setDenseKeys(dense);
+        asks_.setDenseKeys(dense);
+    }
+    BookLayout layout(Side side) const {
+        return (side == Side::Bid) ? bids_.layout() : asks_.layout();
+    }
+    LayoutStats getLayoutStats() const;
+
+    void setRetention(const LevelRetention& retention) {
+        bids_.setRetention(retention);
+        asks_.setRetention(retention);
+    }
+    RetentionStats getRetentionStats() const;
+
+    template <typename Fn>
+    void forEachLevel(Side side, Fn&& fn) const {
+        if (side == Side::Bid) bids_.forEachLevel(fn);
+        else asks_.forEachLevel(fn);
+    }
+
+    // Per side: FIFO nodes for orders, level slots for levels
+    void reserve(size_t orders, size_t levels) {
+        bids_.reserve(orders, levels);
+        asks_.reserve(orders, levels);
+    }
+
+    uint64_t getLevelQuantity(Side side, uint32_t price) const {
+        return (side == Side::Bid) ? bids_.levelQuantity(price) : asks_.levelQuantity(price);
+    }
     
     std::vector<std::pair<uint64_t,uint64_t>> getTopKBids(std::size_t k) const;
     std::vector<std::pair<uint64_t,uint64_t>> getTopKAsks(std::size_t k) const;
 
+    // ---- Triggers and BBO change detection ----
+    // Inactive (no extra work per update) until the first trigger or BBO
+    // callback. After each update the engine checks the level triggers at
+    // the touched prices, then - if the top of book changed - the best-price
+    // and spread triggers and the BBO callback. Best-price and spread
+    // triggers already satisfied at registration fire immediately.
+    TriggerIndex& triggers();  // Created on first use
+    const TriggerIndex* findTriggers() const { return triggers_.get(); }  // Null until then
+    uint32_t addBestPriceTrigger(Side side, uint32_t price, uint64_t tag = 0);
+    uint32_t addLevelSizeTrigger(Side side, uint32_t price, uint64_t below_qty, uint64_t tag = 0);
+    uint32_t addSpreadTrigger(int64_t above, uint64_t tag = 0);
+    bool removeTrigger(uint32_t id);
+
+    void setBboCallback(BboCallback cb);
+    const TopOfBook& getTopOfBook() const { return bbo_; }  // Maintained while active
+    size_t getBboChanges() const { return bboChanges_; }
+
+    // Group several updates (e.g. cancel + add of a replace) so triggers and
+    // the BBO callback see only the final state. Nests.
+    void beginUpdate() { ++batchDepth_; }
+    void endUpdate() {
+        if (--batchDepth_ == 0 && !touched_.empty()) evaluate();
+    }
+
 private:
     BookSide bids_;
     BookSide asks_;
+
+    // Trigger / BBO state
+    std::unique_ptr<TriggerIndex> triggers_;
+    BboCallback bboCallback_;
+    TopOfBook bbo_;
+    size_t bboChanges_ = 0;
+    bool watching_ = false;
+    int batchDepth_ = 0;
+    std::vector<std::pair<Side, uint32_t>> touched_;  // Levels changed since the last evaluate
+
+    void watch();
+    TopOfBook currentTop() const;
+    void touch(Side side, uint32_t price) {
+        if (!watching_) return;
+        touched_.emplace_back(side, price);
+        if (batchDepth_ == 0) evaluate();
+    }
+    void evaluate();
 };
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// ============================================================================
+// Capture Reader (raw ITCH capture file -> contiguous blocks for the parser)
+// ============================================================================
+//
+// Backends:
+//   Mmap        - map the whole file, hand out slices (page faults on cold data)
+//   PreadThread - background thread keeps queue_depth aligned reads ahead
+//   IoUring     - queue_depth aligned reads in flight via io_uring (Linux)
+//
+// PreadThread and IoUring use O_DIRECT when the filesystem allows it, so the
+// reads bypass the page cache and overlap with book processing. IoUring falls
+// back to PreadThread when the kernel refuses io_uring_setup.
+//
+// Usage:
+//   CaptureReader reader;
+//   reader.open("session.itch", {CaptureReader::Backend::IoUring});
+//   const uint8_t* data; size_t len;
+//   while (reader.next_block(data, len)) orderbook.process_bytes(data, len);
+
+class CaptureReader
+{
+   public:
+    enum class Backend : uint8_t { Mmap, PreadThread, IoUring };
+
+    struct Config
+    {
+        Backend backend = Backend::IoUring;
+        size_t block_size = 1 << 20;  // Bytes per read (rounded up to 4KB)
+        size_t queue_depth = 4;       // Reads kept in flight
+        bool direct_io = true;        // Request O_DIRECT (bypass page cache)
+    };
+
+    struct ReaderStats
+    {
+        Backend backend = Backend::Mmap;  // Backend actually in use
+        bool direct_io = false;           // O_DIRECT actually in effect
+        size_t blocks = 0;                // Blocks handed to the consumer
+        size_t bytes = 0;                 // Bytes handed to the consumer
+        size_t consumer_waits = 0;        // next_block() found data not yet loaded
+        uint64_t wait_ns = 0;             // Total time the consumer spent waiting
+    };
+
+    class Impl;
+
+    CaptureReader();
+    ~CaptureReader();
+
+    CaptureReader(const CaptureReader&) = delete;
+    CaptureReader& operator=(const CaptureReader&) = delete;
+
+    bool open(const std::string& path, const Config& config);
+    void close();
+
+    // Next block in file order; data stays valid until the next call
+    // Returns false at end of file or on I/O error
+    bool next_block(const uint8_t*& data, size_t& length);
+
+    size_t file_size() const;
+    const ReaderStats& get_stats() const { return stats_; }
+
+    static const char* backend_name(Backend backend);
+
+   private:
+    std::unique_ptr<Impl> impl_;
+    ReaderStats stats_;
+};
@@ -0,0 +1,84 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// ============================================================================
+// ConcurrentOrderView - lock-free order lookups for reader threads
+// ============================================================================
+//
+// A fixed-capacity mirror of the live orders (and their price levels) kept
+// by the processing thread, readable from any thread without locks.
+//
+// Layout: two open-addressing tables (orders by id, levels by side/price),
+// 32-byte slots each carrying a sequence counter (seqlock). The writer makes
+// a slot's counter odd, writes, then makes it even; readers retry a slot
+// whose counter was odd or changed under them. Erasing uses backward-shift
+// deletion, which moves slots, so erases also bump one table-wide counter
+// that readers check around each probe.
+//
+// An order's level is updated inside the order's own write window, so the
+// (order, level) pair a reader gets back is one the book actually passed
+// through. Reads retry only while a write to the same slot (or an erase) is
+// in progress.
+//
+// Capacity is fixed at construction - no rehash, no reclamation. Inserts
+// beyond 3/4 load are refused and counted.
+
+class ConcurrentOrderView
+{
+   public:
+    struct OrderSnapshot
+    {
+        uint64_t order_id = 0;
+        uint32_t price = 0;
+        uint32_t quantity = 0;
+        char side = 0;                // 'B' or 'S'
+        uint64_t level_quantity = 0;  // Total shares resting at (side, price)
+        uint32_t level_orders = 0;    // Orders resting at (side, price)
+    };
+
+    struct WriterStats
+    {
+        size_t orders = 0;             // Live orders mirrored
+        size_t levels = 0;             // Live price levels mirrored
+        size_t insert_failures = 0;    // Orders not mirrored (table at load limit)
+    };
+
+    explicit ConcurrentOrderView(size_t max_orders, size_t max_levels = 1 << 14);
+    ~ConcurrentOrderView();
+
+    ConcurrentOrderView(const ConcurrentOrderView&) = delete;
+    ConcurrentOrderView& operator=(const ConcurrentOrderView&) = delete;
+
+    // ---- Writer (processing thread) only ----
+    void on_add(uint64_t order_id, char side, uint32_t price, uint32_t quantity);
+    void on_reduce(uint64_t order_id, uint32_t remaining);  // Partial execute
+    void on_remove(uint64_t order_id);                      // Cancel / full execute / replaced
+    const WriterStats& get_writer_stats() const { return writer_stats_; }
+
+    // ---- Any thread ----
+    bool find(uint64_t order_id, OrderSnapshot& out) const;
+    bool find(uint64_t order_id, OrderSnapshot& out, size_t& retries) const;
+
+    size_t order_capacity() const;
+
+   private:
+    struct Slot;
+    class Table;
+
+    uint64_t level_key(char side, uint32_t price) const
+    {
+        return (static_cast<uint64_t>(price) << 1) | (side == 'S' ? 1 : 0);
+    }
+    void adjust_level(char side, uint32_t price, int64_t quantity_delta, int32_t order_delta);
+
+    std::unique_ptr<Table> orders_;  // key: order id, a: price << 32 | qty, b: side
+    std::unique_ptr<Table> levels_;  // key: price << 1 | side, a: total qty, b: order count
+
+    // Bumped (odd, then even) around every backward-shift erase in either table
+    alignas(64) std::atomic<uint64_t> structure_seq_{0};
+
+    WriterStats writer_stats_;
+};
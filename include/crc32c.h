@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+// ============================================================================
+// Crc32c - CRC-32C (Castagnoli) for chunk integrity checks
+// ============================================================================
+//
+// The polynomial the SSE4.2 crc32 instruction implements (iSCSI, ext4,
+// RFC 3720). compute() runs that instruction 8 bytes at a time when the
+// build targets SSE4.2 and falls back to a slicing-by-8 table otherwise;
+// both give the same result. A running CRC continues with seed = the
+// previous result. compute(nullptr, 0) = 0; "123456789" -> 0xE3069283.
+
+class Crc32c
+{
+   public:
+    static uint32_t compute(const uint8_t* data, size_t length, uint32_t seed = 0)
+    {
+#if defined(__SSE4_2__)
+        return compute_hw(data, length, seed);
+#else
+        return compute_table(data, length, seed);
+#endif
+    }
+
+    // Portable path, always available (and what compute() uses without SSE4.2)
+    static uint32_t compute_table(const uint8_t* data, size_t length, uint32_t seed = 0);
+
+    // Which path compute() compiled to: "sse4.2" or "table"
+    static const char* isa();
+
+   private:
+#if defined(__SSE4_2__)
+    static uint32_t compute_hw(const uint8_t* data, size_t length, uint32_t seed)
+    {
+        uint32_t crc = ~seed;
+#if defined(__x86_64__) || defined(_M_X64)
+        uint64_t crc64 = crc;
+        for (; length >= 8; data += 8, length -= 8)
+        {
+            uint64_t word;
+            std::memcpy(&word, data, sizeof(word));
+            crc64 = _mm_crc32_u64(crc64, word);
+        }
+        crc = static_cast<uint32_t>(crc64);
+#endif
+        for (; length >= 4; data += 4, length -= 4)
+        {
+            uint32_t word;
+            std::memcpy(&word, data, sizeof(word));
+            crc = _mm_crc32_u32(crc, word);
+        }
+        for (; length > 0; ++data, --length) crc = _mm_crc32_u8(crc, *data);
+        return ~crc;
+    }
+#endif
+};
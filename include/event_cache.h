@@ -0,0 +1,101 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "orderbook.h"
+
+// ============================================================================
+// Decoded Event Cache (pre-parsed replay for repeated experiments)
+// ============================================================================
+
+// Fixed-width decoded ITCH event - 48 bytes
+struct CachedEvent
+{
+    uint64_t order_id;
+    uint64_t new_order_id;  // 'U' only
+    uint64_t timestamp;
+    uint32_t price;
+    uint32_t quantity;
+    uint16_t locate;
+    char type;
+    char side;
+    uint32_t mpid;   // 'F' attribution, 0 otherwise
+    uint64_t stock;  // 'A'/'F' Stock field (SymbolTable::key), 0 otherwise - for OrderSymbols routing
+
+    static CachedEvent from_result(const ITCHParser::ParseResult& result)
+    {
+        CachedEvent ev;
+        ev.order_id = result.order_id;
+        ev.new_order_id = result.new_order_id;
+        ev.timestamp = result.timestamp;
+        ev.price = result.price;
+        ev.quantity = result.quantity;
+        ev.locate = result.locate;
+        ev.type = result.type;
+        ev.side = result.side;
+        ev.mpid = result.mpid;
+        ev.stock = result.stock;
+        return ev;
+    }
+
+    ITCHParser::ParseResult to_result() const
+    {
+        ITCHParser::ParseResult result{0, true, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+        result.type = type;
+        result.side = side;
+        result.timestamp = timestamp;
+        result.locate = locate;
+        result.order_id = order_id;
+        result.new_order_id = new_order_id;
+        result.price = price;
+        result.quantity = quantity;
+        result.mpid = mpid;
+        result.stock = stock;
+        return result;
+    }
+};
+
+static_assert(sizeof(CachedEvent) == 48, "CachedEvent must stay fixed-width");
+
+// Compact in-memory (or memory-mapped file) store of decoded events
+// Built by OrderBook on first replay (set_event_recorder), fed back through
+// OrderBook::replay() on later runs with no parse step
+class EventCache
+{
+   public:
+    EventCache() = default;
+    ~EventCache();
+
+    EventCache(const EventCache&) = delete;
+    EventCache& operator=(const EventCache&) = delete;
+
+    void reserve(size_t events) { events_.reserve(events); }
+    void append(const ITCHParser::ParseResult& result);
+    void clear();
+
+    const CachedEvent* data() const { return mapped_ ? mapped_ : events_.data(); }
+    size_t size() const { return mapped_ ? mapped_count_ : events_.size(); }
+    bool empty() const { return size() == 0; }
+
+    // Resident cost of the event records (excludes file header)
+    size_t memory_bytes() const { return size() * sizeof(CachedEvent); }
+    bool is_mapped() const { return mapped_ != nullptr; }
+
+    // Persist to disk so later processes can skip decoding entirely
+    bool save(const std::string& path) const;
+
+    // Load from disk - memory-maps the file read-only where supported,
+    // otherwise reads it into memory
+    bool load(const std::string& path);
+
+   private:
+    void unmap();
+
+    std::vector<CachedEvent> events_;
+    const CachedEvent* mapped_ = nullptr;  // Records inside a read-only mapping
+    size_t mapped_count_ = 0;
+    void* map_base_ = nullptr;
+    size_t map_length_ = 0;
+};
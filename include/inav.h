@@ -0,0 +1,117 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "bid_ask.h"
+
+// ============================================================================
+// InavCalculator - ETF fair value (iNAV) from constituent BBOs
+// ============================================================================
+//
+// Each basket is a creation unit: integer shares per constituent plus a cash
+// component, divided by the creation-unit size. Symbols are dense indices
+// (e.g. stock locate). A BBO change (on_bbo from the constituent book's BBO
+// callback) moves that symbol's mid and adds shares x move to every basket
+// holding it - O(1) per basket, however many constituents it has.
+//
+// Arithmetic is integer: marks are kept as bid + ask (twice the mid), so
+// values are exact while a basket's doubled value stays below 2^63 price
+// units. recompute() rebuilds every basket from the marks and corrects any
+// basket whose running value disagrees (e.g. after constituents changed);
+// call it on a timer.
+//
+// Each basket is published into its own cache line behind a sequence
+// counter (seqlock, as ConcurrentOrderView's slots): the writer makes it
+// odd, stores, makes it even; read() retries until it sees a stable even
+// counter. One writer thread; read() from any thread.
+
+class InavCalculator
+{
+   public:
+    struct Snapshot
+    {
+        int64_t value2 = 0;          // 2 x (constituent value + cash) per creation unit, price units
+        uint32_t creation_unit = 0;  // ETF shares per creation unit
+        uint32_t missing = 0;        // Constituents not yet quoted (excluded from value2)
+        uint64_t version = 0;        // Publishes of this basket so far
+
+        // Per ETF share in price units (1 = $0.0001), rounded half up
+        int64_t nav() const
+        {
+            if (creation_unit == 0) return 0;
+            int64_t cu2 = 2 * static_cast<int64_t>(creation_unit);
+            return (value2 + creation_unit) / cu2;
+        }
+    };
+
+    struct Stats
+    {
+        uint64_t bbo_updates = 0;  // Changes that moved a constituent's mid
+        uint64_t publishes = 0;
+        uint64_t recomputes = 0;
+        uint64_t corrections = 0;  // Baskets fixed by recompute()
+    };
+
+    explicit InavCalculator(size_t symbols, size_t max_baskets = 64);
+    ~InavCalculator();
+
+    InavCalculator(const InavCalculator&) = delete;
+    InavCalculator& operator=(const InavCalculator&) = delete;
+
+    // ---- Writer thread only ----
+    // Basket id, or UINT32_MAX once max_baskets exist. cash is price units
+    // per creation unit.
+    uint32_t add_basket(uint32_t creation_unit, int64_t cash = 0);
+    bool add_constituent(uint32_t basket, uint16_t symbol, int64_t shares);
+
+    // Mid of the book; a one-sided book marks to the side it has, an empty
+    // book keeps the last mark
+    void on_bbo(uint16_t symbol, const TopOfBook& top);
+
+    // Exact rebuild; returns the number of baskets corrected
+    size_t recompute();
+
+    const Stats& get_stats() const { return stats_; }
+    size_t baskets() const { return value2_.size(); }
+
+    // ---- Any thread ----
+    // False for an id add_basket() never returned
+    bool read(uint32_t basket, Snapshot& out) const;
+    bool read(uint32_t basket, Snapshot& out, size_t& retries) const;
+
+   private:
+    struct Slot;
+
+    struct Member
+    {
+        uint32_t basket;
+        int64_t shares;
+    };
+
+    void rebuild_members();
+    void publish(uint32_t basket);
+
+    size_t symbols_;
+    size_t max_baskets_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<uint32_t> published_baskets_{0};
+
+    // Writer state
+    std::vector<int64_t> mid2_;  // bid + ask per symbol, 0 = never quoted
+    std::vector<int64_t> value2_;
+    std::vector<int64_t> cash2_;
+    std::vector<uint32_t> creation_unit_;
+    std::vector<uint32_t> missing_;
+    std::vector<uint64_t> version_;
+
+    // Memberships grouped by symbol (CSR), rebuilt after constituents change
+    std::vector<uint32_t> member_begin_;  // symbols + 1 offsets into members_
+    std::vector<Member> members_;
+    std::vector<std::pair<uint16_t, Member>> added_;  // In add order
+    bool members_dirty_ = false;
+
+    Stats stats_;
+};
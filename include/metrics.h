@@ -0,0 +1,194 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// ============================================================================
+// Metrics Registry (per-thread counters, aggregated on read)
+// ============================================================================
+//
+// Counters and histograms live in per-thread slabs: each thread that records
+// a metric gets its own cache-line-aligned slab, so hot-path increments are a
+// plain load/store on a line no other thread writes. Readers sum the slabs.
+// Gauges are last-value cells, one cache line each.
+//
+// Export: write_prometheus() renders the Prometheus text format;
+// MetricsExporter serves it over local HTTP or dumps it to a file.
+
+class MetricsRegistry
+{
+   public:
+    static constexpr size_t MAX_COUNTERS = 256;
+    static constexpr size_t MAX_GAUGES = 64;
+    static constexpr size_t MAX_HISTOGRAMS = 32;
+    static constexpr size_t HISTOGRAM_BUCKETS = 64;  // log2 buckets
+
+    // Monotonic counter handle - cheap to copy, no-op when unbound
+    class Counter
+    {
+       public:
+        Counter() = default;
+        void inc(uint64_t n = 1) const;
+
+       private:
+        friend class MetricsRegistry;
+        Counter(MetricsRegistry* registry, uint32_t index) : registry_(registry), index_(index) {}
+        MetricsRegistry* registry_ = nullptr;
+        uint32_t index_ = 0;
+    };
+
+    // Last-value gauge handle
+    class Gauge
+    {
+       public:
+        Gauge() = default;
+        void set(int64_t value) const;
+        void add(int64_t delta) const;
+
+       private:
+        friend class MetricsRegistry;
+        Gauge(MetricsRegistry* registry, uint32_t index) : registry_(registry), index_(index) {}
+        MetricsRegistry* registry_ = nullptr;
+        uint32_t index_ = 0;
+    };
+
+    // Log2-bucketed histogram handle (e.g. latencies in ns)
+    class Histogram
+    {
+       public:
+        Histogram() = default;
+        void observe(uint64_t value) const;
+
+       private:
+        friend class MetricsRegistry;
+        Histogram(MetricsRegistry* registry, uint32_t index) : registry_(registry), index_(index) {}
+        MetricsRegistry* registry_ = nullptr;
+        uint32_t index_ = 0;
+    };
+
+    struct HistogramSnapshot
+    {
+        uint64_t buckets[HISTOGRAM_BUCKETS] = {};  // bucket b counts values <= 2^b - 1
+        uint64_t count = 0;
+        uint64_t sum = 0;
+    };
+
+    MetricsRegistry();
+    ~MetricsRegistry();
+
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    // Registration - labels are preformatted, e.g. "book=\"main\""
+    // Returns an unbound handle if the registry is full
+    Counter counter(const std::string& name, const std::string& help,
+                    const std::string& labels = "");
+    Gauge gauge(const std::string& name, const std::string& help, const std::string& labels = "");
+    Histogram histogram(const std::string& name, const std::string& help,
+                        const std::string& labels = "");
+
+    // Aggregated reads (any thread)
+    uint64_t read(const Counter& counter) const;
+    int64_t read(const Gauge& gauge) const;
+    HistogramSnapshot read(const Histogram& histogram) const;
+
+    // Prometheus text exposition format (version 0.0.4)
+    void write_prometheus(std::ostream& os) const;
+
+    // Write to path via a temporary file + rename so scrapers never see a partial file
+    bool write_to_file(const std::string& path) const;
+
+    size_t thread_slab_count() const;
+
+    // Log2 bucket index: 0 for 0, otherwise floor(log2(v)) + 1
+    static size_t bucket_for(uint64_t value)
+    {
+        if (value == 0) return 0;
+#ifdef _MSC_VER
+        unsigned long msb;
+        _BitScanReverse64(&msb, value);
+        size_t bucket = static_cast<size_t>(msb) + 1;
+#else
+        size_t bucket = 64 - static_cast<size_t>(__builtin_clzll(value));
+#endif
+        return bucket < HISTOGRAM_BUCKETS ? bucket : HISTOGRAM_BUCKETS - 1;
+    }
+
+   private:
+    struct ThreadSlab;
+    struct GaugeCell;
+    struct MetricInfo
+    {
+        std::string name;
+        std::string help;
+        std::string labels;
+    };
+
+    ThreadSlab& local_slab();
+    ThreadSlab& register_thread();
+
+    const uint64_t id_;  // Process-unique, keys the thread-local slab cache
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadSlab>> slabs_;
+    // Owner of each slab, so a thread evicted from the slab cache finds its
+    // own slab again. A thread that reuses an exited thread's id takes over
+    // its slab - still a single writer, and the counts are kept.
+    std::unordered_map<std::thread::id, ThreadSlab*> thread_slabs_;
+    std::unique_ptr<GaugeCell[]> gauges_;
+    std::vector<MetricInfo> counter_info_;
+    std::vector<MetricInfo> gauge_info_;
+    std::vector<MetricInfo> histogram_info_;
+};
+
+// ============================================================================
+// MetricsExporter (local HTTP endpoint or periodic file dump)
+// ============================================================================
+
+class MetricsExporter
+{
+   public:
+    explicit MetricsExporter(const MetricsRegistry& registry) : registry_(registry) {}
+    ~MetricsExporter() { stop(); }
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    // A scrape client gets this long to send its request and to take the
+    // response; a silent or stuck one is dropped instead of stalling the
+    // exporter (and stop())
+    static constexpr int CLIENT_TIMEOUT_MS = 1000;
+
+    // Serve GET /metrics on bind_address:port (port 0 picks a free port)
+    bool start_http(uint16_t port, const std::string& bind_address = "127.0.0.1");
+
+    // Rewrite path every interval
+    bool start_file(const std::string& path, std::chrono::milliseconds interval);
+
+    void stop();
+
+    uint16_t http_port() const { return port_; }
+    uint64_t scrapes() const { return scrapes_.load(std::memory_order_relaxed); }
+
+   private:
+    void serve_loop();
+    void file_loop(std::string path, std::chrono::milliseconds interval);
+
+    const MetricsRegistry& registry_;
+    std::thread thread_;
+    std::atomic<bool> stop_{false};
+    std::atomic<uint64_t> scrapes_{0};
+    int listen_fd_ = -1;
+    uint16_t port_ = 0;
+};
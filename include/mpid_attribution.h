@@ -0,0 +1,69 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bid_ask.h"
+
+// ============================================================================
+// MpidAttribution - per-MPID liquidity per side and price level
+// ============================================================================
+//
+// Fed by OrderBook for orders that arrived as 'F' (Add with MPID
+// Attribution). MPIDs are interned into small ids (0 = unattributed). Each
+// level keeps its MPID shares sorted by quantity, largest first, so the
+// top-N at a level is a prefix copy; an update moves one entry a few places.
+//
+// A level's setter is the MPID of the order that created the price level in
+// the book (0 if that order was anonymous). It stays while any order,
+// attributed or not, rests at the level; OrderBook calls on_level_removed()
+// once the book level empties.
+
+class MpidAttribution
+{
+   public:
+    static constexpr uint16_t NONE = 0;
+    static constexpr size_t MAX_MPIDS = 65535;
+
+    struct MpidShare
+    {
+        uint16_t mpid = NONE;
+        uint32_t orders = 0;
+        uint64_t quantity = 0;
+    };
+
+    // Interned id for a wire MPID code; NONE if the table is full
+    uint16_t intern(uint32_t code);
+    uint32_t code(uint16_t mpid) const { return mpid < codes_.size() ? codes_[mpid] : 0; }
+    std::string name(uint16_t mpid) const;  // e.g. "GSCO"; "" for NONE
+    size_t mpid_count() const { return codes_.size() - 1; }
+
+    // creates_level: the order opened this price level in the book
+    void on_add(uint16_t mpid, Side side, uint32_t price, uint64_t quantity, bool creates_level);
+    void on_reduce(uint16_t mpid, Side side, uint32_t price, uint64_t quantity, bool order_removed);
+    void on_level_removed(Side side, uint32_t price) { levels_.erase(key(side, price)); }
+
+    // Largest n MPIDs at (side, price), in order; returns how many were written
+    size_t top(Side side, uint32_t price, size_t n, MpidShare* out) const;
+    uint16_t setter(Side side, uint32_t price) const;
+
+    size_t level_count() const { return levels_.size(); }
+
+   private:
+    struct Level
+    {
+        uint16_t setter = NONE;
+        std::vector<MpidShare> shares;  // Sorted by quantity, descending
+    };
+
+    static uint64_t key(Side side, uint32_t price)
+    {
+        return (static_cast<uint64_t>(price) << 1) | static_cast<uint64_t>(side);
+    }
+
+    std::unordered_map<uint64_t, Level> levels_;
+    std::unordered_map<uint32_t, uint16_t> ids_;
+    std::vector<uint32_t> codes_{0};  // Index 0 reserved for NONE
+};
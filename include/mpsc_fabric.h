@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "orderbook.h"
+#include "spsc_ring.h"
+
+// ============================================================================
+// MpscFabric - several feed handlers feeding one book thread
+// ============================================================================
+//
+// One SPSC lane per producer, polled round-robin by the single consumer, so
+// producers never contend with each other. Each lane has its own byte-depth
+// backpressure (same TREADY semantics as DataFabric) and its own statistics.
+//
+// Lanes interleave at chunk granularity: a chunk must hold whole ITCH
+// messages (one or more), as multicast packets do. The consumer hands each
+// chunk to OrderBook::process_bytes().
+
+class MpscFabric
+{
+   public:
+    using Chunk = DataFabric::Chunk;
+
+    struct Config
+    {
+        size_t producers = 2;
+        size_t lane_depth_bytes = DataFabric::DEFAULT_FIFO_DEPTH;  // Per-lane FIFO depth
+        size_t lane_slots = 1024;                                  // Max chunks in flight per lane
+    };
+
+    // Per-producer flow control statistics (snapshot; exact once quiescent)
+    struct LaneStats
+    {
+        size_t chunks_written = 0;
+        size_t chunks_read = 0;
+        size_t backpressure_events = 0;
+        size_t total_bytes_written = 0;
+        size_t total_bytes_dropped = 0;
+        size_t total_bytes_read = 0;
+        size_t max_depth_reached = 0;
+    };
+
+    MpscFabric();
+    explicit MpscFabric(const Config& config);
+    ~MpscFabric();
+
+    MpscFabric(const MpscFabric&) = delete;
+    MpscFabric& operator=(const MpscFabric&) = delete;
+
+    // Producer side - call only from the thread that owns lane `producer`
+    // Returns false if that lane is full (backpressure asserted)
+    bool write_chunk(size_t producer, const Chunk& chunk);
+
+    // Consumer side - next chunk in round-robin lane order
+    bool read_chunk(Chunk& out);
+    bool read_chunk(Chunk& out, size_t& producer_out);
+
+    // Approximate from the producer threads, exact from the consumer once they stop
+    bool empty() const;
+    size_t depth_bytes(size_t producer) const;
+
+    size_t producer_count() const { return lanes_.size(); }
+    LaneStats get_lane_stats(size_t producer) const;
+    LaneStats get_total_stats() const;
+
+   private:
+    struct Lane;
+
+    std::vector<std::unique_ptr<Lane>> lanes_;
+    size_t lane_depth_bytes_;
+    size_t cursor_ = 0;  // Consumer-owned round-robin position
+};
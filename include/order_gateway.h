@@ -0,0 +1,147 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ouch.h"
+
+// ============================================================================
+// Order gateway - OUCH transports and a local exchange stand-in
+// ============================================================================
+//
+// The strategy side encodes with OuchEncoder and hands bytes to an
+// OrderTransport:
+//   ShmOrderRing        - SPSC ring of fixed frames in a MAP_SHARED mapping;
+//                         usable across fork(), no syscalls per order
+//   LoopbackOrderSession - SoupBinTCP Unsequenced Data packets over TCP
+//                         (TCP_NODELAY); no login or heartbeats
+// LocalExchange drains either on its own thread, decodes OUCH and reports
+// each message with its steady_clock receive time, so a harness can measure
+// packet-in to order-out latency. POSIX only; on Windows the transports
+// report invalid and listen() fails.
+
+class OrderTransport
+{
+   public:
+    virtual ~OrderTransport() = default;
+
+    // One complete OUCH message; false if it could not be handed off
+    virtual bool send(const uint8_t* data, size_t length) = 0;
+};
+
+class ShmOrderRing : public OrderTransport
+{
+   public:
+    static constexpr size_t FRAME_SIZE = 64;  // 2-byte length + payload
+    static constexpr size_t MAX_PAYLOAD = FRAME_SIZE - 2;
+
+    explicit ShmOrderRing(size_t frames = 1024);  // Rounded up to a power of two
+    ~ShmOrderRing() override;
+
+    ShmOrderRing(const ShmOrderRing&) = delete;
+    ShmOrderRing& operator=(const ShmOrderRing&) = delete;
+
+    bool valid() const { return header_ != nullptr; }
+
+    // Producer: false when full or the message exceeds MAX_PAYLOAD
+    bool send(const uint8_t* data, size_t length) override;
+
+    // Consumer: copies one message into out (MAX_PAYLOAD bytes); 0 if empty
+    size_t receive(uint8_t* out);
+
+    uint64_t full_events() const { return full_events_; }
+
+   private:
+    struct Header
+    {
+        alignas(64) std::atomic<uint64_t> head;  // Consumer-owned
+        alignas(64) std::atomic<uint64_t> tail;  // Producer-owned
+    };
+
+    void* mapping_ = nullptr;
+    size_t mapping_bytes_ = 0;
+    Header* header_ = nullptr;
+    uint8_t* frames_ = nullptr;
+    size_t mask_ = 0;
+    uint64_t head_cache_ = 0;  // Producer's view of head
+    uint64_t tail_cache_ = 0;  // Consumer's view of tail
+    uint64_t full_events_ = 0;
+};
+
+class LoopbackOrderSession : public OrderTransport
+{
+   public:
+    LoopbackOrderSession() = default;
+    ~LoopbackOrderSession() override { close(); }
+
+    LoopbackOrderSession(const LoopbackOrderSession&) = delete;
+    LoopbackOrderSession& operator=(const LoopbackOrderSession&) = delete;
+
+    bool connect(uint16_t port, const std::string& host = "127.0.0.1");
+    void close();
+    bool connected() const { return fd_ >= 0; }
+
+    // Frames the message as one SoupBinTCP 'U' packet
+    bool send(const uint8_t* data, size_t length) override;
+
+    uint64_t send_errors() const { return send_errors_; }
+
+   private:
+    int fd_ = -1;
+    uint64_t send_errors_ = 0;
+};
+
+class LocalExchange
+{
+   public:
+    // Runs on the exchange thread; recv_ns is steady_clock time since epoch
+    using OrderCallback = std::function<void(const OuchMessage& msg, uint64_t recv_ns)>;
+
+    struct Stats
+    {
+        uint64_t enters = 0;
+        uint64_t replaces = 0;
+        uint64_t cancels = 0;
+        uint64_t malformed = 0;  // Unknown type or bad framing
+    };
+
+    explicit LocalExchange(OrderCallback cb) : callback_(std::move(cb)) {}
+    ~LocalExchange() { stop(); }
+
+    LocalExchange(const LocalExchange&) = delete;
+    LocalExchange& operator=(const LocalExchange&) = delete;
+
+    // Configure before start(): accept one SoupBinTCP session (port 0 picks
+    // a free port) and/or drain a shared-memory ring
+    bool listen(uint16_t port = 0, const std::string& bind_address = "127.0.0.1");
+    uint16_t port() const { return port_; }
+    void attach(ShmOrderRing* ring) { ring_ = ring; }
+
+    bool start();
+    void stop();
+
+    // Exact once stopped
+    Stats get_stats() const;
+    uint64_t messages() const { return messages_.load(std::memory_order_acquire); }
+
+   private:
+    void run();
+    void handle(const uint8_t* data, size_t length, uint64_t recv_ns);
+    void drain_stream(uint64_t recv_ns);
+
+    OrderCallback callback_;
+    ShmOrderRing* ring_ = nullptr;
+    int listen_fd_ = -1;
+    int client_fd_ = -1;
+    uint16_t port_ = 0;
+    std::vector<uint8_t> stream_;  // Partial SoupBinTCP packets
+
+    std::thread thread_;
+    std::atomic<bool> stop_{false};
+    std::atomic<uint64_t> messages_{0};
+    Stats stats_;
+};
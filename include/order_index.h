@@ -0,0 +1,424 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+// ============================================================================
+// OrderIndex - order-id hash map that grows without a stop-the-world rehash
+// ============================================================================
+//
+// std::unordered_map rehashes every element in the insert that crosses its
+// load factor; with millions of live orders that single add_order stalls for
+// milliseconds. OrderIndex keeps two bucket arrays while it grows: a resize
+// allocates the doubled array, and every insert/erase then moves the next
+// MIGRATE_STEP buckets of the old array across. Lookups check whichever
+// array currently owns the key's bucket. The doubling finishes long before
+// the next one is due (N inserts apart vs N / MIGRATE_STEP operations), so
+// no operation ever touches more than a few chains.
+//
+// Bucket arrays come from calloc: large ones are fresh zero pages from the
+// OS, so allocating the doubled array does not memset it up front either.
+// Nodes come from a slab pool and never move, so references and pointers to
+// values stay valid until erase (OrderInfo pointers rely on this). Iterators
+// are invalidated by any insert or erase.
+
+template <typename V>
+class OrderIndex
+{
+    struct Node
+    {
+        Node* next;
+        std::pair<const uint64_t, V> kv;
+    };
+
+    struct Table
+    {
+        Node** buckets = nullptr;
+        size_t count = 0;  // Power of two
+        unsigned shift = 64;  // 64 - log2(count)
+
+        // Low bits xor a Fibonacci hash of the bits above them: ids that
+        // share the high part still map 1:1 onto buckets (sequential feeds
+        // keep the identity hash's empty chains), and ids that share low
+        // bits (venue-striped, stepped) spread over every bucket
+        size_t slot(uint64_t key) const
+        {
+            uint64_t high = key >> (64 - shift);
+            return static_cast<size_t>(key ^ ((high * 0x9E3779B97F4A7C15ULL) >> shift)) & (count - 1);
+        }
+    };
+
+    template <bool Const>
+    class Iter
+    {
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<const uint64_t, V>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+        using reference = std::conditional_t<Const, const value_type&, value_type&>;
+        using Owner = std::conditional_t<Const, const OrderIndex*, OrderIndex*>;
+
+        Iter() = default;
+        Iter(const Iter<false>& other)  // iterator -> const_iterator
+            : owner_(other.owner_), table_(other.table_), bucket_(other.bucket_), node_(other.node_)
+        {
+        }
+
+        reference operator*() const { return node_->kv; }
+        pointer operator->() const { return &node_->kv; }
+        Iter& operator++()
+        {
+            node_ = node_->next;
+            if (!node_) owner_->advance(table_, ++bucket_, node_);
+            return *this;
+        }
+        bool operator==(const Iter& o) const { return node_ == o.node_; }
+        bool operator!=(const Iter& o) const { return node_ != o.node_; }
+
+       private:
+        friend class OrderIndex;
+        template <bool>
+        friend class Iter;
+
+        Iter(Owner owner, int table, size_t bucket, Node* node)
+            : owner_(owner), table_(table), bucket_(bucket), node_(node)
+        {
+        }
+
+        Owner owner_ = nullptr;
+        int table_ = 0;  // 0 = old (while migrating), 1 = current
+        size_t bucket_ = 0;
+        Node* node_ = nullptr;
+    };
+
+   public:
+    using value_type = std::pair<const uint64_t, V>;
+    using iterator = Iter<false>;
+    using const_iterator = Iter<true>;
+
+    static constexpr size_t INITIAL_BUCKETS = 16;
+    static constexpr size_t MIGRATE_STEP = 4;  // Old buckets moved per insert/erase
+
+    struct Stats
+    {
+        size_t resizes = 0;
+        size_t buckets_migrated = 0;
+        size_t nodes_migrated = 0;
+    };
+
+    OrderIndex() { allocate(current_, INITIAL_BUCKETS); }
+    ~OrderIndex()
+    {
+        clear_nodes(old_);
+        clear_nodes(current_);
+        std::free(old_.buckets);
+        std::free(current_.buckets);
+    }
+
+    OrderIndex(const OrderIndex&) = delete;
+    OrderIndex& operator=(const OrderIndex&) = delete;
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    bool migrating() const { return old_.buckets != nullptr; }
+    size_t bucket_count() const { return current_.count; }
+    const Stats& get_stats() const { return stats_; }
+
+    iterator begin()
+    {
+        iterator it(this, 0, 0, nullptr);
+        advance(it.table_, it.bucket_, it.node_);
+        return it;
+    }
+    iterator end() { return iterator(); }
+    const_iterator begin() const
+    {
+        const_iterator it(this, 0, 0, nullptr);
+        advance(it.table_, it.bucket_, it.node_);
+        return it;
+    }
+    const_iterator end() const { return const_iterator(); }
+
+    iterator find(uint64_t key)
+    {
+        int t;
+        size_t b;
+        Node* n = lookup(key, t, b);
+        return n ? iterator(this, t, b, n) : end();
+    }
+    const_iterator find(uint64_t key) const
+    {
+        int t;
+        size_t b;
+        Node* n = lookup(key, t, b);
+        return n ? const_iterator(this, t, b, n) : end();
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(uint64_t key, Args&&... args)
+    {
+        migrate(MIGRATE_STEP);
+
+        int t;
+        size_t b;
+        if (Node* n = lookup(key, t, b)) return {iterator(this, t, b, n), false};
+
+        if (size_ >= current_.count && !migrating())
+        {
+            grow();
+            lookup(key, t, b);  // Key's bucket now belongs to the old array
+        }
+
+        Node* n = new (acquire()) Node{nullptr, value_type(key, V(std::forward<Args>(args)...))};
+        Table& table = t ? current_ : old_;
+        n->next = table.buckets[b];
+        table.buckets[b] = n;
+        ++size_;
+        return {iterator(this, t, b, n), true};
+    }
+
+    V& operator[](uint64_t key)
+    {
+        auto it = find(key);
+        if (it != end()) return it->second;
+        return emplace(key).first->second;
+    }
+
+    void erase(iterator it)
+    {
+        Table& table = it.table_ ? current_ : old_;
+        Node** link = &table.buckets[it.bucket_];
+        while (*link != it.node_) link = &(*link)->next;
+        *link = it.node_->next;
+        it.node_->~Node();
+        release(it.node_);
+        --size_;
+
+        migrate(MIGRATE_STEP);
+    }
+
+    size_t erase(uint64_t key)
+    {
+        auto it = find(key);
+        if (it == end()) return 0;
+        erase(it);
+        return 1;
+    }
+
+    // Pre-size for n keys (session warm-up): an empty index gets a bucket
+    // array that will not resize below n keys, and the pool is carved up to
+    // n nodes. Both are written once so their pages fault in now, not on the
+    // first orders of the session.
+    void reserve(size_t n)
+    {
+        if (size_ == 0 && !migrating() && current_.count < n)
+        {
+            size_t count = current_.count;
+            while (count < n) count *= 2;
+            std::free(current_.buckets);
+            current_ = Table();
+            allocate(current_, count);
+            std::memset(current_.buckets, 0, count * sizeof(Node*));
+        }
+        while (pool_capacity_ < n)
+        {
+            size_t count = std::min(n - pool_capacity_, MAX_SLAB);
+            slabs_.emplace_back(new Slot[count]);
+            Slot* slab = slabs_.back().get();
+            for (size_t i = count; i-- > 0;) release(&slab[i]);  // Lowest address handed out first
+            pool_capacity_ += count;
+        }
+    }
+
+    // Pool and bucket-array bytes (excluding the values' own heap usage)
+    size_t memory_bytes() const
+    {
+        return (old_.count + current_.count) * sizeof(Node*) + pool_capacity_ * sizeof(Slot);
+    }
+
+   private:
+    struct Slot
+    {
+        alignas(Node) unsigned char bytes[sizeof(Node)];
+    };
+
+    static constexpr size_t RELEASE_MIN_BYTES = 1 << 20;
+    static constexpr uintptr_t RELEASE_CHUNK_BYTES = 64 * 1024;
+    static constexpr size_t FIRST_SLAB = 64;
+    static constexpr size_t MAX_SLAB = 4096;
+
+    static void allocate(Table& table, size_t count)
+    {
+        table.buckets = static_cast<Node**>(std::calloc(count, sizeof(Node*)));
+        if (!table.buckets) throw std::bad_alloc();
+        table.count = count;
+        table.shift = 64;
+        for (size_t c = count; c > 1; c >>= 1) --table.shift;
+    }
+
+    // Locates key; on a miss t/b still name the bucket an insert should use
+    Node* lookup(uint64_t key, int& t, size_t& b) const
+    {
+        if (migrating())
+        {
+            b = old_.slot(key);
+            if (b >= migrate_pos_)
+            {
+                t = 0;
+                for (Node* n = old_.buckets[b]; n; n = n->next)
+                {
+                    if (n->kv.first == key) return n;
+                }
+                return nullptr;
+            }
+        }
+        t = 1;
+        b = current_.slot(key);
+        for (Node* n = current_.buckets[b]; n; n = n->next)
+        {
+            if (n->kv.first == key) return n;
+        }
+        return nullptr;
+    }
+
+    void grow()
+    {
+        old_ = current_;
+        allocate(current_, old_.count * 2);
+        migrate_pos_ = 0;
+        released_pos_ = 0;
+        stats_.resizes++;
+    }
+
+    void migrate(size_t steps)
+    {
+        if (!migrating()) return;
+        for (; steps > 0 && migrate_pos_ < old_.count; --steps, ++migrate_pos_)
+        {
+            Node* n = old_.buckets[migrate_pos_];
+            while (n)
+            {
+                Node* next = n->next;
+                size_t b = current_.slot(n->kv.first);
+                n->next = current_.buckets[b];
+                current_.buckets[b] = n;
+                n = next;
+                stats_.nodes_migrated++;
+            }
+            stats_.buckets_migrated++;
+        }
+        release_drained();
+        if (migrate_pos_ == old_.count)
+        {
+            std::free(old_.buckets);
+            old_ = Table();
+        }
+    }
+
+    // Drained old-array pages go back to the OS as migration passes them;
+    // otherwise the final free() unmaps a multi-megabyte array in one go
+    void release_drained()
+    {
+#ifndef _WIN32
+        constexpr uintptr_t PAGE = 4096;
+        if (old_.count * sizeof(Node*) < RELEASE_MIN_BYTES) return;
+        uintptr_t lo = reinterpret_cast<uintptr_t>(old_.buckets + released_pos_);
+        uintptr_t hi = reinterpret_cast<uintptr_t>(old_.buckets + migrate_pos_);
+        lo = (lo + PAGE - 1) & ~(PAGE - 1);
+        hi &= ~(PAGE - 1);
+        if (hi < lo + RELEASE_CHUNK_BYTES && migrate_pos_ < old_.count) return;
+        if (hi > lo) ::madvise(reinterpret_cast<void*>(lo), hi - lo, MADV_DONTNEED);
+        released_pos_ = migrate_pos_;
+#endif
+    }
+
+    // Next node at or after (table, bucket); null when past the end
+    void advance(int& table, size_t& bucket, Node*& node) const
+    {
+        if (table == 0)
+        {
+            if (migrating())
+            {
+                if (bucket < migrate_pos_) bucket = migrate_pos_;
+                for (; bucket < old_.count; ++bucket)
+                {
+                    if ((node = old_.buckets[bucket])) return;
+                }
+            }
+            table = 1;
+            bucket = 0;
+        }
+        for (; bucket < current_.count; ++bucket)
+        {
+            if ((node = current_.buckets[bucket])) return;
+        }
+        node = nullptr;
+    }
+
+    void clear_nodes(Table& table)
+    {
+        size_t first = (&table == &old_) ? migrate_pos_ : 0;
+        for (size_t b = first; b < table.count; ++b)
+        {
+            for (Node* n = table.buckets[b]; n;)
+            {
+                Node* next = n->next;
+                n->~Node();
+                n = next;
+            }
+        }
+    }
+
+    // Freed nodes first, then the unused tail of the newest slab - a fresh
+    // slab is carved lazily so its pages fault in one at a time
+    void* acquire()
+    {
+        if (free_)
+        {
+            void* p = free_;
+            free_ = *static_cast<void**>(p);
+            return p;
+        }
+        if (carve_ == carve_end_)
+        {
+            size_t n = slabs_.empty() ? FIRST_SLAB : std::min(pool_capacity_, MAX_SLAB);
+            slabs_.emplace_back(new Slot[n]);
+            carve_ = slabs_.back().get();
+            carve_end_ = carve_ + n;
+            pool_capacity_ += n;
+        }
+        return carve_++;
+    }
+
+    void release(void* p)
+    {
+        *static_cast<void**>(p) = free_;
+        free_ = p;
+    }
+
+    Table current_;
+    Table old_;  // Non-null only while migrating
+    size_t migrate_pos_ = 0;  // Old buckets below this have moved
+    size_t released_pos_ = 0;  // Old buckets below this have been released
+    size_t size_ = 0;
+
+    std::vector<std::unique_ptr<Slot[]>> slabs_;
+    void* free_ = nullptr;  // Released nodes, linked through their first word
+    Slot* carve_ = nullptr;
+    Slot* carve_end_ = nullptr;
+    size_t pool_capacity_ = 0;
+    Stats stats_;
+};
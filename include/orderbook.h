@@ -1,13 +1,32 @@
 #pragma once
+#include <chrono>
 #include <cstdint>
+#include <deque>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <ostream>
 #include <queue>
-#include <unordered_map>
+#include <string>
 #include <vector>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif defined(_M_X64)
+#include <intrin.h>
+#endif
+
 #include "bid_ask.h"
+#include "concurrent_order_view.h"
+#include "crc32c.h"
+#include "metrics.h"
+#include "mpid_attribution.h"
+#include "order_index.h"
+#include "tick_grid.h"
+#include "trigger_index.h"
+
+class EventCache;
+class SubscriptionFilter;
 
 // ============================================================================
 // Order and Event Structures
@@ -19,6 +38,7 @@ struct Order
     uint32_t price;
     uint32_t quantity;
     char side;  // 'B' or 'S'
+    uint16_t mpid = 0;  // Interned MPID from an 'F' add, 0 = unattributed
     uint64_t timestamp;
     bool active;
     OrderInfo* book_info;  // Pointer to bid/ask processor info
@@ -30,6 +50,20 @@ struct Order
     }
 };
 
+// Compact per-event record for batch listeners (one cache line holds two)
+struct BookEvent
+{
+    uint64_t order_id;
+    uint64_t timestamp;
+    uint32_t price;     // Raw price, as in Order
+    uint32_t quantity;  // Order quantity after the event
+    char type;          // 'A', 'X', 'E', 'U' - as passed to the per-order callback
+    char side;          // 'B' or 'S'
+    uint16_t mpid;      // Interned MPID, 0 = unattributed
+    uint32_t reserved = 0;
+};
+static_assert(sizeof(BookEvent) == 32, "BookEvent must stay 32 bytes");
+
 // ============================================================================
 // Data Fabric Interface (simulates FPGA soft-core → AXI-Stream FIFO)
 // ============================================================================
@@ -44,47 +78,64 @@ class DataFabric
     // Typical values: 512B-4KB for low latency, 16KB-64KB for buffering
     static constexpr size_t DEFAULT_FIFO_DEPTH = 4096;  // 4KB FIFO
 
-    explicit DataFabric(size_t max_depth = DEFAULT_FIFO_DEPTH) 
-        : max_depth_bytes_(max_depth), current_depth_bytes_(0) {}
+    static constexpr size_t DWELL_BUCKETS = MetricsRegistry::HISTOGRAM_BUCKETS;  // log2 ns
+    static constexpr size_t OCCUPANCY_BUCKETS = 17;  // Empty + 16 utilization sixteenths
+    static constexpr size_t QUARANTINE_DEPTH = 16;   // Most recent corrupt chunks kept
+    static constexpr uint32_t DEFAULT_TELEMETRY_SAMPLE = 16;  // One write in N stamped
+
+    explicit DataFabric(size_t max_depth = DEFAULT_FIFO_DEPTH)
+        : max_depth_bytes_(max_depth),
+          current_depth_bytes_(0),
+          ns_per_tick_(ns_per_tick()),
+          last_change_ticks_(now_ticks())
+    {
+    }
 
     // AXI-Stream write with backpressure (returns TREADY signal)
     // Returns true if write succeeded, false if FIFO full (backpressure asserted)
     bool write_chunk(const Chunk& chunk)
     {
-        // Check if FIFO has space (TREADY signal)
-        if (current_depth_bytes_ + chunk.size() > max_depth_bytes_) {
-            stats_.backpressure_events++;
-            stats_.total_bytes_dropped += chunk.size();
-            return false;  // TREADY = 0, apply backpressure
-        }
-
-        fifo_.push(chunk);
-        current_depth_bytes_ += chunk.size();
-        stats_.total_bytes_written += chunk.size();
-        
-        // Track high-water mark
-        if (current_depth_bytes_ > stats_.max_depth_reached) {
-            stats_.max_depth_reached = current_depth_bytes_;
-        }
-        
-        return true;  // TREADY = 1, write accepted
+        if (integrity_) return write_chunk(chunk, Crc32c::compute(chunk.data(), chunk.size()));
+        return write_entry(chunk, false, 0);
     }
 
-    // Orderbook reads chunks from FIFO (consumer side)
+    // Chunk sealed by its producer: crc = Crc32c::compute() over the bytes
+    // where they originated, checked at read_chunk() whatever the integrity
+    // setting
+    bool write_chunk(const Chunk& chunk, uint32_t crc) { return write_entry(chunk, true, crc); }
+
+    // Orderbook reads chunks from FIFO (consumer side). A sealed chunk whose
+    // CRC does not match is quarantined and skipped; false once none is left.
     bool read_chunk(Chunk& out)
     {
-        if (fifo_.empty())
-            return false;
-        
-        size_t chunk_size = fifo_.front().size();
-        out = std::move(fifo_.front());
-        fifo_.pop();
-        current_depth_bytes_ -= chunk_size;
-        stats_.total_bytes_read += chunk_size;
-        
-        return true;
+        while (!fifo_.empty())
+        {
+            Entry& front = fifo_.front();
+            bool sealed = front.sealed;
+            uint32_t crc = front.crc;
+            pop_front(out);
+            if (!sealed) return true;
+
+            stats_.crc_checked++;
+            if (Crc32c::compute(out.data(), out.size()) == crc) return true;
+            quarantine_chunk(out);
+        }
+        return false;
     }
 
+    // Integrity check: write_chunk(chunk) seals every chunk with a CRC32C
+    // (SSE4.2 crc32 where the build targets it, table otherwise) that
+    // read_chunk() verifies. Off by default. Producers that hold the bytes
+    // first should seal them there instead (two-argument write_chunk), so
+    // the check spans the whole path. Chunks should hold whole messages:
+    // a quarantined chunk then costs only its own messages.
+    void set_integrity_check(bool enabled) { integrity_ = enabled; }
+    bool integrity_check_enabled() const { return integrity_; }
+
+    // The last QUARANTINE_DEPTH corrupt chunks, oldest first, as read
+    const std::deque<Chunk>& quarantine() const { return quarantine_; }
+    void clear_quarantine() { quarantine_.clear(); }
+
     // Status queries
     bool empty() const { return fifo_.empty(); }
     bool full() const { return current_depth_bytes_ >= max_depth_bytes_; }
@@ -101,16 +152,269 @@ class DataFabric
         size_t total_bytes_dropped = 0;     // Total dropped due to backpressure
         size_t total_bytes_read = 0;        // Total consumed bytes
         size_t max_depth_reached = 0;       // High-water mark
+        size_t almost_full_events = 0;      // Rising crossings of the almost-full mark
+        size_t almost_empty_events = 0;     // Falling crossings of the almost-empty mark
+        size_t crc_checked = 0;             // Sealed chunks verified at read
+        size_t crc_failures = 0;            // Sealed chunks quarantined on a CRC mismatch
+        size_t quarantined_bytes = 0;       // Their bytes (also in total_bytes_read)
+
+        // Dwell time of the sampled chunks: write_chunk stamp to read_chunk,
+        // bucket b holds values <= 2^b - 1 ns
+        uint64_t dwell_ns_buckets[DWELL_BUCKETS] = {};
+        uint64_t dwell_count = 0;
+        uint64_t dwell_total_ns = 0;
+        uint64_t dwell_max_ns = 0;
+
+        // Time spent at each occupancy: bucket 0 = empty, bucket k = depth in
+        // ((k-1)/16, k/16] of max depth. Each sample charges the time since
+        // the previous one to the depth it sees; accounted up to the last.
+        uint64_t occupancy_ns[OCCUPANCY_BUCKETS] = {};
+
+        // Upper bound of the log2 bucket holding the p-th dwell percentile (p in [0,1])
+        uint64_t dwell_percentile_ns(double p) const
+        {
+            if (dwell_count == 0) return 0;
+            uint64_t rank = static_cast<uint64_t>(p * static_cast<double>(dwell_count - 1)) + 1;
+            uint64_t seen = 0;
+            for (size_t b = 0; b < DWELL_BUCKETS; ++b) {
+                seen += dwell_ns_buckets[b];
+                if (seen >= rank) return b == 0 ? 0 : (1ULL << b) - 1;
+            }
+            return dwell_max_ns;
+        }
     };
     
     const FIFOStats& get_stats() const { return stats_; }
-    void reset_stats() { stats_ = FIFOStats{}; }
+    void reset_stats()
+    {
+        stats_ = FIFOStats{};
+        last_change_ticks_ = now_ticks();
+    }
+
+    // Watermarks (bytes). AlmostFull fires when depth rises to almost_full_bytes;
+    // AlmostEmpty fires when it then falls to almost_empty_bytes. The gap between
+    // the two is the hysteresis band. Disabled by default.
+    enum class WatermarkEvent : uint8_t { AlmostFull, AlmostEmpty };
+    using WatermarkCallback = std::function<void(WatermarkEvent event, size_t depth_bytes)>;
+
+    void set_watermarks(size_t almost_full_bytes, size_t almost_empty_bytes)
+    {
+        almost_full_bytes_ = almost_full_bytes;
+        almost_empty_bytes_ = almost_empty_bytes < almost_full_bytes ? almost_empty_bytes
+                                                                     : (almost_full_bytes ? almost_full_bytes - 1 : 0);
+        under_pressure_ = false;
+    }
+    void set_watermark_callback(WatermarkCallback cb) { watermark_callback_ = std::move(cb); }
+
+    // True between an AlmostFull and the following AlmostEmpty
+    bool under_pressure() const { return under_pressure_; }
+
+    // Dwell/occupancy collection, on by default. One write in sample_every
+    // reads the TSC (calibrated against steady_clock once per process) to
+    // stamp its chunk and take an occupancy sample; reading that chunk takes
+    // the second. Other chunks cost a countdown. sample_every = 1 stamps
+    // every chunk: ~15% on the one-message-per-chunk parse path, against
+    // no measurable cost at the default.
+    void set_telemetry(bool enabled, uint32_t sample_every = DEFAULT_TELEMETRY_SAMPLE)
+    {
+        telemetry_ = enabled;
+        sample_every_ = sample_every ? sample_every : 1;
+        sample_countdown_ = sample_every_;
+        last_change_ticks_ = now_ticks();
+    }
+    bool telemetry_enabled() const { return telemetry_; }
+
+    // Mirror FIFOStats into a shared registry (labels e.g. "fabric=\"feed0\"")
+    void bind_metrics(MetricsRegistry& registry, const std::string& labels = "")
+    {
+        metrics_.bytes_written = registry.counter("fabric_bytes_written_total",
+                                                  "Bytes accepted by the FIFO", labels);
+        metrics_.bytes_read = registry.counter("fabric_bytes_read_total",
+                                               "Bytes consumed from the FIFO", labels);
+        metrics_.bytes_dropped = registry.counter("fabric_bytes_dropped_total",
+                                                  "Bytes rejected under backpressure", labels);
+        metrics_.backpressure_events = registry.counter(
+            "fabric_backpressure_events_total", "Writes rejected because the FIFO was full", labels);
+        metrics_.depth_bytes = registry.gauge("fabric_depth_bytes", "Current FIFO occupancy", labels);
+        metrics_.dwell_ns = registry.histogram("fabric_dwell_ns",
+                                               "Time chunks spent in the FIFO (ns)", labels);
+        metrics_.crc_failures = registry.counter("fabric_crc_failures_total",
+                                                 "Chunks quarantined on a CRC32C mismatch", labels);
+    }
 
    private:
-    std::queue<Chunk> fifo_;
+    struct Entry {
+        Chunk data;
+        uint64_t enqueue_ticks;  // 0 = not sampled
+        uint32_t crc;            // CRC32C of data as sealed
+        bool sealed;             // False: nothing to verify
+    };
+
+    static uint64_t steady_ns()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+    }
+
+    // TSC where there is one (~15 ns vs ~26 ns for steady_clock on the test
+    // VM), steady_clock nanoseconds otherwise
+    static uint64_t now_ticks()
+    {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+        return __rdtsc();
+#else
+        return steady_ns();
+#endif
+    }
+
+    // Calibrated once: 1 ms of busy-waiting on the first DataFabric
+    static double ns_per_tick()
+    {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+        static const double calibrated = [] {
+            uint64_t ns0 = steady_ns();
+            uint64_t ticks0 = __rdtsc();
+            uint64_t ns1 = ns0;
+            while (ns1 - ns0 < 1000000) ns1 = steady_ns();
+            uint64_t ticks = __rdtsc() - ticks0;
+            return ticks ? static_cast<double>(ns1 - ns0) / static_cast<double>(ticks) : 1.0;
+        }();
+        return calibrated;
+#else
+        return 1.0;
+#endif
+    }
+
+    uint64_t to_ns(uint64_t ticks) const { return static_cast<uint64_t>(static_cast<double>(ticks) * ns_per_tick_); }
+
+    // Charge the time since the previous sample to the current depth
+    void account_occupancy(uint64_t now_ticks)
+    {
+        size_t bucket = 0;
+        if (current_depth_bytes_ > 0 && max_depth_bytes_ > 0) {
+            bucket = 1 + (current_depth_bytes_ - 1) * (OCCUPANCY_BUCKETS - 1) / max_depth_bytes_;
+            if (bucket >= OCCUPANCY_BUCKETS) bucket = OCCUPANCY_BUCKETS - 1;
+        }
+        stats_.occupancy_ns[bucket] += to_ns(now_ticks - last_change_ticks_);
+        last_change_ticks_ = now_ticks;
+    }
+
+    void signal_watermark(WatermarkEvent event)
+    {
+        under_pressure_ = (event == WatermarkEvent::AlmostFull);
+        if (under_pressure_) stats_.almost_full_events++;
+        else stats_.almost_empty_events++;
+        if (watermark_callback_) watermark_callback_(event, current_depth_bytes_);
+    }
+
+    void record_dwell(uint64_t dwell)
+    {
+        stats_.dwell_ns_buckets[MetricsRegistry::bucket_for(dwell)]++;
+        stats_.dwell_count++;
+        stats_.dwell_total_ns += dwell;
+        if (dwell > stats_.dwell_max_ns) stats_.dwell_max_ns = dwell;
+        metrics_.dwell_ns.observe(dwell);
+    }
+
+    bool write_entry(const Chunk& chunk, bool sealed, uint32_t crc)
+    {
+        // Check if FIFO has space (TREADY signal)
+        if (current_depth_bytes_ + chunk.size() > max_depth_bytes_) {
+            stats_.backpressure_events++;
+            stats_.total_bytes_dropped += chunk.size();
+            metrics_.backpressure_events.inc();
+            metrics_.bytes_dropped.inc(chunk.size());
+            return false;  // TREADY = 0, apply backpressure
+        }
+
+        // A sampled write: one clock read stamps the chunk and takes an occupancy sample
+        uint64_t stamp = 0;
+        if (telemetry_ && --sample_countdown_ == 0) {
+            sample_countdown_ = sample_every_;
+            stamp = now_ticks();
+            account_occupancy(stamp);
+        }
+
+        fifo_.push(Entry{chunk, stamp, crc, sealed});
+        current_depth_bytes_ += chunk.size();
+        stats_.total_bytes_written += chunk.size();
+        metrics_.bytes_written.inc(chunk.size());
+        metrics_.depth_bytes.set(static_cast<int64_t>(current_depth_bytes_));
+
+        // Edge-triggered: fires once per crossing, not on every write above the mark
+        if (current_depth_bytes_ >= almost_full_bytes_ && !under_pressure_) {
+            signal_watermark(WatermarkEvent::AlmostFull);
+        }
+
+        // Track high-water mark
+        if (current_depth_bytes_ > stats_.max_depth_reached) {
+            stats_.max_depth_reached = current_depth_bytes_;
+        }
+        
+        return true;  // TREADY = 1, write accepted
+    }
+
+    // Front entry out, with all consume-side accounting
+    void pop_front(Chunk& out)
+    {
+        Entry& front = fifo_.front();
+        if (telemetry_ && front.enqueue_ticks) {
+            uint64_t now = now_ticks();
+            account_occupancy(now);
+            record_dwell(to_ns(now - front.enqueue_ticks));
+        }
+
+        size_t chunk_size = front.data.size();
+        out = std::move(front.data);
+        fifo_.pop();
+        current_depth_bytes_ -= chunk_size;
+        stats_.total_bytes_read += chunk_size;
+        metrics_.bytes_read.inc(chunk_size);
+        metrics_.depth_bytes.set(static_cast<int64_t>(current_depth_bytes_));
+
+        if (under_pressure_ && current_depth_bytes_ <= almost_empty_bytes_) {
+            signal_watermark(WatermarkEvent::AlmostEmpty);
+        }
+    }
+
+    void quarantine_chunk(Chunk& chunk)
+    {
+        stats_.crc_failures++;
+        stats_.quarantined_bytes += chunk.size();
+        metrics_.crc_failures.inc();
+        if (quarantine_.size() == QUARANTINE_DEPTH) quarantine_.pop_front();
+        quarantine_.push_back(std::move(chunk));
+        chunk.clear();
+    }
+
+    // Unbound handles are no-ops until bind_metrics()
+    struct FabricMetrics {
+        MetricsRegistry::Counter bytes_written;
+        MetricsRegistry::Counter bytes_read;
+        MetricsRegistry::Counter bytes_dropped;
+        MetricsRegistry::Counter backpressure_events;
+        MetricsRegistry::Gauge depth_bytes;
+        MetricsRegistry::Histogram dwell_ns;
+        MetricsRegistry::Counter crc_failures;
+    };
+
+    std::queue<Entry> fifo_;
     size_t max_depth_bytes_;         // Maximum FIFO depth in bytes
     size_t current_depth_bytes_;     // Current occupancy in bytes
     FIFOStats stats_;                // Performance monitoring
+    FabricMetrics metrics_;
+    bool telemetry_ = true;
+    uint32_t sample_every_ = DEFAULT_TELEMETRY_SAMPLE;
+    uint32_t sample_countdown_ = DEFAULT_TELEMETRY_SAMPLE;  // Writes until the next stamp
+    double ns_per_tick_;
+    uint64_t last_change_ticks_;     // Previous occupancy sample
+    size_t almost_full_bytes_ = SIZE_MAX;
+    size_t almost_empty_bytes_ = 0;
+    bool under_pressure_ = false;
+    WatermarkCallback watermark_callback_;
+    bool integrity_ = false;
+    std::deque<Chunk> quarantine_;
 };
 
 // ============================================================================
@@ -122,6 +426,7 @@ class ITCHParser
    public:
     // NASDAQ ITCH 5.0 message lengths
     static constexpr size_t ADD_MSG_SIZE = 36;      // 'A' - Add Order (No MPID Attribution)
+    static constexpr size_t ADD_MPID_MSG_SIZE = 40; // 'F' - Add Order with MPID Attribution
     static constexpr size_t CANCEL_MSG_SIZE = 23;   // 'X' - Order Cancel
     static constexpr size_t EXECUTE_MSG_SIZE = 31;  // 'E' - Order Executed
     static constexpr size_t REPLACE_MSG_SIZE = 35;  // 'U' - Order Replace
@@ -133,20 +438,29 @@ class ITCHParser
     {
         size_t bytes_consumed;
         bool valid;
-        char type;  // 'A' = Add, 'X' = Cancel, 'E' = Execute, 'U' = Replace
+        char type;  // 'A'/'F' = Add, 'X' = Cancel, 'E' = Execute, 'U' = Replace
         uint64_t order_id;
         uint64_t new_order_id;
         uint32_t price;
         uint32_t quantity;
         char side;
         uint64_t timestamp;
+        uint16_t locate;  // Stock Locate - routes the message to its symbol book
+        uint32_t mpid;    // 'F' only: 4 ASCII bytes as on the wire, 0 otherwise
+        uint64_t stock;   // 'A'/'F' only: Stock field as a SymbolTable::key(), 0 otherwise (X/E/U: OrderSymbols)
     };
 
     std::optional<ParseResult> parse_one(const std::vector<uint8_t>& buffer) const;
 
+    // Zero-copy variant over a raw byte range (capture blocks, mapped files)
+    std::optional<ParseResult> parse_one(const uint8_t* data, size_t length) const;
+
+    // Wire length for a message type, 0 if the type is unknown
+    static size_t message_length(char msg_type);
+
    private:
-    uint64_t read_u64(const std::vector<uint8_t>& buf, size_t& offset) const;
-    uint32_t read_u32(const std::vector<uint8_t>& buf, size_t& offset) const;
+    uint64_t read_u64(const uint8_t* buf, size_t& offset) const;
+    uint32_t read_u32(const uint8_t* buf, size_t& offset) const;
 };
 
 // ============================================================================
@@ -166,9 +480,73 @@ class OrderBook
         callback_ = std::move(cb);
     }
 
+    // Batched delivery: events accumulate in a contiguous buffer and the
+    // listener gets one call per process() / process_some() / process_bytes()
+    // / replay() with all of them, instead of one std::function call per
+    // event. Independent of set_event_callback() - either, both or neither.
+    // The fixed buffer is flushed early once max_batch events are queued (the
+    // default keeps it L1-resident while the consumer reads it); callers
+    // driving handle_message() directly call flush_batch() themselves.
+    using BatchCallback = std::function<void(const BookEvent* events, size_t count)>;
+    void set_batch_listener(BatchCallback cb, size_t max_batch = 256);
+    void flush_batch();
+
     // call repeatedly to drain fabric and process messages
     void process();
 
+    // Adaptive consumer mode for process(): small batches with inline callbacks
+    // while the fabric is calm; once its almost-full watermark fires, large
+    // batches with callbacks queued until it drops back to almost-empty.
+    // Each process() call handles one batch and returns, so the caller's loop
+    // (polling the producer, timers) runs between batches; call it until
+    // the fabric is empty to drain. Requires DataFabric::set_watermarks() on
+    // the bound fabric.
+    struct AdaptiveConfig {
+        size_t low_latency_batch = 1;    // Chunks per batch when calm
+        size_t pressure_batch = 64;      // Chunks per batch under pressure
+        bool defer_callbacks = true;     // Queue callbacks under pressure
+        size_t max_deferred = 1 << 16;   // Flush early beyond this many queued events
+    };
+
+    struct AdaptiveStats {
+        size_t low_latency_batches = 0;
+        size_t pressure_batches = 0;
+        size_t pressure_episodes = 0;    // Calm -> pressure transitions
+        size_t callbacks_deferred = 0;
+        size_t max_deferred_backlog = 0;
+    };
+
+    void enable_adaptive(const AdaptiveConfig& config);
+    void disable_adaptive();  // Flushes any deferred callbacks
+    bool adaptive_enabled() const { return adaptive_; }
+    const AdaptiveStats& get_adaptive_stats() const { return adaptive_stats_; }
+
+    // Budgeted variant for cooperative scheduling: consume at most max_chunks
+    // chunks, parsing after each one. Returns the number of chunks consumed.
+    size_t process_some(size_t max_chunks);
+
+    // Parse messages directly from a contiguous block (capture reader path)
+    // A message cut at the block end is carried over into the next call
+    void process_bytes(const uint8_t* data, size_t length);
+
+    // Record every decoded message into cache (nullptr to stop recording)
+    void set_event_recorder(EventCache* cache)
+    {
+        recorder_ = cache;
+    }
+
+    // Drop messages for unsubscribed symbols ahead of the hash tables
+    // (nullptr to accept everything). Not owned; applies to every path into
+    // handle_message. Set before the first message.
+    void set_subscription_filter(SubscriptionFilter* filter)
+    {
+        filter_ = filter;
+    }
+
+    // Feed pre-decoded events straight into handle_message (no fabric, no parse)
+    // Returns the number of events applied
+    size_t replay(const EventCache& cache);
+
     bool add_order(const Order& order);
     bool cancel_order(uint64_t order_id);
     bool execute_order(uint64_t order_id, uint32_t quantity);
@@ -176,6 +554,106 @@ class OrderBook
 
     const Order* find_order(uint64_t order_id) const;
 
+    // Every live order, in no particular order (snapshots, state handoff)
+    template <typename Fn>
+    void for_each_order(Fn&& fn) const
+    {
+        for (const auto& [id, order] : orders_)
+        {
+            if (order.active) fn(order);
+        }
+    }
+
+    // Every live order, level by level, each level's orders in queue (time
+    // priority) order. Re-adding them in this order rebuilds every queue as
+    // it was; timestamps cannot, since a replace keeps the old order's
+    // timestamp but joins the back of its new level.
+    template <typename Fn>
+    void for_each_queued(Fn&& fn) const
+    {
+        for (Side side : {Side::Bid, Side::Ask})
+        {
+            book_.forEachLevel(side, [&](const PriceLevel& level) {
+                for (const OrderNode* node = level.head; node; node = node->next)
+                {
+                    auto it = orders_.find(node->order_id);
+                    if (it != orders_.end() && it->second.active) fn(it->second);
+                }
+            });
+        }
+    }
+
+    // MPID attribution ('F' adds): largest n MPIDs resting at the touch,
+    // O(n) after two O(1) lookups. touch_price_out gets the API price.
+    size_t get_top_mpids(Side side, size_t n, MpidAttribution::MpidShare* out,
+                         uint64_t* touch_price_out = nullptr) const;
+    // MPID that opened the current touch level (MpidAttribution::NONE if anonymous)
+    uint16_t get_touch_setter(Side side) const;
+    const MpidAttribution& get_attribution() const { return attribution_; }
+
+    // Tick mode: the price-level book is keyed by 32-bit tick indices from
+    // grid (nullptr = raw prices, the default). Prices are normalized once as
+    // adds/replaces enter the book and converted back in the market data API;
+    // Order records and callbacks keep raw prices. Off-grid prices are
+    // rejected and counted. Must be set while the book is empty; false for a
+    // grid that is not valid().
+    bool set_tick_grid(const TickGrid* grid);
+    const TickGrid* tick_grid() const { return tick_grid_; }
+
+    // Per-side level layout: thin (sorted vector) until a side holds more
+    // than promote_levels levels, thick until it falls below demote_levels.
+    // Thick is the ordered map, or with a tick grid a ladder indexed by tick
+    // while the levels span at most ladder_span ticks. Switches are counted
+    // in get_layout_stats().
+    void set_layout_config(const LayoutConfig& config) { book_.setLayoutConfig(config); }
+    LayoutStats get_layout_stats() const { return book_.getLayoutStats(); }
+    BookLayout get_layout(Side side) const { return book_.layout(side); }
+
+    // Empty levels near the touch are kept and revived instead of erased and
+    // recreated (see LevelRetention); max_empty = 0 restores immediate erase.
+    void set_level_retention(const LevelRetention& retention) { book_.setRetention(retention); }
+    RetentionStats get_retention_stats() const { return book_.getRetentionStats(); }
+
+    // Conditional notifications evaluated inside the engine (trigger_index.h):
+    // each update checks only the triggers at the touched levels and, on a
+    // top-of-book change, the best-price and spread thresholds. One-shot;
+    // ids start at 1, 0 = rejected (off-grid price in tick mode). Prices are
+    // raw; spread thresholds are book units (ticks in tick mode). Triggers
+    // fire before the order event callback of the update that fired them.
+    using TriggerCallback = std::function<void(const TriggerIndex::Fired&)>;
+    void set_trigger_callback(TriggerCallback cb);  // Fired::price is raw
+    // tag comes back in Fired::tag (a trigger may fire inside the add call)
+    uint32_t add_best_price_trigger(Side side, uint32_t price, uint64_t tag = 0);  // Bid >= / ask <= price
+    uint32_t add_level_size_trigger(Side side, uint32_t price, uint64_t below_qty, uint64_t tag = 0);
+    uint32_t add_spread_trigger(int64_t above, uint64_t tag = 0);
+    bool remove_trigger(uint32_t id) { return book_.removeTrigger(id); }
+    TriggerIndex::Stats get_trigger_stats() const;
+
+    // Top-of-book change detection: cb gets raw prices (qty 0 = side empty)
+    // after every update that changes the best price or size on either side
+    using BboCallback = std::function<void(const TopOfBook&)>;
+    void set_bbo_callback(BboCallback cb);
+    size_t get_bbo_changes() const { return book_.getBboChanges(); }
+
+    // Total resting quantity at a raw price, 0 if there is no level
+    uint64_t get_level_quantity(Side side, uint32_t price) const;
+
+    // Build ahead of the session what the book otherwise creates lazily on
+    // its first messages: both order indices sized for orders (no resize
+    // until then), and on each side FIFO nodes for orders and thin-layout
+    // slots for levels.
+    // Memory is touched here, so those pages do not fault on the open.
+    void reserve(size_t orders, size_t levels = 64);
+
+    // Mirror live orders into a seqlock table that other threads may read
+    // (find_order() itself is processing-thread only). Existing orders are
+    // copied in; max_orders is a hard capacity. Call before readers start.
+    void enable_concurrent_reads(size_t max_orders);
+    const ConcurrentOrderView* concurrent_view() const { return concurrent_view_.get(); }
+
+    // Apply one already-decoded message (event cache replay, sharded workers)
+    void handle_message(const ITCHParser::ParseResult& result);
+
     size_t get_order_count() const
     {
         return orders_.size();
@@ -187,11 +665,15 @@ class OrderBook
         size_t buffer_overflows = 0;
         size_t incomplete_messages = 0;
         size_t invalid_operations = 0;
+        size_t off_grid_prices = 0;     // Adds/replaces rejected in tick mode
     };
     
     const ErrorStats& get_error_stats() const { return error_stats_; }
     void reset_error_stats() { error_stats_ = ErrorStats{}; }
 
+    // Mirror ErrorStats (plus applied / filtered message counters) into a shared registry
+    void bind_metrics(MetricsRegistry& registry, const std::string& labels = "");
+
     // Debug output
     void print_orders(std::ostream& os) const;
 
@@ -207,14 +689,63 @@ class OrderBook
     MarketDepth get_depth(size_t levels) const;
 
 private:
-    void handle_message(const ITCHParser::ParseResult& result);
+    struct BookMetrics {
+        MetricsRegistry::Counter messages;
+        MetricsRegistry::Counter filtered_messages;
+        MetricsRegistry::Counter unknown_message_types;
+        MetricsRegistry::Counter buffer_overflows;
+        MetricsRegistry::Counter incomplete_messages;
+        MetricsRegistry::Counter invalid_operations;
+        MetricsRegistry::Counter off_grid_prices;
+    };
+
+    void drain_message_buffer();
+    bool to_book_price(uint32_t price, uint32_t& key);
+    bool trigger_key(uint32_t price, uint32_t& key) const  // No off-grid accounting
+    {
+        key = price;
+        return !tick_grid_ || tick_grid_->to_tick(price, key);
+    }
+    uint64_t from_book_price(uint64_t key) const
+    {
+        return tick_grid_ ? tick_grid_->to_price(static_cast<uint32_t>(key)) : key;
+    }
+    void process_adaptive();
+    // Attribution holds each level's setter until the book level is gone
+    void level_left(Side side, uint32_t price_key)
+    {
+        if (attribution_.level_count() && !book_.hasLevel(side, price_key))
+            attribution_.on_level_removed(side, price_key);
+    }
+    void emit(char type, const Order& order);
+    void flush_deferred();
 
     DataFabric& fabric_;
     std::vector<uint8_t> message_buffer_;
     ITCHParser parser_;
-    std::unordered_map<uint64_t, Order> orders_;
-    std::unordered_map<uint64_t, OrderInfo> order_info_;  // Bid/ask processor info
+    OrderIndex<Order> orders_;  // Grows incrementally - no rehash stalls
+    OrderIndex<OrderInfo> order_info_;  // Bid/ask processor info; nodes never move
     OrderBookEngine book_;  // Price-level matching engine
     EventCallback callback_;
     ErrorStats error_stats_;
+    BookMetrics metrics_;  // No-ops until bind_metrics()
+    EventCache* recorder_ = nullptr;  // Decoded-event capture for later replay
+    SubscriptionFilter* filter_ = nullptr;  // Null = every symbol
+    std::unique_ptr<ConcurrentOrderView> concurrent_view_;  // Null unless enabled
+    const TickGrid* tick_grid_ = nullptr;                   // Null = raw price keys
+    MpidAttribution attribution_;                           // Only 'F' orders touch it
+
+    // Adaptive consumer state
+    bool adaptive_ = false;
+    bool pressure_mode_ = false;
+    bool deferring_ = false;
+    AdaptiveConfig adaptive_config_;
+    AdaptiveStats adaptive_stats_;
+    std::vector<std::pair<char, Order>> deferred_;  // Snapshots, book_info cleared
+
+    // Batch listener state
+    BatchCallback batch_listener_;
+    std::unique_ptr<BookEvent[]> batch_;  // Indexed stores - cheaper than push_back per event
+    size_t batch_size_ = 0;
+    size_t max_batch_ = 0;
 };
\ No newline at end of file
@@ -0,0 +1,90 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// ============================================================================
+// OUCH 4.2 - order entry encoder and decoder
+// ============================================================================
+//
+// Inbound (client -> exchange) messages only: Enter Order 'O' (49 bytes),
+// Replace Order 'U' (47) and Cancel Order 'X' (19). Integers are big-endian,
+// alpha fields left-justified and space padded, prices carry 4 implied
+// decimals like ITCH. The encoder writes into a caller buffer and issues
+// order tokens by incrementing ASCII digits in place, so building an order
+// on the strategy path neither allocates nor divides.
+//
+// The decoder serves the exchange stand-in (order_gateway.h).
+
+// Stock symbol padded once, outside the hot path
+struct OuchSymbol
+{
+    char bytes[8];
+
+    explicit OuchSymbol(const char* symbol);
+};
+
+class OuchEncoder
+{
+   public:
+    static constexpr size_t ENTER_ORDER_SIZE = 49;
+    static constexpr size_t REPLACE_ORDER_SIZE = 47;
+    static constexpr size_t CANCEL_ORDER_SIZE = 19;
+    static constexpr size_t MAX_MESSAGE_SIZE = ENTER_ORDER_SIZE;
+    static constexpr size_t TOKEN_SIZE = 14;
+
+    static constexpr uint32_t TIF_IOC = 0;
+    static constexpr uint32_t TIF_MARKET_HOURS = 99998;
+    static constexpr uint32_t TIF_SYSTEM_HOURS = 99999;
+
+    // firm: up to 4 characters. Tokens are token_prefix (up to 6 characters,
+    // not ending in a digit) followed by a zero-padded counter starting at 1.
+    explicit OuchEncoder(const char* firm, const char* token_prefix = "");
+
+    // Each writes one message into out (at least MAX_MESSAGE_SIZE bytes) and
+    // returns its length. enter_order / replace_order take the next token;
+    // last_token() returns it.
+    size_t enter_order(uint8_t* out, char side, uint32_t shares, const OuchSymbol& stock, uint32_t price,
+                       uint32_t time_in_force = TIF_IOC, char display = 'Y', char capacity = 'P');
+    size_t replace_order(uint8_t* out, const char* existing_token, uint32_t shares, uint32_t price,
+                         uint32_t time_in_force = TIF_IOC, char display = 'Y');
+    size_t cancel_order(uint8_t* out, const char* token, uint32_t shares = 0);  // 0 = cancel all
+
+    const char* last_token() const { return last_token_; }  // TOKEN_SIZE bytes, not terminated
+    uint64_t tokens_issued() const { return issued_; }
+
+   private:
+    void advance_token();
+
+    char firm_[4];
+    char token_[TOKEN_SIZE];       // Next token to issue
+    char last_token_[TOKEN_SIZE];  // Most recently issued
+    size_t prefix_len_ = 0;
+    uint64_t issued_ = 0;
+};
+
+// One decoded inbound message
+struct OuchMessage
+{
+    char type = 0;  // 'O', 'U', 'X'
+    char token[OuchEncoder::TOKEN_SIZE];
+    char replacement_token[OuchEncoder::TOKEN_SIZE];  // 'U' only
+    char side = 0;                                    // 'O' only
+    uint32_t shares = 0;
+    char stock[8];  // 'O' only
+    uint32_t price = 0;
+    uint32_t time_in_force = 0;
+    char firm[4];  // 'O' only
+};
+
+class OuchDecoder
+{
+   public:
+    // Length of an inbound message of this type, 0 if unknown
+    static size_t message_size(char type);
+
+    // False if the type is unknown or length is short
+    static bool parse(const uint8_t* data, size_t length, OuchMessage& out);
+
+    // Counter value of a token issued by OuchEncoder (digits after the prefix)
+    static uint64_t token_number(const char* token);
+};
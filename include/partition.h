@@ -0,0 +1,246 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "orderbook.h"
+
+// ============================================================================
+// Multi-process symbol partitioning
+// ============================================================================
+//
+// PartitionCoordinator forks N book processes and splits the symbol universe
+// (Stock Locates) across them. It reads the locate straight from each raw
+// ITCH message and batches whole messages into per-partition Data frames;
+// each partition parses its frames and applies them to one OrderBook per
+// locate, as ShardedEngine workers do.
+//
+// Coordinator and partition talk over a PartitionLink - a duplex channel
+// of self-contained frames (kind + up to MAX_FRAME bytes, no pointers):
+//   ShmPartitionLink    - two SPSC byte rings in a MAP_SHARED mapping
+//   SocketPartitionLink - AF_UNIX SOCK_SEQPACKET socket pair
+// Data and control frames share one ordered channel per direction, so a
+// control frame takes effect exactly after the data sent before it. Nothing
+// in the protocol assumes a shared address space: spanning hosts needs only
+// a stream-socket link with length framing and a remote launcher in place
+// of fork().
+//
+// Control plane:
+//   reassign(locate, p) - Release goes to the old owner behind its queued
+//     data; it answers with the symbol's live orders (Handoff frames) and
+//     Released. The coordinator stashes the symbol's new messages meanwhile,
+//     forwards the handoff to the new owner, then the stash, then routes
+//     there directly. Orders move level by level in queue order (not by
+//     timestamp: a replace keeps its timestamp but joins the back of the
+//     queue), so every level queue keeps its priority; MPID attribution is
+//     not carried over.
+//   collect_stats() - every partition replies behind its queued data, so the
+//     merged result covers everything routed before the call.
+//
+// POSIX only (fork, mmap, socketpair); on Windows start() fails. Create and
+// drive the coordinator from one thread, before other threads exist (fork).
+
+class PartitionLink
+{
+   public:
+    static constexpr size_t MAX_FRAME = 8192;
+
+    enum class End
+    {
+        Coordinator,
+        Partition
+    };
+
+    virtual ~PartitionLink() = default;
+
+    virtual bool valid() const = 0;
+
+    // After fork(): each process keeps its own end
+    virtual void bind(End end) = 0;
+
+    // To the peer. False if the channel is full (retry) or the frame exceeds
+    // MAX_FRAME.
+    virtual bool send(uint8_t kind, const uint8_t* data, size_t length) = 0;
+
+    // Next frame from the peer into out (MAX_FRAME bytes); false if none
+    virtual bool receive(uint8_t& kind, uint8_t* out, size_t& length) = 0;
+};
+
+class ShmPartitionLink : public PartitionLink
+{
+   public:
+    explicit ShmPartitionLink(size_t ring_bytes = 1 << 20);  // Per direction, rounded to a power of two
+    ~ShmPartitionLink() override;
+
+    ShmPartitionLink(const ShmPartitionLink&) = delete;
+    ShmPartitionLink& operator=(const ShmPartitionLink&) = delete;
+
+    bool valid() const override { return mapping_ != nullptr; }
+    void bind(End end) override { end_ = end; }
+    bool send(uint8_t kind, const uint8_t* data, size_t length) override;
+    bool receive(uint8_t& kind, uint8_t* out, size_t& length) override;
+
+   private:
+    struct Ring;
+
+    Ring& outbound();
+    Ring& inbound();
+
+    void* mapping_ = nullptr;
+    size_t mapping_bytes_ = 0;
+    Ring* down_ = nullptr;  // Coordinator -> partition
+    Ring* up_ = nullptr;    // Partition -> coordinator
+    End end_ = End::Coordinator;
+
+    // Process-local (this object is copied by fork, the rings are shared)
+    uint64_t head_cache_ = 0;  // Sender's view of the outbound ring's head
+    uint64_t tail_cache_ = 0;  // Receiver's view of the inbound ring's tail
+};
+
+class SocketPartitionLink : public PartitionLink
+{
+   public:
+    SocketPartitionLink();
+    ~SocketPartitionLink() override;
+
+    SocketPartitionLink(const SocketPartitionLink&) = delete;
+    SocketPartitionLink& operator=(const SocketPartitionLink&) = delete;
+
+    bool valid() const override { return fd_[0] >= 0 || fd_[1] >= 0; }
+    void bind(End end) override;  // Closes the other end's descriptor
+    bool send(uint8_t kind, const uint8_t* data, size_t length) override;
+    bool receive(uint8_t& kind, uint8_t* out, size_t& length) override;
+
+   private:
+    int fd_[2] = {-1, -1};  // [0] coordinator, [1] partition
+    int own_ = -1;
+};
+
+class PartitionCoordinator
+{
+   public:
+    static constexpr size_t MAX_LOCATES = 1 << 16;
+
+    enum class Transport
+    {
+        SharedMemory,
+        UnixSocket
+    };
+
+    struct Config
+    {
+        size_t partitions = 4;
+        Transport transport = Transport::SharedMemory;
+        size_t ring_bytes = 1 << 20;  // Shared-memory rings, per direction
+    };
+
+    // One partition's view, as it reported it
+    struct PartitionStats
+    {
+        int64_t pid = 0;
+        uint64_t messages = 0;      // ITCH messages applied
+        uint64_t bytes = 0;         // Data bytes received
+        uint64_t frames = 0;        // Frames received
+        uint64_t symbols = 0;       // Books held
+        uint64_t orders = 0;        // Live orders across its books
+        uint64_t invalid = 0;       // Unparseable bytes / bad frames
+        uint64_t handoffs_out = 0;  // Symbols released
+        uint64_t handoffs_in = 0;   // Symbols adopted
+        uint64_t digest = 0;        // Sum of book_digest() over its books
+    };
+
+    struct Stats
+    {
+        std::vector<PartitionStats> partitions;
+        PartitionStats total;  // Sums; pid 0
+
+        // Coordinator side
+        uint64_t routed = 0;            // Messages routed
+        uint64_t unroutable = 0;        // Unknown type or truncated
+        uint64_t send_retries = 0;      // Full channel waits
+        uint64_t stashed = 0;           // Messages held for symbols in transit
+        uint64_t reassignments = 0;     // Completed
+        uint64_t max_pause_ns = 0;      // reassign() to routed at the new owner
+        uint64_t total_pause_ns = 0;
+    };
+
+    PartitionCoordinator();
+    explicit PartitionCoordinator(const Config& config);
+    ~PartitionCoordinator();
+
+    PartitionCoordinator(const PartitionCoordinator&) = delete;
+    PartitionCoordinator& operator=(const PartitionCoordinator&) = delete;
+
+    // Forks the partitions; routing starts as locate % partitions
+    bool start();
+    void stop();  // Flushes, shuts the partitions down and reaps them
+    bool running() const { return running_; }
+
+    // Whole ITCH messages, any number; a trailing partial message is counted
+    // unroutable. Batched per partition until a frame fills or flush().
+    void route(const uint8_t* data, size_t length);
+    void flush();
+
+    // Move a symbol to another partition (asynchronous; see above). False if
+    // it already lives there, is in transit, or the target is out of range.
+    bool reassign(uint16_t locate, size_t partition);
+    bool in_transit(uint16_t locate) const { return transit_[locate] != NO_TRANSIT; }
+
+    // Handle replies from the partitions (handoffs, stats); call regularly
+    // while routing. Waiting on a full channel only queues them.
+    void poll();
+
+    // Flush, then gather every partition's counters (blocks until all reply)
+    Stats collect_stats();
+
+    size_t partition_count() const { return links_.size(); }
+    size_t owner(uint16_t locate) const { return route_[locate]; }
+
+    // Fingerprint of a book's top of book, order count and every level's
+    // queue (each order's id, quantity and position); summed over books, it
+    // lets a partitioned run be compared with a single-process one
+    static uint64_t book_digest(uint16_t locate, const OrderBook& book);
+
+   private:
+    static constexpr uint16_t NO_TRANSIT = 0xFFFF;
+
+    struct Transit
+    {
+        uint16_t locate;
+        uint64_t start_ns;
+        std::vector<uint8_t> stash;  // Whole messages
+    };
+
+    struct Reply
+    {
+        size_t partition;
+        uint8_t kind;
+        std::vector<uint8_t> data;
+    };
+
+    void drain();  // Receive without handling
+    void append(size_t partition, const uint8_t* msg, size_t length);
+    void send_frame(size_t partition, uint8_t kind, const uint8_t* data, size_t length);
+    void flush_partition(size_t partition);
+    void handle_reply(size_t partition, uint8_t kind, const uint8_t* data, size_t length);
+
+    Config config_;
+    std::vector<std::unique_ptr<PartitionLink>> links_;
+    std::vector<int64_t> pids_;
+    std::vector<std::vector<uint8_t>> pending_;  // Per-partition Data frame being filled
+    std::vector<uint16_t> route_;                // locate -> partition
+    std::vector<uint16_t> transit_;              // locate -> target partition, NO_TRANSIT if settled
+    std::vector<Transit> transits_;
+    bool running_ = false;
+
+    // Stats replies being gathered
+    std::vector<PartitionStats> replies_;
+    size_t replies_pending_ = 0;
+
+    Stats stats_;
+    std::vector<uint8_t> frame_;  // Receive buffer
+    std::deque<Reply> inbox_;
+    bool handling_ = false;
+};
@@ -0,0 +1,101 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bid_ask.h"
+
+// ============================================================================
+// Portfolio - positions marked to mid from BBO changes
+// ============================================================================
+//
+// Symbols are dense indices (e.g. stock locate), positions are kept
+// structure-of-arrays. Each BBO change (on_bbo from the book's BBO callback)
+// moves one symbol's mark and applies the resulting delta to the portfolio
+// totals, so a change costs O(1) however many positions are held; fills do
+// the same for quantity and cost.
+//
+// Totals are doubles, so delta updates accumulate rounding error over
+// millions of changes. recompute() rebuilds them from the arrays in one
+// pass (AVX when the build targets it, scalar otherwise) and records how far
+// the running totals had drifted; call it on a timer off the update path.
+//
+// Values are price units x shares like PreTradeRisk (1 = $0.0001). P&L is
+// mark value minus net cost, i.e. realized and unrealized together.
+// Single-threaded: call from the thread that owns the books.
+
+class Portfolio
+{
+   public:
+    struct Totals
+    {
+        double net_value = 0;    // Sum of qty x mark, shorts negative
+        double gross_value = 0;  // Sum of |qty| x mark
+        double cost = 0;         // Net cash paid: buys positive, sells negative
+
+        double pnl() const { return net_value - cost; }
+    };
+
+    struct Stats
+    {
+        uint64_t bbo_updates = 0;  // Changes that moved a mark
+        uint64_t fills = 0;
+        uint64_t recomputes = 0;
+        double last_drift = 0;  // |running P&L - recomputed P&L| at the last recompute
+        double max_drift = 0;
+    };
+
+    explicit Portfolio(size_t symbols);
+
+    // Mark to mid; a one-sided book marks to the side it has, an empty book
+    // keeps the last mark
+    void on_bbo(uint16_t symbol, const TopOfBook& top)
+    {
+        if (symbol >= symbols_) return;
+        double mid;
+        if (top.bid_qty && top.ask_qty)
+            mid = 0.5 * static_cast<double>(top.bid_price + top.ask_price);
+        else if (top.bid_qty || top.ask_qty)
+            mid = static_cast<double>(top.bid_qty ? top.bid_price : top.ask_price);
+        else
+            return;
+
+        const size_t s = symbol;
+        double move = mid - mark_[s];
+        totals_.net_value += qty_[s] * move;
+        totals_.gross_value += (qty_[s] < 0 ? -qty_[s] : qty_[s]) * move;
+        mark_[s] = mid;
+        stats_.bbo_updates++;
+    }
+
+    // Executions ('B' adds, anything else reduces). An unmarked symbol takes
+    // the fill price as its mark until the first BBO.
+    void on_fill(uint16_t symbol, char side, uint32_t qty, uint32_t price);
+
+    // Start-of-day position at an average cost; replaces any existing one
+    void set_position(uint16_t symbol, int64_t qty, double avg_price);
+
+    // Rebuild the totals from the arrays; returns the drift it corrected
+    double recompute();
+
+    const Totals& totals() const { return totals_; }
+    int64_t position(uint16_t symbol) const { return symbol < symbols_ ? static_cast<int64_t>(qty_[symbol]) : 0; }
+    double mark(uint16_t symbol) const { return symbol < symbols_ ? mark_[symbol] : 0; }
+    double pnl(uint16_t symbol) const { return symbol < symbols_ ? qty_[symbol] * mark_[symbol] - cost_[symbol] : 0; }
+    size_t symbols() const { return symbols_; }
+    const Stats& get_stats() const { return stats_; }
+
+   private:
+    void adjust(size_t s, double new_qty, double cost_change);
+
+    size_t symbols_;
+
+    // One array per field. Quantities are held as doubles (exact to 2^53
+    // shares) so the recompute kernel runs without conversions.
+    std::vector<double> qty_;
+    std::vector<double> mark_;  // 0 until marked
+    std::vector<double> cost_;
+
+    Totals totals_;
+    Stats stats_;
+};
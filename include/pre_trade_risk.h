@@ -0,0 +1,131 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bid_ask.h"
+
+// ============================================================================
+// PreTradeRisk - per-symbol order checks against live book state
+// ============================================================================
+//
+// Symbols are dense indices (e.g. stock locate). Limits and live state are
+// kept structure-of-arrays, one array per field, so a check touches one
+// element of each array it needs and bulk updates are plain loops. The price
+// band is precomputed from the BBO when it changes (on_bbo from the book's
+// BBO callback), so the order path compares against two cached bounds.
+//
+// check() evaluates every rule without early exit and ORs the failures into
+// a bitmask; an accepted order is booked as open exposure and spends one
+// rate-limit credit. Prices are ITCH 4-decimal units; notional is price
+// units x shares (1 = $0.0001). Single-threaded: call from the strategy
+// thread that owns the book.
+
+// check() reject bits
+constexpr uint32_t RISK_PRICE_BAND = 1u << 0;  // Outside [bid - band, ask + band], or no BBO
+constexpr uint32_t RISK_MAX_QUANTITY = 1u << 1;
+constexpr uint32_t RISK_MAX_NOTIONAL = 1u << 2;
+constexpr uint32_t RISK_POSITION = 1u << 3;  // Position + open orders would exceed the limit
+constexpr uint32_t RISK_ORDER_RATE = 1u << 4;
+constexpr uint32_t RISK_HALTED = 1u << 5;
+constexpr uint32_t RISK_UNKNOWN_SYMBOL = 1u << 6;
+
+struct RiskLimits
+{
+    uint32_t band_bps = 500;            // Band beyond the far touch, basis points
+    uint32_t max_order_qty = 10000;
+    uint64_t max_notional = 5000000000; // $500,000
+    int64_t max_position = 50000;       // Shares, either direction
+    uint32_t orders_per_second = 1000;  // Sustained rate
+    uint32_t burst = 20;                // Orders allowed back to back
+};
+
+class PreTradeRisk
+{
+   public:
+    static constexpr size_t REJECT_REASONS = 7;
+
+    struct Stats
+    {
+        uint64_t checks = 0;
+        uint64_t accepted = 0;
+        uint64_t rejects[REJECT_REASONS] = {};  // Per reject bit
+    };
+
+    explicit PreTradeRisk(size_t symbols);  // Default RiskLimits for every symbol
+
+    // A new band_bps applies from the symbol's next on_bbo()
+    void set_limits(uint16_t symbol, const RiskLimits& limits);
+    void set_halted(uint16_t symbol, bool halted);
+    void halt_all(bool halted);
+
+    // Reference prices from the book (raw prices, qty 0 = side empty)
+    void on_bbo(uint16_t symbol, const TopOfBook& top);
+
+    // 0 = accepted (and booked); otherwise a mask of RISK_* bits
+    uint32_t check(uint16_t symbol, char side, uint32_t qty, uint32_t price, uint64_t now_ns)
+    {
+        if (symbol >= symbols_) return reject_unknown();
+
+        const size_t s = symbol;
+        const bool buy = (side == 'B');
+        const int64_t q = qty;
+
+        // Exposure in the order's direction once it fully fills
+        int64_t projected = buy ? position_[s] + open_buy_[s] + q : open_sell_[s] + q - position_[s];
+
+        uint32_t flags = 0;
+        flags |= (static_cast<uint32_t>(price < band_lo_[s]) | static_cast<uint32_t>(price > band_hi_[s])) *
+                 RISK_PRICE_BAND;
+        flags |= static_cast<uint32_t>(qty > max_qty_[s]) * RISK_MAX_QUANTITY;
+        flags |= static_cast<uint32_t>(static_cast<uint64_t>(price) * qty > max_notional_[s]) * RISK_MAX_NOTIONAL;
+        flags |= static_cast<uint32_t>(projected > max_position_[s]) * RISK_POSITION;
+        flags |= static_cast<uint32_t>(now_ns + rate_tolerance_[s] < rate_tat_[s]) * RISK_ORDER_RATE;
+        flags |= static_cast<uint32_t>(halted_[s]) * RISK_HALTED;
+
+        stats_.checks++;
+        if (flags == 0)
+        {
+            (buy ? open_buy_[s] : open_sell_[s]) += q;
+            // GCRA: the next theoretical arrival moves one interval past max(now, tat)
+            uint64_t tat = rate_tat_[s];
+            rate_tat_[s] = (now_ns > tat ? now_ns : tat) + rate_interval_[s];
+            stats_.accepted++;
+            return 0;
+        }
+        count(flags);
+        return flags;
+    }
+
+    // Lifecycle of accepted orders: fills move open quantity into the
+    // position, done releases whatever never filled (cancel, IOC remainder)
+    void on_fill(uint16_t symbol, char side, uint32_t qty);
+    void on_done(uint16_t symbol, char side, uint32_t leaves_qty);
+
+    int64_t position(uint16_t symbol) const { return symbol < symbols_ ? position_[symbol] : 0; }
+    size_t symbols() const { return symbols_; }
+    const Stats& get_stats() const { return stats_; }
+
+   private:
+    uint32_t reject_unknown();
+    void count(uint32_t flags);
+
+    size_t symbols_;
+
+    // Limits (written by set_limits) and state, one array per field
+    std::vector<uint32_t> band_bps_;
+    std::vector<uint32_t> band_lo_;  // Precomputed from the BBO
+    std::vector<uint32_t> band_hi_;
+    std::vector<uint32_t> max_qty_;
+    std::vector<uint64_t> max_notional_;
+    std::vector<int64_t> max_position_;
+    std::vector<int64_t> position_;  // Signed, + = long
+    std::vector<int64_t> open_buy_;
+    std::vector<int64_t> open_sell_;
+    std::vector<uint64_t> rate_tat_;        // Theoretical arrival time, ns
+    std::vector<uint64_t> rate_interval_;   // ns per order
+    std::vector<uint64_t> rate_tolerance_;  // interval x (burst - 1)
+    std::vector<uint8_t> halted_;
+
+    Stats stats_;
+};
@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "orderbook.h"
+
+// ============================================================================
+// Cooperative Scheduler (many feeds/books multiplexed on one thread)
+// ============================================================================
+//
+// Stackless tasks: each call runs one slice and returns how it ended.
+// Feed tasks (DataFabric + OrderBook) yield when their fabric is empty or
+// after chunk_budget chunks, so one hot feed cannot starve the others.
+// Idle feeds cost one empty() check per pass - no clock reads, no calls
+// through std::function.
+
+class CooperativeScheduler
+{
+   public:
+    enum class TaskStatus : uint8_t
+    {
+        Yield,  // Budget spent, more work pending
+        Idle,   // Nothing to do right now
+        Done    // Remove from the run list
+    };
+
+    // Generic task body: do at most budget units of work
+    using TaskFn = std::function<TaskStatus(size_t budget, size_t& work_done)>;
+
+    struct Config
+    {
+        size_t chunk_budget = 16;  // Work units per slice before a task must yield
+    };
+
+    struct TaskStats
+    {
+        uint64_t slices = 0;         // Times the task did work
+        uint64_t idle_polls = 0;     // Times the task was visited with nothing to do
+        uint64_t budget_yields = 0;  // Slices that ended because the budget ran out
+        uint64_t work_units = 0;     // Chunks (or custom units) processed
+        uint64_t run_ns = 0;         // Total time spent inside the task
+        uint64_t max_run_ns = 0;     // Longest single slice
+        uint64_t total_wait_ns = 0;  // Sum of gaps between visits before busy slices
+        uint64_t max_wait_ns = 0;    // Worst gap between visits (scheduling latency)
+    };
+
+    CooperativeScheduler() = default;
+    explicit CooperativeScheduler(const Config& config) : config_(config) {}
+
+    // Feed task: drains fabric into book via OrderBook::process_some
+    size_t add_feed(const std::string& name, DataFabric& fabric, OrderBook& book);
+
+    // Arbitrary stackless task
+    size_t add_task(const std::string& name, TaskFn fn);
+
+    // One round-robin pass over all tasks; returns work units done
+    size_t run_once();
+
+    // Pass repeatedly until a full pass does no work
+    size_t run_until_idle();
+
+    // Called after every pass that did no work - the consumer loop's idle
+    // polling (e.g. BookWarmer::keep_warm). Keep it short: a chunk that
+    // arrives meanwhile waits for it to return.
+    using IdleFn = std::function<void()>;
+    void set_idle_callback(IdleFn fn) { idle_callback_ = std::move(fn); }
+
+    size_t task_count() const { return tasks_.size(); }
+    const std::string& task_name(size_t id) const { return tasks_[id].name; }
+    const TaskStats& get_task_stats(size_t id) const { return tasks_[id].stats; }
+    void reset_stats();
+
+    // Jain's fairness index over work done by backlogged tasks (those that hit
+    // their budget at least once); 1.0 = every backlogged task got equal service
+    double fairness_index() const;
+
+    uint64_t passes() const { return passes_; }
+    uint64_t idle_passes() const { return idle_passes_; }
+
+   private:
+    struct Task
+    {
+        std::string name;
+        DataFabric* fabric = nullptr;  // Feed task fast path
+        OrderBook* book = nullptr;
+        TaskFn fn;                     // Generic task (fabric == nullptr)
+        bool done = false;
+        uint64_t last_visit_ns = 0;
+        TaskStats stats;
+    };
+
+    Config config_;
+    std::vector<Task> tasks_;
+    uint64_t passes_ = 0;
+    uint64_t idle_passes_ = 0;
+    IdleFn idle_callback_;
+};
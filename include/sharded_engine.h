@@ -0,0 +1,106 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "orderbook.h"
+#include "spsc_ring.h"
+
+// ============================================================================
+// ShardedEngine - symbol books spread across worker threads
+// ============================================================================
+//
+// One router thread decodes and calls route(); each worker owns the books of
+// the symbols (Stock Locates) routed to it and applies messages through
+// OrderBook::handle_message. Routing starts as locate % workers.
+//
+// Live migration (migrate / rebalance):
+//   1. Router pushes Release to the old worker and Adopt to the new worker,
+//      then redirects routing. This is the sequence boundary: everything
+//      routed before it goes to the old owner, everything after to the new.
+//   2. Old worker reaches Release after applying all earlier messages and
+//      hands the book over through the migration slot.
+//   3. New worker stashes messages for that symbol until the book arrives,
+//      then applies the stash in order. Other symbols keep flowing.
+// Pause time = migrate() call until the new owner has caught up.
+
+class ShardedEngine
+{
+   public:
+    static constexpr size_t MAX_LOCATES = 1 << 16;
+
+    struct Config
+    {
+        size_t workers = 4;
+        size_t queue_capacity = 1 << 16;      // Work items per worker queue
+        double imbalance_threshold = 1.5;     // Busiest worker load / mean load that triggers a move
+        uint64_t min_window_messages = 10000;  // rebalance() waits for this much traffic
+    };
+
+    struct MigrationStats
+    {
+        size_t migrations = 0;          // Completed migrations
+        uint64_t total_pause_ns = 0;
+        uint64_t max_pause_ns = 0;
+        uint64_t last_pause_ns = 0;
+        size_t messages_stashed = 0;    // Messages held while a symbol was in transit
+    };
+
+    ShardedEngine();
+    explicit ShardedEngine(const Config& config);
+    ~ShardedEngine();
+
+    ShardedEngine(const ShardedEngine&) = delete;
+    ShardedEngine& operator=(const ShardedEngine&) = delete;
+
+    void start();
+    void stop();  // Drains queues, then joins workers
+
+    // ---- Router thread only ----
+    void route(const ITCHParser::ParseResult& msg);
+    bool migrate(uint16_t locate, size_t target_worker);
+
+    // Move one symbol off the busiest worker if the current window is
+    // imbalanced and no migration is in flight; resets the rate window.
+    // Returns true if a move started.
+    bool rebalance();
+
+    // Block until every routed message (and migration) has been applied
+    void flush();
+
+    size_t worker_count() const { return workers_.size(); }
+    size_t owner(uint16_t locate) const { return route_[locate]; }
+
+    // ---- Valid only after flush() ----
+    const OrderBook* find_book(uint16_t locate) const;
+    uint64_t worker_messages(size_t worker) const;
+    MigrationStats get_migration_stats() const;
+
+   private:
+    struct SymbolBook;
+    struct Migration;
+    struct WorkItem;
+    struct Worker;
+
+    void worker_loop(Worker& worker);
+    void handle_item(Worker& worker, const WorkItem& item);
+    bool poll_pending(Worker& worker);
+    void apply(Worker& worker, const ITCHParser::ParseResult& msg);
+    void push(size_t worker, const WorkItem& item);
+
+    Config config_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<uint16_t> route_;  // locate -> worker (router-owned)
+    std::atomic<bool> stop_{false};
+    bool running_ = false;
+
+    // Per-symbol message rates for the current window (router-owned)
+    std::vector<uint64_t> window_counts_;
+    std::vector<uint16_t> active_locates_;
+    uint64_t window_total_ = 0;
+
+    std::vector<std::unique_ptr<Migration>> migrations_;
+};
@@ -0,0 +1,80 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// ============================================================================
+// SpscRing - bounded lock-free single-producer / single-consumer queue
+// ============================================================================
+//
+// Capacity is rounded up to a power of two. Head and tail live on separate
+// cache lines and each side caches the other's index, so the steady state
+// touches no shared line except when the cached view runs out.
+
+template <typename T>
+class SpscRing
+{
+   public:
+    explicit SpscRing(size_t capacity)
+    {
+        size_t rounded = 2;
+        while (rounded < capacity) rounded <<= 1;
+        slots_.resize(rounded);
+        mask_ = rounded - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer side - returns false when full (backpressure)
+    bool try_push(const T& item)
+    {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ > mask_)
+        {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ > mask_) return false;
+        }
+        slots_[tail & mask_] = item;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side - returns false when empty. Swaps rather than copies:
+    // the slot keeps out's previous value (for a vector, its buffer), which
+    // the producer's next try_push into that slot reuses - no copy on pop,
+    // no allocation in the steady state.
+    bool try_pop(T& out)
+    {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_)
+        {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_) return false;
+        }
+        using std::swap;
+        swap(out, slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate when called from a third thread
+    size_t size() const
+    {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+    size_t capacity() const { return mask_ + 1; }
+
+   private:
+    std::vector<T> slots_;
+    size_t mask_ = 0;
+
+    alignas(64) std::atomic<size_t> head_{0};  // Consumer-owned
+    size_t tail_cache_ = 0;                    // Consumer's view of tail_
+
+    alignas(64) std::atomic<size_t> tail_{0};  // Producer-owned
+    size_t head_cache_ = 0;                    // Producer's view of head_
+};
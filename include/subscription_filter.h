@@ -0,0 +1,93 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "orderbook.h"
+
+// ============================================================================
+// SubscriptionFilter - drop unsubscribed symbols ahead of the book
+// ============================================================================
+//
+// Adds ('A'/'F') pass only for subscribed Stock Locates. The order id of
+// every dropped add goes into a paged bitmap over the id space, so follow-on
+// messages ('E', 'X', 'U') for those ids are rejected with one bit test
+// before the book does any hash-table work. A replace of a dropped order
+// drops its new id too. Follow-ons are matched by id, not locate, so the
+// filter also works on normalized feeds that do not carry locates on them.
+//
+// ITCH order ids are assigned sequentially through the day, so pages (64K ids,
+// 8 KB each) fill densely. Ids beyond MAX_PAGES pages fall back to a hash set.
+
+class SubscriptionFilter
+{
+   public:
+    static constexpr size_t MAX_LOCATES = 1 << 16;
+    static constexpr size_t PAGE_BITS = 1 << 16;  // Ids per bitmap page
+    static constexpr size_t MAX_PAGES = 1 << 16;  // Bitmap covers ids < 2^32
+
+    struct FilterStats
+    {
+        size_t passed = 0;
+        size_t dropped_adds = 0;
+        size_t dropped_followups = 0;  // E/X/U rejected by the id bitmap
+        size_t bitmap_pages = 0;
+        size_t overflow_ids = 0;       // Dropped ids kept in the fallback set
+    };
+
+    SubscriptionFilter() : locates_(MAX_LOCATES / 64, 0) {}
+
+    void subscribe(uint16_t locate) { locates_[locate >> 6] |= 1ULL << (locate & 63); }
+    void unsubscribe(uint16_t locate) { locates_[locate >> 6] &= ~(1ULL << (locate & 63)); }
+    bool subscribed(uint16_t locate) const { return (locates_[locate >> 6] >> (locate & 63)) & 1; }
+
+    // True if the message should reach the book
+    bool accept(const ITCHParser::ParseResult& msg)
+    {
+        switch (msg.type)
+        {
+            case 'A':
+            case 'F':
+                if (subscribed(msg.locate)) break;
+                mark_dropped(msg.order_id);
+                stats_.dropped_adds++;
+                return false;
+
+            case 'E':
+            case 'X':
+                if (!is_dropped(msg.order_id)) break;
+                stats_.dropped_followups++;
+                return false;
+
+            case 'U':
+                if (!is_dropped(msg.order_id)) break;
+                mark_dropped(msg.new_order_id);
+                stats_.dropped_followups++;
+                return false;
+        }
+        stats_.passed++;
+        return true;
+    }
+
+    bool is_dropped(uint64_t order_id) const
+    {
+        uint64_t page = order_id / PAGE_BITS;
+        if (page >= MAX_PAGES) return !overflow_.empty() && overflow_.count(order_id) != 0;
+        if (page >= pages_.size() || !pages_[page]) return false;
+        uint64_t bit = order_id % PAGE_BITS;
+        return (pages_[page][bit >> 6] >> (bit & 63)) & 1;
+    }
+
+    const FilterStats& get_stats() const { return stats_; }
+    size_t memory_bytes() const { return stats_.bitmap_pages * PAGE_BITS / 8; }
+
+   private:
+    void mark_dropped(uint64_t order_id);
+
+    std::vector<uint64_t> locates_;                    // Subscription bitset
+    std::vector<std::unique_ptr<uint64_t[]>> pages_;   // Dropped-id bitmap, allocated on demand
+    std::unordered_set<uint64_t> overflow_;            // Dropped ids >= MAX_PAGES * PAGE_BITS
+    FilterStats stats_;
+};
@@ -0,0 +1,193 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "order_index.h"
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// ============================================================================
+// SymbolTable - 8-byte stock fields interned to dense symbol indices
+// ============================================================================
+//
+// For feeds whose Stock Locate is missing or not usable: the space-padded
+// Stock field of an add is loaded as one uint64 key (key(), also in
+// ParseResult::stock) and resolved to a dense index starting at 1, so books
+// can be kept in a vector exactly as with locates. 0 = NONE. Only adds carry
+// a Stock field; OrderSymbols below routes the X/E/U that follow them.
+//
+// Open addressing over 64-byte groups of eight keys: a key hashes to a
+// group, and one probe compares all eight slots at once (AVX-512: one
+// compare; AVX2: two; otherwise a plain loop), plus the same test against
+// the empty key 0. A group with an empty slot ends the search, so a lookup
+// almost always touches one cache line of keys and one id. The table stays
+// at most half full and doubles on insert. Single-threaded.
+
+class SymbolTable
+{
+   public:
+    static constexpr uint16_t NONE = 0;
+    static constexpr size_t MAX_SYMBOLS = 65535;
+
+    // The Stock field as a key (native byte order, as ParseResult::stock)
+    static uint64_t key(const uint8_t* stock)
+    {
+        uint64_t k;
+        std::memcpy(&k, stock, sizeof(k));
+        return k;
+    }
+    static uint64_t key(const char* symbol);  // Up to 8 characters, space padded
+
+    explicit SymbolTable(size_t expected_symbols = 1024);
+
+    // Existing or new index; NONE when full or for the all-zero key
+    uint16_t intern(uint64_t key);
+
+    // NONE if the key was never interned
+    uint16_t find(uint64_t key) const
+    {
+        size_t group = static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> shift_);
+        while (true)
+        {
+            uint32_t hit = 0;
+            uint32_t empty = 0;
+            match(groups_[group], key, hit, empty);
+            if (hit) return ids_[group * GROUP + lowest_bit(hit)];
+            if (empty) return NONE;
+            group = (group + 1) & (groups_.size() - 1);
+        }
+    }
+
+    uint64_t key_of(uint16_t id) const { return id < keys_.size() ? keys_[id] : 0; }
+    std::string name(uint16_t id) const;  // Padding trimmed; "" for NONE
+    size_t size() const { return keys_.size() - 1; }
+
+    // Which probe the build compiled in: "avx512", "avx2" or "scalar"
+    static const char* probe_isa();
+
+   private:
+    static constexpr size_t GROUP = 8;
+
+    struct alignas(64) Group
+    {
+        uint64_t keys[GROUP];  // 0 = empty
+    };
+
+    // Bit i of hit / empty: slot i holds key / is empty
+    static void match(const Group& g, uint64_t key, uint32_t& hit, uint32_t& empty)
+    {
+#if defined(__AVX512F__)
+        __m512i slots = _mm512_load_si512(g.keys);
+        hit = _mm512_cmpeq_epi64_mask(slots, _mm512_set1_epi64(static_cast<long long>(key)));
+        empty = _mm512_testn_epi64_mask(slots, slots);
+#elif defined(__AVX2__)
+        const __m256i want = _mm256_set1_epi64x(static_cast<long long>(key));
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i lo = _mm256_load_si256(reinterpret_cast<const __m256i*>(g.keys));
+        __m256i hi = _mm256_load_si256(reinterpret_cast<const __m256i*>(g.keys + 4));
+        hit = static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(lo, want)))) |
+              static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(hi, want)))) << 4;
+        empty = static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(lo, zero)))) |
+                static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(hi, zero)))) << 4;
+#else
+        for (size_t i = 0; i < GROUP; ++i)
+        {
+            hit |= static_cast<uint32_t>(g.keys[i] == key) << i;
+            empty |= static_cast<uint32_t>(g.keys[i] == 0) << i;
+        }
+#endif
+    }
+
+    static size_t lowest_bit(uint32_t mask)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return index;
+#else
+        return static_cast<size_t>(__builtin_ctz(mask));
+#endif
+    }
+
+    void rebuild(size_t groups);
+    void place(uint64_t key, uint16_t id);
+
+    std::vector<Group> groups_;
+    std::vector<uint16_t> ids_;    // GROUP per group, parallel to the keys
+    std::vector<uint64_t> keys_{0};  // Index -> key; index 0 reserved for NONE
+    unsigned shift_ = 64;
+};
+
+// ============================================================================
+// OrderSymbols - order id -> symbol index for messages without a Stock field
+// ============================================================================
+//
+// Cancels, executes and replaces carry only an order id. route() resolves an
+// add's Stock field through a SymbolTable and remembers the index under the
+// order id; X/E/U then take it from there. The entry follows the order the
+// way the book does: X and an execute of the remaining quantity forget it, U
+// moves it to the new id. Adds for keys the table does not know (not
+// interned) are not remembered, so their X/E/U return NONE as well.
+// Entries live in an OrderIndex (no rehash stalls); single-threaded.
+
+class OrderSymbols
+{
+   public:
+    explicit OrderSymbols(size_t expected_orders = 0) { orders_.reserve(expected_orders); }
+
+    // Symbol index for a parsed message (ITCHParser::ParseResult or anything
+    // with its fields); NONE for an unknown stock or order id
+    template <typename Msg>
+    uint16_t route(const SymbolTable& symbols, const Msg& msg)
+    {
+        switch (msg.type)
+        {
+            case 'A':
+            case 'F':
+            {
+                uint16_t symbol = symbols.find(msg.stock);
+                if (symbol != SymbolTable::NONE) on_add(msg.order_id, symbol, msg.quantity);
+                return symbol;
+            }
+            case 'X':
+                return on_cancel(msg.order_id);
+            case 'E':
+                return on_execute(msg.order_id, msg.quantity);
+            case 'U':
+                return on_replace(msg.order_id, msg.new_order_id, msg.quantity);
+            default:
+                return SymbolTable::NONE;
+        }
+    }
+
+    void on_add(uint64_t order_id, uint16_t symbol, uint32_t quantity);
+    uint16_t on_cancel(uint64_t order_id);
+    uint16_t on_execute(uint64_t order_id, uint32_t quantity);
+    uint16_t on_replace(uint64_t old_order_id, uint64_t new_order_id, uint32_t quantity);
+
+    // Without changing anything; NONE if the order is not resting
+    uint16_t find(uint64_t order_id) const
+    {
+        auto it = orders_.find(order_id);
+        return it != orders_.end() ? it->second.symbol : SymbolTable::NONE;
+    }
+
+    size_t size() const { return orders_.size(); }
+
+   private:
+    struct Entry
+    {
+        uint32_t quantity;  // Remaining, so a full execute can forget the order
+        uint16_t symbol;
+    };
+
+    OrderIndex<Entry> orders_;
+};
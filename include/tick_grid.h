@@ -0,0 +1,168 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// ============================================================================
+// TickGrid - price <-> tick index without division
+// ============================================================================
+//
+// A grid is up to MAX_BANDS bands, each starting at a price (4-decimal ITCH
+// units) with its own tick size. Tick indices are dense across bands, so a
+// book keyed by tick index has no holes between valid prices.
+//
+// Division by the tick size is a multiply and shift with a constant picked
+// at compile time; it is exact for every 32-bit price. Tick sizes with no
+// 32-bit magic (7, 14, 19, ...) use a 33-bit one: one more add and shift.
+
+struct TickBand
+{
+    uint32_t start_price;  // First price of the band (must lie on the previous band's grid)
+    uint32_t tick;         // Tick size in price units
+};
+
+class TickGrid
+{
+   public:
+    static constexpr size_t MAX_BANDS = 4;
+
+    template <size_t N>
+    constexpr explicit TickGrid(const TickBand (&bands)[N])
+    {
+        static_assert(N >= 1 && N <= MAX_BANDS, "TickGrid supports 1-4 bands");
+        uint32_t index = 0;
+        for (size_t i = 0; i < N; ++i)
+        {
+            if (i > 0 && bands[i - 1].tick != 0)
+            {
+                index += (bands[i].start_price - bands[i - 1].start_price) / bands[i - 1].tick;
+            }
+            bands_[i] = make_band(bands[i], index);
+        }
+        count_ = N;
+    }
+
+    // False if price is not on the grid (tick_out untouched)
+    constexpr bool to_tick(uint32_t price, uint32_t& tick_out) const
+    {
+        const Band& band = band_for_price(price);
+        uint32_t offset = price - band.start_price;
+        uint64_t product = static_cast<uint64_t>(offset) * band.magic;
+        uint32_t steps = static_cast<uint32_t>(product >> band.shift);
+        if (band.add)
+        {
+            uint32_t high = static_cast<uint32_t>(product >> 32);
+            steps = (high + ((offset - high) >> 1)) >> band.shift;
+        }
+        if (steps * band.tick != offset) return false;
+        tick_out = band.start_index + steps;
+        return true;
+    }
+
+    constexpr uint32_t to_price(uint32_t tick) const
+    {
+        size_t i = count_ - 1;
+        while (i > 0 && tick < bands_[i].start_index) --i;
+        return bands_[i].start_price + (tick - bands_[i].start_index) * bands_[i].tick;
+    }
+
+    constexpr size_t band_count() const { return count_; }
+
+    // Nonzero ticks, rising band starts, a divisor for every band
+    constexpr bool valid() const
+    {
+        for (size_t i = 0; i < count_; ++i)
+        {
+            if (bands_[i].tick == 0 || bands_[i].magic == 0) return false;
+            if (i > 0 && bands_[i].start_price <= bands_[i - 1].start_price) return false;
+        }
+        return count_ > 0;
+    }
+
+   private:
+    struct Band
+    {
+        uint32_t start_price = 0;
+        uint32_t tick = 1;
+        uint32_t start_index = 0;
+        uint32_t magic = 1;
+        uint32_t shift = 0;
+        bool add = false;  // 33-bit magic 2^32 + magic: add-and-shift fixup
+    };
+
+    // Smallest shift s with m = ceil(2^s / d) < 2^32 and (m*d - 2^s) <= 2^(s-32):
+    // then floor(n*m / 2^s) == n / d for every 32-bit n. Without one, the
+    // Granlund-Montgomery 33-bit magic: with l = ceil(log2 d) and
+    // m = floor(2^32 * (2^l - d) / d) + 1, hi = n*m >> 32 and
+    // n / d == (hi + ((n - hi) >> 1)) >> (l - 1)
+    static constexpr Band make_band(const TickBand& in, uint32_t start_index)
+    {
+        Band band;
+        band.start_price = in.start_price;
+        band.tick = in.tick;
+        band.start_index = start_index;
+        if (in.tick == 0) band.magic = 0;  // Rejected by valid()
+        if (in.tick <= 1) return band;     // Identity: magic 1, shift 0
+
+        for (uint32_t s = 32; s < 64; ++s)
+        {
+            uint64_t pow = 1ULL << s;
+            uint64_t m = pow / in.tick + (pow % in.tick ? 1 : 0);
+            if (m >= (1ULL << 32)) break;
+            if (m * in.tick - pow <= (1ULL << (s - 32)))
+            {
+                band.magic = static_cast<uint32_t>(m);
+                band.shift = s;
+                return band;
+            }
+        }
+        uint32_t l = 1;
+        while ((1ULL << l) < in.tick) ++l;
+        band.magic = static_cast<uint32_t>(((1ULL << 32) * ((1ULL << l) - in.tick)) / in.tick + 1);
+        band.shift = l - 1;
+        band.add = true;
+        return band;
+    }
+
+    constexpr const Band& band_for_price(uint32_t price) const
+    {
+        size_t i = count_ - 1;
+        while (i > 0 && price < bands_[i].start_price) --i;
+        return bands_[i];
+    }
+
+    Band bands_[MAX_BANDS] = {};
+    size_t count_ = 0;
+};
+
+// ============================================================================
+// Standard Grids
+// ============================================================================
+
+namespace TickGrids
+{
+// Reg NMS Rule 612: $0.0001 below $1.00, $0.01 from $1.00
+inline constexpr TickBand REG_NMS_BANDS[] = {{0, 1}, {10000, 100}};
+inline constexpr TickGrid REG_NMS{REG_NMS_BANDS};
+
+// One cent everywhere (e.g. symbols quoted only in pennies)
+inline constexpr TickBand PENNY_BANDS[] = {{0, 100}};
+inline constexpr TickGrid PENNY{PENNY_BANDS};
+}  // namespace TickGrids
+
+// Compile-time spot checks of the multiply-shift path
+static_assert([] {
+    uint32_t tick = 0;
+    return TickGrids::REG_NMS.to_tick(9999, tick) && tick == 9999 &&
+           TickGrids::REG_NMS.to_tick(10000, tick) && tick == 10000 &&
+           TickGrids::REG_NMS.to_tick(4294967200u, tick) && TickGrids::REG_NMS.to_price(tick) == 4294967200u &&
+           !TickGrids::REG_NMS.to_tick(10050, tick) && TickGrids::REG_NMS.to_price(10001) == 10100;
+}(), "REG_NMS grid");
+
+// ...and of the 33-bit fixup (7 has no 32-bit magic)
+static_assert([] {
+    constexpr TickBand bands[] = {{0, 7}};
+    constexpr TickGrid grid{bands};
+    uint32_t tick = 0;
+    return grid.valid() && grid.to_tick(7, tick) && tick == 1 && grid.to_tick(4294967292u, tick) &&
+           tick == 613566756u && !grid.to_tick(4294967295u, tick) && !grid.to_tick(8, tick);
+}(), "33-bit magic");
@@ -0,0 +1,108 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "bid_ask.h"
+
+// ============================================================================
+// TriggerIndex - conditional notifications keyed by side and price
+// ============================================================================
+//
+// One-shot conditions registered by strategies and evaluated by
+// OrderBookEngine only where a change can satisfy them:
+//   BestPrice      - best bid >= price / best ask <= price; checked on a
+//                    change of that side's best price
+//   LevelSizeBelow - level total < threshold after a change at that level
+//                    (removal counts as 0); checked on changes at that level
+//   SpreadAbove    - ask - bid > threshold (negative when crossed); checked
+//                    on a BBO price change
+// Thresholds are kept sorted, so an update that fires nothing costs one
+// comparison per structure, and one that fires k triggers costs O(k).
+// Prices are engine keys (raw prices, or tick indices in tick mode).
+//
+// Fired triggers are removed before their callbacks run, so a callback may
+// register or remove triggers freely.
+
+class TriggerIndex
+{
+   public:
+    enum class Kind : uint8_t { BestPrice, LevelSizeBelow, SpreadAbove };
+
+    struct Fired
+    {
+        uint32_t id;
+        uint64_t tag;    // As passed at registration
+        Kind kind;
+        Side side;       // Unused for SpreadAbove
+        uint32_t price;  // Best price (BestPrice), level price (LevelSizeBelow)
+        int64_t value;   // Level total (LevelSizeBelow), spread (SpreadAbove)
+    };
+
+    using FireCallback = std::function<void(const Fired&)>;
+
+    struct Stats
+    {
+        size_t registered = 0;  // Currently armed
+        size_t fired = 0;
+        size_t removed = 0;
+        size_t evaluations = 0;  // Updates that reached a non-empty structure
+    };
+
+    void set_callback(FireCallback cb) { callback_ = std::move(cb); }
+
+    // Ids start at 1. tag is returned in Fired - a trigger may fire before
+    // the caller has seen its id (already satisfied at registration)
+    uint32_t add_best_price(Side side, uint32_t price, uint64_t tag = 0);
+    uint32_t add_level_size_below(Side side, uint32_t price, uint64_t threshold, uint64_t tag = 0);
+    uint32_t add_spread_above(int64_t threshold, uint64_t tag = 0);
+    bool remove(uint32_t id);
+
+    bool empty() const { return entries_.empty(); }
+    bool has_level_triggers() const { return !levels_.empty(); }
+    const Stats& get_stats() const { return stats_; }
+
+    // ---- Evaluation (OrderBookEngine) ----
+    // on_* collect what fires against one book state; deliver() then runs
+    // the callbacks, so triggers registered from a callback are not checked
+    // against the state that fired their predecessors.
+    void on_best_price(Side side, uint32_t best);
+    void on_spread(int64_t spread);
+    void on_level(Side side, uint32_t price, uint64_t total);
+    void deliver();
+
+   private:
+    struct Entry
+    {
+        Kind kind;
+        Side side;
+        uint32_t price;
+        int64_t threshold;
+        uint64_t tag;
+    };
+
+    // Rank so that "at or better than" is <= on both sides
+    static uint32_t rank(Side side, uint32_t price) { return side == Side::Bid ? price : ~price; }
+    static uint64_t level_key(Side side, uint32_t price)
+    {
+        return (static_cast<uint64_t>(price) << 1) | static_cast<uint64_t>(side);
+    }
+
+    uint32_t arm(const Entry& entry);
+    void fire(uint32_t id, Kind kind, Side side, uint32_t price, int64_t value);
+
+    std::unordered_map<uint32_t, Entry> entries_;
+    std::multimap<uint32_t, uint32_t> best_[2];  // rank(trigger price) -> id
+    std::multimap<int64_t, uint32_t> spread_;    // threshold -> id
+    // (side, price) -> (threshold, id), ascending by threshold
+    std::unordered_map<uint64_t, std::vector<std::pair<uint64_t, uint32_t>>> levels_;
+
+    std::vector<Fired> pending_;  // Fired, not yet delivered
+    FireCallback callback_;
+    uint32_t next_id_ = 1;
+    Stats stats_;
+};
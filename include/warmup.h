@@ -0,0 +1,90 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "orderbook.h"
+
+// ============================================================================
+// BookWarmer - pre-open warm-up and idle keep-warm through a shadow book
+// ============================================================================
+//
+// The first messages of a session, or the first after a quiet spell, pay for
+// cold caches, TLBs and branch predictors, and for whatever the book builds
+// lazily (index buckets, node slabs, level storage) on the critical path.
+//
+// warm_up() runs before the session: it reserve()s the live book, then
+// drives a synthetic script - adds ('A' and 'F') building both sides over a
+// band of levels, executes, cancels and replaces, then cancels to empty -
+// through a private DataFabric + OrderBook, one message per chunk exactly as
+// a feed arrives. Same code, discarded results: the live book never sees a
+// synthetic order. Configure shadow() like the live book (tick grid, layout,
+// retention) so the same branches are trained; script prices are mid_price
+// +- k * tick.
+//
+// keep_warm() is for idle polling in the consumer loop (e.g. the
+// CooperativeScheduler idle callback): it feeds the next few script messages
+// to the shadow and reads the live book's touch, so code and the hot lines
+// stay resident. Rate limited to one run per keep_warm_interval_ns, at a cost
+// of one clock read per skipped call; a message that arrives during a run
+// waits at most keep_warm_messages shadow messages. Single-threaded: call from
+// the thread that owns the live book.
+
+class BookWarmer
+{
+   public:
+    struct Config
+    {
+        size_t orders = 2048;        // Resting orders the script builds up per cycle
+        size_t levels = 32;          // Price levels per side
+        uint32_t mid_price = 10000;  // Raw; bids below, asks above
+        uint32_t tick = 1;           // Raw price step between levels
+        size_t warm_up_cycles = 8;   // Script passes in warm_up()
+        size_t reserve_orders = 0;   // Live book reserve() in warm_up(); 0 = skip
+        size_t reserve_levels = 64;
+        size_t keep_warm_messages = 16;         // Shadow messages per keep_warm() run
+        uint64_t keep_warm_interval_ns = 20000;  // Minimum gap between runs
+        uint64_t seed = 42;
+    };
+
+    struct Stats
+    {
+        uint64_t warm_up_messages = 0;
+        uint64_t warm_up_ns = 0;
+        uint64_t keep_warm_runs = 0;
+        uint64_t keep_warm_skipped = 0;  // Calls inside the interval
+        uint64_t keep_warm_messages = 0;
+        uint64_t keep_warm_ns = 0;
+        uint64_t shadow_errors = 0;  // Invalid operations in the shadow; 0 unless misconfigured
+    };
+
+    BookWarmer();
+    explicit BookWarmer(const Config& config);
+
+    BookWarmer(const BookWarmer&) = delete;
+    BookWarmer& operator=(const BookWarmer&) = delete;
+
+    // Before the session. live (optional) is reserved and its read path touched.
+    void warm_up(OrderBook* live = nullptr);
+
+    // Idle polling; true if it ran, false if inside the interval
+    bool keep_warm(const OrderBook* live = nullptr);
+
+    OrderBook& shadow() { return shadow_; }
+    size_t script_length() const { return script_.size(); }  // Messages per cycle
+    const Stats& get_stats() const { return stats_; }
+
+   private:
+    void build_script();
+    void feed(size_t messages);  // Next script messages through the shadow, wrapping
+    void touch(const OrderBook& live);
+
+    Config config_;
+    DataFabric fabric_;
+    OrderBook shadow_;
+    std::vector<DataFabric::Chunk> script_;  // One cycle, empty book to empty book
+    size_t cursor_ = 0;
+    uint64_t last_run_ns_ = 0;
+    uint64_t touched_ = 0;  // Sink for the live reads
+    Stats stats_;
+};
@@ -1,38 +1,259 @@
 #include "bid_ask.h"
 
+#include <algorithm>
+#include <cstdint>
+
+#include "trigger_index.h"
+
+// ============================================================================
+// OrderNodePool Implementation
+// ============================================================================
+
+OrderNode* OrderNodePool::allocate(uint64_t order_id, uint64_t qty) {
+    if (!free_) {
+        size_t count = capacity_ ? capacity_ : FIRST_SLAB;
+        grow(count > MAX_SLAB ? MAX_SLAB : count);
+    }
+
+    OrderNode* node = free_;
+    free_ = node->next;
+    *node = OrderNode{order_id, qty, nullptr, nullptr};
+    return node;
+}
+
+void OrderNodePool::release(OrderNode* node) {
+    node->next = free_;
+    free_ = node;
+}
+
+void OrderNodePool::reserve(size_t nodes) {
+    while (capacity_ < nodes) {
+        size_t count = nodes - capacity_;
+        grow(count > MAX_SLAB ? MAX_SLAB : count);
+    }
+}
+
+// New slab linked in front of the free list
+void OrderNodePool::grow(size_t count) {
+    slabs_.emplace_back(new OrderNode[count]);
+    OrderNode* slab = slabs_.back().get();
+    for (size_t i = 0; i < count; ++i) {
+        slab[i].next = (i + 1 < count) ? &slab[i + 1] : free_;
+    }
+    free_ = slab;
+    capacity_ += count;
+}
+
 // ============================================================================
 // BookSide Implementation
 // ============================================================================
 
-OrderNode* BookSide::addOrder(uint64_t order_id, uint64_t price, uint64_t qty) {
-    PriceLevel& level = getOrCreateLevel(price);
+void BookSide::setLayoutConfig(const LayoutConfig& config) {
+    config_ = config;
+    if (config_.demote_levels > config_.promote_levels) {
+        config_.demote_levels = config_.promote_levels;
+    }
 
-    OrderNode* node = new OrderNode{order_id, qty, nullptr, nullptr};
+    // Apply the new thresholds to the current depth straight away
+    if (layout_ == BookLayout::Thin && thin_.size() > config_.promote_levels) {
+        promote();
+    } else if (layout_ != BookLayout::Thin && storedLevels() < config_.demote_levels) {
+        demote();
+    } else if (layout_ == BookLayout::Ladder && ladder_.size() > config_.ladder_span) {
+        spill();
+    }
+}
 
-    // FIFO enqueue at tail
-    if (!level.tail) {
-        level.head = node;
-        level.tail = node;
-    } else {
-        level.tail->next = node;
-        node->prev = level.tail;
-        level.tail = node;
+void BookSide::setRetention(const LevelRetention& retention) {
+    retention_ = retention;
+    while (retained_.size() > retention_.max_empty) reclaimOldest();
+}
+
+size_t BookSide::thinSlot(uint32_t price) const {
+    size_t i = thin_.size();
+    while (i > 0 && better(thin_[i - 1].price, price)) --i;
+    return i;
+}
+
+bool BookSide::hasLevel(uint32_t price) const {
+    if (layout_ == BookLayout::Ladder) {
+        const PriceLevel* level = ladderSlot(price);
+        return level && level->head;
+    }
+    if (layout_ == BookLayout::Thick) {
+        auto it = levels_.find(price);
+        return it != levels_.end() && it->second.head;
     }
+    size_t i = thinSlot(price);
+    return i > 0 && thin_[i - 1].price == price && thin_[i - 1].head;
+}
 
-    level.total_qty += qty;
-    return node;
+uint64_t BookSide::levelQuantity(uint32_t price) const {
+    if (layout_ == BookLayout::Ladder) {
+        const PriceLevel* level = ladderSlot(price);
+        return level ? level->total_qty : 0;
+    }
+    if (layout_ == BookLayout::Thick) {
+        auto it = levels_.find(price);
+        return (it == levels_.end()) ? 0 : it->second.total_qty;
+    }
+    size_t i = thinSlot(price);
+    return (i > 0 && thin_[i - 1].price == price) ? thin_[i - 1].total_qty : 0;
 }
 
-void BookSide::cancelOrder(OrderNode* node, uint64_t price) {
-    if (!node) return;
+PriceLevel* BookSide::findLevel(uint32_t price) {
+    if (layout_ == BookLayout::Ladder) return ladderSlot(price);
+    if (layout_ == BookLayout::Thick) {
+        auto it = levels_.find(price);
+        return (it == levels_.end()) ? nullptr : &it->second;
+    }
+    size_t i = thinSlot(price);
+    return (i > 0 && thin_[i - 1].price == price) ? &thin_[i - 1] : nullptr;
+}
 
-    auto it = levels_.find(price);
-    if (it == levels_.end()) return;
+const PriceLevel* BookSide::bestLevel() const {
+    if (live_ == 0) return nullptr;
+    if (layout_ == BookLayout::Ladder) return &ladder_[bestKey_ - base_];
 
-    PriceLevel& level = it->second;
-    level.total_qty -= node->quantity;
+    // At most retained_.size() empty levels sit in front of the best live one
+    if (layout_ == BookLayout::Thin) {
+        auto it = thin_.rbegin();
+        while (!it->head) ++it;
+        return &*it;
+    }
+    if (side_ == Side::Bid) {
+        auto it = levels_.rbegin();
+        while (!it->second.head) ++it;
+        return &it->second;
+    }
+    auto it = levels_.begin();
+    while (!it->second.head) ++it;
+    return &it->second;
+}
 
-    // Unlink from doubly-linked FIFO
+PriceLevel& BookSide::getOrCreateLevel(uint32_t price) {
+    if (layout_ == BookLayout::Ladder) {
+        PriceLevel* level = ladderSlot(price);
+        if (!level) {
+            if (!growLadder(price)) {
+                spill();
+                return getOrCreateLevel(price);
+            }
+            level = ladderSlot(price);
+        }
+        if (!level->head) {
+            reuse_.created++;
+            if (live_ == 0 || better(price, bestKey_)) bestKey_ = price;
+        }
+        return *level;
+    }
+    if (layout_ == BookLayout::Thick) {
+        auto it = levels_.find(price);
+        if (it == levels_.end()) {
+            it = levels_.emplace(price, PriceLevel(price)).first;
+            reuse_.created++;
+        } else if (!it->second.head) {
+            revive(price);
+        }
+        return it->second;
+    }
+
+    size_t i = thinSlot(price);
+    if (i > 0 && thin_[i - 1].price == price) {
+        if (!thin_[i - 1].head) revive(price);
+        return thin_[i - 1];
+    }
+
+    reuse_.created++;
+    thin_.insert(thin_.begin() + static_cast<std::ptrdiff_t>(i), PriceLevel(price));
+    if (thin_.size() > config_.promote_levels) {
+        promote();
+        if (layout_ == BookLayout::Ladder) {
+            if (live_ == 0 || better(price, bestKey_)) bestKey_ = price;
+            return *ladderSlot(price);
+        }
+        return levels_.find(price)->second;
+    }
+    return thin_[i];
+}
+
+void BookSide::eraseLevel(uint32_t price) {
+    if (layout_ == BookLayout::Thick) {
+        levels_.erase(price);
+        if (levels_.size() < config_.demote_levels) demote();
+        return;
+    }
+
+    size_t i = thinSlot(price);
+    if (i > 0 && thin_[i - 1].price == price) {
+        thin_.erase(thin_.begin() + static_cast<std::ptrdiff_t>(i - 1));
+    }
+}
+
+void BookSide::levelEmptied(uint32_t price) {
+    live_--;
+    if (layout_ == BookLayout::Ladder) {
+        // The slot stays; only the best key may move
+        if (live_ < config_.demote_levels) {
+            demote();
+        } else if (live_ > 0 && price == bestKey_) {
+            size_t i = price - base_;
+            if (side_ == Side::Bid) {
+                while (!ladder_[--i].head) {}
+            } else {
+                while (!ladder_[++i].head) {}
+            }
+            bestKey_ = ladder_[i].price;
+        }
+        return;
+    }
+    if (retention_.max_empty == 0 || !withinDepth(price)) {
+        eraseLevel(price);
+        return;
+    }
+    if (retained_.size() >= retention_.max_empty) reclaimOldest();
+    retained_.emplace_back(price, ops_);
+    reuse_.held = retained_.size();
+}
+
+void BookSide::revive(uint32_t price) {
+    for (auto it = retained_.begin(); it != retained_.end(); ++it) {
+        if (it->first == price) {
+            retained_.erase(it);
+            break;
+        }
+    }
+    reuse_.revived++;
+    reuse_.held = retained_.size();
+}
+
+void BookSide::reclaimOldest() {
+    uint32_t price = retained_.front().first;
+    retained_.erase(retained_.begin());
+    eraseLevel(price);
+    reuse_.reclaimed++;
+    reuse_.held = retained_.size();
+}
+
+bool BookSide::withinDepth(uint32_t price) const {
+    size_t n = 0;
+    if (layout_ == BookLayout::Thin) {
+        for (auto it = thin_.rbegin(); it != thin_.rend() && n < retention_.max_depth; ++it, ++n) {
+            if (it->price == price) return true;
+        }
+    } else if (side_ == Side::Bid) {
+        for (auto it = levels_.rbegin(); it != levels_.rend() && n < retention_.max_depth; ++it, ++n) {
+            if (it->first == price) return true;
+        }
+    } else {
+        for (auto it = levels_.begin(); it != levels_.end() && n < retention_.max_depth; ++it, ++n) {
+            if (it->first == price) return true;
+        }
+    }
+    return false;
+}
+
+void BookSide::unlink(PriceLevel& level, OrderNode* node) {
     if (node->prev) {
         node->prev->next = node->next;
     } else {
@@ -43,46 +264,167 @@ void BookSide::cancelOrder(OrderNode* node, uint64_t price) {
     } else {
         level.tail = node->prev;
     }
+    pool_.release(node);
+}
 
-    delete node;
+void BookSide::promote() {
+    promotions_++;
+    if (dense_ && !thin_.empty()) {
+        // thin_ is worst..best, so its ends bound the key range
+        uint32_t lo = std::min(thin_.front().price, thin_.back().price);
+        uint32_t hi = std::max(thin_.front().price, thin_.back().price);
+        if (fitLadder(lo, hi)) {
+            for (const PriceLevel& level : thin_) {
+                if (level.head) ladder_[level.price - base_] = level;
+            }
+            for (auto it = thin_.rbegin(); it != thin_.rend(); ++it) {
+                if (it->head) {
+                    bestKey_ = it->price;
+                    break;
+                }
+            }
+            // Retained empty levels are just empty slots now
+            reuse_.reclaimed += retained_.size();
+            retained_.clear();
+            reuse_.held = 0;
+            thin_.clear();
+            layout_ = BookLayout::Ladder;
+            return;
+        }
+    }
 
-    if (!level.head) {
-        levels_.erase(it);
+    for (const PriceLevel& level : thin_) {
+        levels_.emplace_hint(levels_.end(), level.price, level);
     }
+    thin_.clear();
+    layout_ = BookLayout::Thick;
 }
 
-void BookSide::updateQuantity(OrderNode* node, uint64_t price, uint64_t new_qty) {
+void BookSide::demote() {
+    thin_.clear();
+    demotions_++;
+    if (layout_ == BookLayout::Ladder) {
+        thin_.reserve(live_);
+        if (side_ == Side::Bid) {
+            for (const PriceLevel& level : ladder_) {
+                if (level.head) thin_.push_back(level);
+            }
+        } else {
+            for (auto it = ladder_.rbegin(); it != ladder_.rend(); ++it) {
+                if (it->head) thin_.push_back(*it);
+            }
+        }
+        std::vector<PriceLevel>().swap(ladder_);
+        layout_ = BookLayout::Thin;
+        return;
+    }
+
+    thin_.reserve(levels_.size());
+    // worst..best: ascending for bids, descending for asks
+    if (side_ == Side::Bid) {
+        for (const auto& [price, level] : levels_) thin_.push_back(level);
+    } else {
+        for (auto it = levels_.rbegin(); it != levels_.rend(); ++it) thin_.push_back(it->second);
+    }
+    levels_.clear();
+    layout_ = BookLayout::Thin;
+}
+
+bool BookSide::fitLadder(uint32_t lo, uint32_t hi) {
+    uint64_t need = uint64_t(hi) - lo + 1;
+    if (need > config_.ladder_span) return false;
+
+    // Slack on both sides so the book can drift before the next re-window
+    uint64_t span = std::min<uint64_t>(config_.ladder_span, std::max<uint64_t>(need * 2, 64));
+    uint64_t base = lo - std::min<uint64_t>(lo, (span - need) / 2);
+    if (base + span > uint64_t(UINT32_MAX) + 1) base = uint64_t(UINT32_MAX) + 1 - span;
+
+    std::vector<PriceLevel> ladder(span);
+    for (size_t i = 0; i < span; ++i) ladder[i].price = static_cast<uint32_t>(base + i);
+    for (const PriceLevel& level : ladder_) {
+        if (level.head) ladder[level.price - base] = level;
+    }
+    ladder_.swap(ladder);
+    base_ = static_cast<uint32_t>(base);
+    return true;
+}
+
+bool BookSide::growLadder(uint32_t price) {
+    uint32_t lo = price, hi = price;
+    if (live_ > 0) {
+        size_t first = 0, last = ladder_.size() - 1;
+        while (!ladder_[first].head) ++first;
+        while (!ladder_[last].head) --last;
+        lo = std::min(lo, ladder_[first].price);
+        hi = std::max(hi, ladder_[last].price);
+    }
+    return fitLadder(lo, hi);
+}
+
+void BookSide::spill() {
+    for (const PriceLevel& level : ladder_) {
+        if (level.head) levels_.emplace_hint(levels_.end(), level.price, level);
+    }
+    std::vector<PriceLevel>().swap(ladder_);
+    layout_ = BookLayout::Thick;
+    spills_++;
+}
+
+OrderNode* BookSide::addOrder(uint64_t order_id, uint32_t price, uint64_t qty) {
+    age();
+    PriceLevel& level = getOrCreateLevel(price);
+    if (!level.head) live_++;
+
+    OrderNode* node = pool_.allocate(order_id, qty);
+
+    // FIFO enqueue at tail
+    if (!level.tail) {
+        level.head = node;
+        level.tail = node;
+    } else {
+        level.tail->next = node;
+        node->prev = level.tail;
+        level.tail = node;
+    }
+
+    level.total_qty += qty;
+    return node;
+}
+
+void BookSide::cancelOrder(OrderNode* node, uint32_t price) {
     if (!node) return;
+    age();
 
-    auto it = levels_.find(price);
-    if (it == levels_.end()) return;
+    PriceLevel* level = findLevel(price);
+    if (!level) return;
+
+    level->total_qty -= node->quantity;
+    unlink(*level, node);
+
+    if (!level->head) {
+        levelEmptied(price);
+    }
+}
+
+void BookSide::updateQuantity(OrderNode* node, uint32_t price, uint64_t new_qty) {
+    if (!node) return;
+    age();
+
+    PriceLevel* level = findLevel(price);
+    if (!level) return;
 
-    PriceLevel& level = it->second;
-    
     // Update aggregate quantity
-    level.total_qty = level.total_qty - node->quantity + new_qty;
-    
+    level->total_qty = level->total_qty - node->quantity + new_qty;
+
     // Update node quantity
     node->quantity = new_qty;
 
     // If quantity is zero, remove the node
     if (new_qty == 0) {
-        // Unlink from FIFO
-        if (node->prev) {
-            node->prev->next = node->next;
-        } else {
-            level.head = node->next;
-        }
-        if (node->next) {
-            node->next->prev = node->prev;
-        } else {
-            level.tail = node->prev;
-        }
-
-        delete node;
+        unlink(*level, node);
 
-        if (!level.head) {
-            levels_.erase(it);
+        if (!level->head) {
+            levelEmptied(price);
         }
     }
 }
@@ -92,12 +434,10 @@ uint64_t BookSide::matchAtBest(
     std::vector<std::tuple<uint64_t,uint64_t,uint64_t>>& trades
 ) {
     uint64_t filled = 0;
+    age();
 
-    while (incoming_qty > 0 && !levels_.empty()) {
-        LevelMap::iterator it =
-            (side_ == Side::Bid) ? std::prev(levels_.end()) : levels_.begin();
-
-        PriceLevel& level = it->second;
+    while (incoming_qty > 0 && !empty()) {
+        PriceLevel& level = const_cast<PriceLevel&>(*bestLevel());
         OrderNode* node = level.head;
         
         while (node && incoming_qty > 0) {
@@ -115,26 +455,14 @@ uint64_t BookSide::matchAtBest(
             if (node->quantity == 0) {
                 OrderNode* to_delete = node;
                 node = node->next;
-
-                if (to_delete->prev) {
-                    to_delete->prev->next = to_delete->next;
-                } else {
-                    level.head = to_delete->next;
-                }
-                if (to_delete->next) {
-                    to_delete->next->prev = to_delete->prev;
-                } else {
-                    level.tail = to_delete->prev;
-                }
-
-                delete to_delete;
+                unlink(level, to_delete);
             } else {
                 break;
             }
         }
 
         if (!level.head) {
-            levels_.erase(it);
+            levelEmptied(level.price);
         }
 
         if (incoming_qty == 0) break;
@@ -144,13 +472,11 @@ uint64_t BookSide::matchAtBest(
 }
 
 bool BookSide::bestPrice(uint64_t& price_out, uint64_t& qty_out) const {
-    if (levels_.empty()) return false;
-
-    LevelMap::const_iterator it =
-        (side_ == Side::Bid) ? std::prev(levels_.end()) : levels_.begin();
+    const PriceLevel* best = bestLevel();
+    if (!best) return false;
 
-    price_out = it->second.price;
-    qty_out   = it->second.total_qty;
+    price_out = best->price;
+    qty_out   = best->total_qty;
     return true;
 }
 
@@ -158,9 +484,27 @@ std::vector<std::pair<uint64_t,uint64_t>> BookSide::topK(std::size_t k) const {
     std::vector<std::pair<uint64_t,uint64_t>> result;
     result.reserve(k);
 
-    if (levels_.empty() || k == 0) return result;
+    if (empty() || k == 0) return result;
 
-    if (side_ == Side::Bid) {
+    if (layout_ == BookLayout::Thin) {
+        for (auto it = thin_.rbegin();
+             it != thin_.rend() && result.size() < k; ++it) {
+            if (it->total_qty > 0) {
+                result.emplace_back(it->price, it->total_qty);
+            }
+        }
+    } else if (layout_ == BookLayout::Ladder) {
+        size_t best = bestKey_ - base_;
+        if (side_ == Side::Bid) {
+            for (size_t i = best + 1; i-- > 0 && result.size() < k;) {
+                if (ladder_[i].total_qty > 0) result.emplace_back(ladder_[i].price, ladder_[i].total_qty);
+            }
+        } else {
+            for (size_t i = best; i < ladder_.size() && result.size() < k; ++i) {
+                if (ladder_[i].total_qty > 0) result.emplace_back(ladder_[i].price, ladder_[i].total_qty);
+            }
+        }
+    } else if (side_ == Side::Bid) {
         for (auto it = levels_.rbegin();
              it != levels_.rend() && result.size() < k; ++it) {
             if (it->second.total_qty > 0) {
@@ -179,21 +523,18 @@ std::vector<std::pair<uint64_t,uint64_t>> BookSide::topK(std::size_t k) const {
     return result;
 }
 
-PriceLevel& BookSide::getOrCreateLevel(uint64_t price) {
-    auto it = levels_.find(price);
-    if (it == levels_.end()) {
-        it = levels_.emplace(price, PriceLevel(price)).first;
-    }
-    return it->second;
-}
-
 // ============================================================================
 // OrderBookEngine Implementation
 // ============================================================================
 
+OrderBookEngine::OrderBookEngine()
+    : bids_(Side::Bid), asks_(Side::Ask) {}
+
+OrderBookEngine::~OrderBookEngine() = default;
+
 void OrderBookEngine::onAdd(uint64_t order_id,
                             Side side,
-                            uint64_t price,
+                            uint32_t price,
                             uint64_t qty,
                             OrderInfo& info_out) {
     OrderNode* node =
@@ -205,6 +546,8 @@ void OrderBookEngine::onAdd(uint64_t order_id,
     info_out.price    = price;
     info_out.quantity = qty;
     info_out.node     = node;
+
+    touch(side, price);
 }
 
 void OrderBookEngine::onCancel(uint64_t /*order_id*/, OrderInfo& info) {
@@ -218,6 +561,8 @@ void OrderBookEngine::onCancel(uint64_t /*order_id*/, OrderInfo& info) {
 
     info.node     = nullptr;
     info.quantity = 0;
+
+    touch(info.side, info.price);
 }
 
 void OrderBookEngine::onExecute(uint64_t /*order_id*/, OrderInfo& info, uint64_t executed_qty) {
@@ -236,16 +581,27 @@ void OrderBookEngine::onExecute(uint64_t /*order_id*/, OrderInfo& info, uint64_t
     if (new_qty == 0) {
         info.node = nullptr;
     }
+
+    touch(info.side, info.price);
 }
 
 uint64_t OrderBookEngine::onAggressive(Side taking_side,
                                        uint64_t qty,
                                        std::vector<std::tuple<uint64_t,uint64_t,uint64_t>>& trades) {
-    if (taking_side == Side::Bid) {
-        return asks_.matchAtBest(qty, trades);
-    } else {
-        return bids_.matchAtBest(qty, trades);
+    size_t first_trade = trades.size();
+    Side resting = (taking_side == Side::Bid) ? Side::Ask : Side::Bid;
+    uint64_t filled = (resting == Side::Ask) ? asks_.matchAtBest(qty, trades)
+                                             : bids_.matchAtBest(qty, trades);
+
+    if (watching_) {
+        beginUpdate();
+        for (size_t i = first_trade; i < trades.size(); ++i) {
+            uint32_t price = static_cast<uint32_t>(std::get<2>(trades[i]));
+            if (i == first_trade || price != std::get<2>(trades[i - 1])) touch(resting, price);
+        }
+        endUpdate();
     }
+    return filled;
 }
 
 bool OrderBookEngine::getBestBid(uint64_t& price_out, uint64_t& qty_out) const {
@@ -256,6 +612,27 @@ bool OrderBookEngine::getBestAsk(uint64_t& price_out, uint64_t& qty_out) const {
     return asks_.bestPrice(price_out, qty_out);
 }
 
+LayoutStats OrderBookEngine::getLayoutStats() const {
+    LayoutStats stats;
+    stats.promotions  = bids_.promotions() + asks_.promotions();
+    stats.demotions   = bids_.demotions() + asks_.demotions();
+    stats.thick_sides = (bids_.layout() != BookLayout::Thin) + (asks_.layout() != BookLayout::Thin);
+    stats.ladder_sides = (bids_.layout() == BookLayout::Ladder) + (asks_.layout() == BookLayout::Ladder);
+    stats.ladder_spills = bids_.spills() + asks_.spills();
+    return stats;
+}
+
+RetentionStats OrderBookEngine::getRetentionStats() const {
+    const RetentionStats& b = bids_.retentionStats();
+    const RetentionStats& a = asks_.retentionStats();
+    RetentionStats stats;
+    stats.created   = b.created + a.created;
+    stats.revived   = b.revived + a.revived;
+    stats.reclaimed = b.reclaimed + a.reclaimed;
+    stats.held      = b.held + a.held;
+    return stats;
+}
+
 std::vector<std::pair<uint64_t,uint64_t>>
 OrderBookEngine::getTopKBids(std::size_t k) const {
     return bids_.topK(k);
@@ -265,3 +642,94 @@ std::vector<std::pair<uint64_t,uint64_t>>
 OrderBookEngine::getTopKAsks(std::size_t k) const {
     return asks_.topK(k);
 }
+
+// ============================================================================
+// Triggers and BBO Change Detection
+// ============================================================================
+
+void OrderBookEngine::watch() {
+    if (watching_) return;
+    bbo_ = currentTop();
+    watching_ = true;
+}
+
+TriggerIndex& OrderBookEngine::triggers() {
+    if (!triggers_) {
+        triggers_ = std::make_unique<TriggerIndex>();
+        watch();
+    }
+    return *triggers_;
+}
+
+uint32_t OrderBookEngine::addBestPriceTrigger(Side side, uint32_t price, uint64_t tag) {
+    uint32_t id = triggers().add_best_price(side, price, tag);
+    uint64_t best, qty;
+    bool present = (side == Side::Bid) ? bids_.bestPrice(best, qty) : asks_.bestPrice(best, qty);
+    if (present) {
+        triggers_->on_best_price(side, static_cast<uint32_t>(best));
+        triggers_->deliver();
+    }
+    return id;
+}
+
+uint32_t OrderBookEngine::addLevelSizeTrigger(Side side, uint32_t price, uint64_t below_qty, uint64_t tag) {
+    return triggers().add_level_size_below(side, price, below_qty, tag);
+}
+
+uint32_t OrderBookEngine::addSpreadTrigger(int64_t above, uint64_t tag) {
+    uint32_t id = triggers().add_spread_above(above, tag);
+    if (bbo_.bid_qty && bbo_.ask_qty) {
+        triggers_->on_spread(static_cast<int64_t>(bbo_.ask_price) - static_cast<int64_t>(bbo_.bid_price));
+        triggers_->deliver();
+    }
+    return id;
+}
+
+bool OrderBookEngine::removeTrigger(uint32_t id) {
+    return triggers_ && triggers_->remove(id);
+}
+
+void OrderBookEngine::setBboCallback(BboCallback cb) {
+    bboCallback_ = std::move(cb);
+    if (bboCallback_) watch();
+}
+
+TopOfBook OrderBookEngine::currentTop() const {
+    TopOfBook top;
+    if (!bids_.bestPrice(top.bid_price, top.bid_qty)) top.bid_qty = 0;
+    if (!asks_.bestPrice(top.ask_price, top.ask_qty)) top.ask_qty = 0;
+    return top;
+}
+
+void OrderBookEngine::evaluate() {
+    if (triggers_ && triggers_->has_level_triggers()) {
+        for (size_t i = 0; i < touched_.size(); ++i) {
+            auto [side, price] = touched_[i];
+            bool seen = false;
+            for (size_t j = 0; j < i && !seen; ++j) seen = (touched_[j] == touched_[i]);
+            if (!seen) triggers_->on_level(side, price, getLevelQuantity(side, price));
+        }
+    }
+    touched_.clear();
+
+    TopOfBook now = currentTop();
+    if (now == bbo_) {
+        if (triggers_) triggers_->deliver();
+        return;
+    }
+
+    bool bid_moved = now.bid_qty && (!bbo_.bid_qty || now.bid_price != bbo_.bid_price);
+    bool ask_moved = now.ask_qty && (!bbo_.ask_qty || now.ask_price != bbo_.ask_price);
+    bbo_ = now;
+    bboChanges_++;
+
+    if (triggers_) {
+        if (bid_moved) triggers_->on_best_price(Side::Bid, static_cast<uint32_t>(now.bid_price));
+        if (ask_moved) triggers_->on_best_price(Side::Ask, static_cast<uint32_t>(now.ask_price));
+        if ((bid_moved || ask_moved) && now.bid_qty && now.ask_qty) {
+            triggers_->on_spread(static_cast<int64_t>(now.ask_price) - static_cast<int64_t>(now.bid_price));
+        }
+        triggers_->deliver();
+    }
+    if (bboCallback_) bboCallback_(bbo_);
+}
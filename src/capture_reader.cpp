@@ -0,0 +1,724 @@
+#include "capture_reader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
+
+// ============================================================================
+// Shared Helpers
+// ============================================================================
+
+namespace
+{
+// O_DIRECT requires offset, length and buffer alignment to the logical block size
+constexpr size_t IO_ALIGNMENT = 4096;
+
+size_t round_up(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+struct AlignedFree
+{
+    void operator()(uint8_t* ptr) const
+    {
+#ifdef _WIN32
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+};
+using AlignedBuffer = std::unique_ptr<uint8_t, AlignedFree>;
+
+AlignedBuffer allocate_aligned(size_t size)
+{
+    void* ptr = nullptr;
+#ifdef _WIN32
+    ptr = _aligned_malloc(size, IO_ALIGNMENT);
+#else
+    if (posix_memalign(&ptr, IO_ALIGNMENT, size) != 0) ptr = nullptr;
+#endif
+    return AlignedBuffer(static_cast<uint8_t*>(ptr));
+}
+
+#ifndef _WIN32
+// Open for reading, trying O_DIRECT first when requested
+int open_capture(const std::string& path, bool want_direct, std::atomic<bool>& direct_out)
+{
+    direct_out.store(false, std::memory_order_relaxed);
+#ifdef O_DIRECT
+    if (want_direct)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY | O_DIRECT);
+        if (fd >= 0)
+        {
+            direct_out.store(true, std::memory_order_relaxed);
+            return fd;
+        }
+        // EINVAL: filesystem (e.g. tmpfs) does not support O_DIRECT
+    }
+#else
+    (void)want_direct;
+#endif
+    return ::open(path.c_str(), O_RDONLY);
+}
+
+size_t query_file_size(int fd)
+{
+    struct stat st;
+    if (::fstat(fd, &st) != 0) return 0;
+    return static_cast<size_t>(st.st_size);
+}
+
+// Read until length bytes or EOF; drops O_DIRECT if the kernel rejects an
+// unaligned tail read (direct may be read by another thread meanwhile).
+// Returns bytes read or -1 on error.
+ssize_t pread_full(int fd, uint8_t* buf, size_t length, size_t offset, std::atomic<bool>& direct)
+{
+    size_t done = 0;
+    while (done < length)
+    {
+        ssize_t n = ::pread(fd, buf + done, length - done, static_cast<off_t>(offset + done));
+        if (n < 0 && errno == EINTR) continue;
+#ifdef O_DIRECT
+        if (n < 0 && errno == EINVAL && direct.load(std::memory_order_relaxed))
+        {
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) & ~O_DIRECT);
+            direct.store(false, std::memory_order_relaxed);
+            continue;
+        }
+#endif
+        if (n < 0) return -1;
+        if (n == 0) break;  // EOF
+        done += static_cast<size_t>(n);
+    }
+    return static_cast<ssize_t>(done);
+}
+#endif
+}  // namespace
+
+// ============================================================================
+// Backend Interface
+// ============================================================================
+
+class CaptureReader::Impl
+{
+   public:
+    virtual ~Impl() = default;
+
+    // waited is set when the block was not yet loaded on entry
+    virtual bool next_block(const uint8_t*& data, size_t& length, bool& waited) = 0;
+
+    size_t file_size_ = 0;
+    std::atomic<bool> direct_{false};  // Cleared by a backend's reader thread on O_DIRECT fallback
+};
+
+namespace
+{
+#ifndef _WIN32
+// ============================================================================
+// Mmap Backend
+// ============================================================================
+
+class MmapReader : public CaptureReader::Impl
+{
+   public:
+    ~MmapReader() override
+    {
+        if (base_) ::munmap(base_, file_size_);
+    }
+
+    bool open(const std::string& path, size_t block_size)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        file_size_ = query_file_size(fd);
+        block_size_ = block_size;
+        if (file_size_ > 0)
+        {
+            void* base = ::mmap(nullptr, file_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (base == MAP_FAILED)
+            {
+                ::close(fd);
+                return false;
+            }
+            base_ = static_cast<uint8_t*>(base);
+            ::madvise(base_, file_size_, MADV_SEQUENTIAL);
+        }
+        ::close(fd);
+        return true;
+    }
+
+    bool next_block(const uint8_t*& data, size_t& length, bool& waited) override
+    {
+        waited = false;  // Stalls show up as page faults inside the consumer
+        if (offset_ >= file_size_) return false;
+        data = base_ + offset_;
+        length = std::min(block_size_, file_size_ - offset_);
+        offset_ += length;
+        return true;
+    }
+
+   private:
+    uint8_t* base_ = nullptr;
+    size_t block_size_ = 0;
+    size_t offset_ = 0;
+};
+
+// ============================================================================
+// Pread Thread Backend (portable read-ahead)
+// ============================================================================
+
+class PreadThreadReader : public CaptureReader::Impl
+{
+   public:
+    ~PreadThreadReader() override
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        slot_freed_.notify_all();
+        if (worker_.joinable()) worker_.join();
+        if (fd_ >= 0) ::close(fd_);
+    }
+
+    bool open(const std::string& path, const CaptureReader::Config& config)
+    {
+        fd_ = open_capture(path, config.direct_io, direct_);
+        if (fd_ < 0) return false;
+
+        file_size_ = query_file_size(fd_);
+        block_size_ = round_up(config.block_size, IO_ALIGNMENT);
+        total_blocks_ = (file_size_ + block_size_ - 1) / block_size_;
+
+        slots_.resize(std::max<size_t>(config.queue_depth, 2));
+        for (auto& slot : slots_)
+        {
+            slot.buffer = allocate_aligned(block_size_);
+            if (!slot.buffer) return false;
+        }
+
+        worker_ = std::thread([this] { read_loop(); });
+        return true;
+    }
+
+    bool next_block(const uint8_t*& data, size_t& length, bool& waited) override
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        // Hand the previous buffer back to the reader thread
+        if (current_ > 0)
+        {
+            slots_[(current_ - 1) % slots_.size()].ready = false;
+            slot_freed_.notify_one();
+        }
+
+        if (current_ >= total_blocks_ || failed_) return false;
+
+        Slot& slot = slots_[current_ % slots_.size()];
+        waited = !slot.ready;
+        block_ready_.wait(lock, [&] { return slot.ready || failed_; });
+        if (failed_) return false;
+
+        data = slot.buffer.get();
+        length = slot.length;
+        ++current_;
+        return true;
+    }
+
+   private:
+    struct Slot
+    {
+        AlignedBuffer buffer;
+        size_t length = 0;
+        bool ready = false;
+    };
+
+    void read_loop()
+    {
+        for (size_t block = 0; block < total_blocks_; ++block)
+        {
+            Slot& slot = slots_[block % slots_.size()];
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                slot_freed_.wait(lock, [&] { return !slot.ready || stop_; });
+                if (stop_) return;
+            }
+
+            size_t offset = block * block_size_;
+            size_t want = std::min(block_size_, file_size_ - offset);
+            size_t request = direct_.load(std::memory_order_relaxed) ? round_up(want, IO_ALIGNMENT) : want;
+            ssize_t n = pread_full(fd_, slot.buffer.get(), request, offset, direct_);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (n < static_cast<ssize_t>(want))
+            {
+                std::cerr << "[ERROR] Capture read failed at offset " << offset << "\n";
+                failed_ = true;
+                block_ready_.notify_one();
+                return;
+            }
+            slot.length = want;
+            slot.ready = true;
+            block_ready_.notify_one();
+        }
+    }
+
+    int fd_ = -1;
+    size_t block_size_ = 0;
+    size_t total_blocks_ = 0;
+    size_t current_ = 0;  // Next block handed to the consumer
+    std::vector<Slot> slots_;
+    std::thread worker_;
+    std::mutex mutex_;
+    std::condition_variable block_ready_;
+    std::condition_variable slot_freed_;
+    bool stop_ = false;
+    bool failed_ = false;
+};
+#endif
+
+#ifdef __linux__
+// ============================================================================
+// io_uring Backend (raw syscalls - no liburing dependency)
+// ============================================================================
+
+int sys_io_uring_setup(unsigned entries, io_uring_params* params)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int sys_io_uring_enter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+{
+    return static_cast<int>(
+        ::syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+class IoUringReader : public CaptureReader::Impl
+{
+   public:
+    ~IoUringReader() override
+    {
+        // The kernel may still be writing into our buffers - wait them out
+        if (cq_head_)
+        {
+            auto in_flight = [this] {
+                return std::any_of(slots_.begin(), slots_.end(),
+                                   [](const Slot& s) { return s.state == SlotState::InFlight; });
+            };
+            while (in_flight())
+            {
+                if (!reap_completions() &&
+                    sys_io_uring_enter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS) < 0 &&
+                    errno != EINTR)
+                {
+                    break;
+                }
+            }
+        }
+        if (sqes_) ::munmap(sqes_, sqes_size_);
+        if (cq_ring_ && cq_ring_ != sq_ring_) ::munmap(cq_ring_, cq_ring_size_);
+        if (sq_ring_) ::munmap(sq_ring_, sq_ring_size_);
+        if (ring_fd_ >= 0) ::close(ring_fd_);
+        if (fd_ >= 0) ::close(fd_);
+    }
+
+    bool open(const std::string& path, const CaptureReader::Config& config)
+    {
+        fd_ = open_capture(path, config.direct_io, direct_);
+        if (fd_ < 0) return false;
+
+        file_size_ = query_file_size(fd_);
+        block_size_ = round_up(config.block_size, IO_ALIGNMENT);
+        total_blocks_ = (file_size_ + block_size_ - 1) / block_size_;
+
+        slots_.resize(std::max<size_t>(config.queue_depth, 2));
+        for (auto& slot : slots_)
+        {
+            slot.buffer = allocate_aligned(block_size_);
+            if (!slot.buffer) return false;
+        }
+
+        if (!setup_ring(static_cast<unsigned>(slots_.size()))) return false;
+
+        // Prime the pipeline
+        unsigned queued = 0;
+        for (size_t block = 0; block < std::min(total_blocks_, slots_.size()); ++block)
+        {
+            queue_read(block);
+            ++queued;
+        }
+        return queued == 0 || submit(queued);
+    }
+
+    bool next_block(const uint8_t*& data, size_t& length, bool& waited) override
+    {
+        waited = false;
+        if (failed_) return false;
+
+        // Recycle the previous buffer for the block queue_depth ahead
+        if (current_ > 0)
+        {
+            size_t refill = current_ - 1 + slots_.size();
+            slots_[(current_ - 1) % slots_.size()].state = SlotState::Idle;
+            if (refill < total_blocks_)
+            {
+                queue_read(refill);
+                if (!submit(1)) return false;
+            }
+        }
+
+        if (current_ >= total_blocks_) return false;
+
+        Slot& slot = slots_[current_ % slots_.size()];
+        while (slot.state != SlotState::Ready)
+        {
+            if (!reap_completions())
+            {
+                waited = true;
+                int ret = sys_io_uring_enter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS);
+                if (ret < 0 && errno != EINTR) return false;
+            }
+            if (failed_) return false;
+        }
+
+        data = slot.buffer.get();
+        length = slot.length;
+        ++current_;
+        return true;
+    }
+
+   private:
+    enum class SlotState : uint8_t { Idle, InFlight, Ready };
+
+    struct Slot
+    {
+        AlignedBuffer buffer;
+        iovec iov{};
+        size_t block = 0;
+        size_t length = 0;
+        SlotState state = SlotState::Idle;
+    };
+
+    bool setup_ring(unsigned entries)
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ring_fd_ = sys_io_uring_setup(entries, &params);
+        if (ring_fd_ < 0) return false;
+
+        sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap) sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+
+        sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+        if (sq_ring_ == MAP_FAILED)
+        {
+            sq_ring_ = nullptr;
+            return false;
+        }
+        cq_ring_ = single_mmap ? sq_ring_
+                               : ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                                        MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+        if (cq_ring_ == MAP_FAILED)
+        {
+            cq_ring_ = nullptr;
+            return false;
+        }
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                            ring_fd_, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) return false;
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+        auto* sq = static_cast<uint8_t*>(sq_ring_);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        auto* cq = static_cast<uint8_t*>(cq_ring_);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    void queue_read(size_t block)
+    {
+        size_t slot_index = block % slots_.size();
+        Slot& slot = slots_[slot_index];
+        size_t offset = block * block_size_;
+        size_t want = std::min(block_size_, file_size_ - offset);
+
+        slot.block = block;
+        slot.length = want;
+        slot.state = SlotState::InFlight;
+        slot.iov.iov_base = slot.buffer.get();
+        slot.iov.iov_len = direct_.load(std::memory_order_relaxed) ? round_up(want, IO_ALIGNMENT) : want;
+
+        unsigned tail = *sq_tail_;
+        unsigned index = tail & sq_mask_;
+        io_uring_sqe& sqe = sqes_[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READV;
+        sqe.fd = fd_;
+        sqe.addr = reinterpret_cast<uint64_t>(&slot.iov);
+        sqe.len = 1;
+        sqe.off = offset;
+        sqe.user_data = slot_index;
+        sq_array_[index] = index;
+        __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+        unsubmitted_.push_back(slot_index);
+    }
+
+    // The kernel takes queued SQEs in order. On failure the ones it never
+    // took go back to Idle, so the destructor does not wait on them.
+    bool submit(unsigned count)
+    {
+        size_t taken = 0;
+        while (count > 0)
+        {
+            int ret = sys_io_uring_enter(ring_fd_, count, 0, 0);
+            if (ret < 0)
+            {
+                if (errno == EINTR) continue;
+                std::cerr << "[ERROR] io_uring_enter submit failed: " << std::strerror(errno)
+                          << "\n";
+                for (size_t i = taken; i < unsubmitted_.size(); ++i)
+                {
+                    slots_[unsubmitted_[i]].state = SlotState::Idle;
+                }
+                unsubmitted_.clear();
+                failed_ = true;
+                return false;
+            }
+            count -= static_cast<unsigned>(ret);
+            taken += static_cast<size_t>(ret);
+        }
+        unsubmitted_.clear();
+        return true;
+    }
+
+    // Drain the completion queue; returns true if any completion was seen
+    bool reap_completions()
+    {
+        bool any = false;
+        unsigned head = *cq_head_;
+        while (head != __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE))
+        {
+            const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+            Slot& slot = slots_[cqe.user_data];
+            if (cqe.res < 0)
+            {
+                std::cerr << "[ERROR] Capture read failed: " << std::strerror(-cqe.res) << "\n";
+                failed_ = true;
+            }
+            else if (static_cast<size_t>(cqe.res) < slot.length)
+            {
+                // Short read before EOF - finish synchronously (rare)
+                size_t got = static_cast<size_t>(cqe.res);
+                ssize_t rest = pread_full(fd_, slot.buffer.get() + got, slot.length - got,
+                                          slot.block * block_size_ + got, direct_);
+                if (rest < static_cast<ssize_t>(slot.length - got)) failed_ = true;
+            }
+            slot.state = SlotState::Ready;
+            any = true;
+            ++head;
+        }
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+        return any;
+    }
+
+    int fd_ = -1;
+    int ring_fd_ = -1;
+    size_t block_size_ = 0;
+    size_t total_blocks_ = 0;
+    size_t current_ = 0;
+    bool failed_ = false;
+    std::vector<Slot> slots_;
+    std::vector<size_t> unsubmitted_;  // Slots queued since the last submit, in SQ order
+
+    void* sq_ring_ = nullptr;
+    void* cq_ring_ = nullptr;
+    size_t sq_ring_size_ = 0;
+    size_t cq_ring_size_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sqes_size_ = 0;
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+};
+#endif
+
+#ifdef _WIN32
+// ============================================================================
+// Stdio Backend (Windows - synchronous buffered reads)
+// ============================================================================
+
+class StdioReader : public CaptureReader::Impl
+{
+   public:
+    ~StdioReader() override
+    {
+        if (file_) std::fclose(file_);
+    }
+
+    bool open(const std::string& path, size_t block_size)
+    {
+        file_ = std::fopen(path.c_str(), "rb");
+        if (!file_) return false;
+        std::fseek(file_, 0, SEEK_END);
+        file_size_ = static_cast<size_t>(std::ftell(file_));
+        std::fseek(file_, 0, SEEK_SET);
+        buffer_.resize(block_size);
+        return true;
+    }
+
+    bool next_block(const uint8_t*& data, size_t& length, bool& waited) override
+    {
+        waited = false;
+        length = std::fread(buffer_.data(), 1, buffer_.size(), file_);
+        data = buffer_.data();
+        return length > 0;
+    }
+
+   private:
+    std::FILE* file_ = nullptr;
+    std::vector<uint8_t> buffer_;
+};
+#endif
+}  // namespace
+
+// ============================================================================
+// CaptureReader Implementation
+// ============================================================================
+
+CaptureReader::CaptureReader() = default;
+CaptureReader::~CaptureReader() = default;
+
+bool CaptureReader::open(const std::string& path, const Config& config)
+{
+    close();
+    Backend backend = config.backend;
+
+#ifdef _WIN32
+    auto reader = std::make_unique<StdioReader>();
+    if (!reader->open(path, config.block_size)) impl_.reset();
+    else impl_ = std::move(reader);
+    backend = Backend::PreadThread;
+#else
+#ifdef __linux__
+    if (backend == Backend::IoUring)
+    {
+        auto reader = std::make_unique<IoUringReader>();
+        if (reader->open(path, config))
+        {
+            impl_ = std::move(reader);
+        }
+        else
+        {
+            std::cerr << "[WARN] io_uring unavailable, falling back to pread thread\n";
+            backend = Backend::PreadThread;
+        }
+    }
+#else
+    if (backend == Backend::IoUring) backend = Backend::PreadThread;
+#endif
+    if (!impl_ && backend == Backend::PreadThread)
+    {
+        auto reader = std::make_unique<PreadThreadReader>();
+        if (reader->open(path, config)) impl_ = std::move(reader);
+    }
+    if (!impl_ && backend == Backend::Mmap)
+    {
+        auto reader = std::make_unique<MmapReader>();
+        if (reader->open(path, config.block_size)) impl_ = std::move(reader);
+    }
+#endif
+
+    if (!impl_)
+    {
+        std::cerr << "[ERROR] Could not open capture file: " << path << "\n";
+        return false;
+    }
+
+    stats_ = ReaderStats{};
+    stats_.backend = backend;
+    stats_.direct_io = impl_->direct_.load(std::memory_order_relaxed);
+    return true;
+}
+
+void CaptureReader::close()
+{
+    impl_.reset();
+}
+
+bool CaptureReader::next_block(const uint8_t*& data, size_t& length)
+{
+    if (!impl_) return false;
+
+    auto start = std::chrono::steady_clock::now();
+    bool waited = false;
+    if (!impl_->next_block(data, length, waited)) return false;
+
+    if (waited)
+    {
+        stats_.consumer_waits++;
+        stats_.wait_ns += static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count());
+    }
+    stats_.blocks++;
+    stats_.bytes += length;
+    stats_.direct_io = impl_->direct_.load(std::memory_order_relaxed);  // A fallback shows up here
+    return true;
+}
+
+size_t CaptureReader::file_size() const
+{
+    return impl_ ? impl_->file_size_ : 0;
+}
+
+const char* CaptureReader::backend_name(Backend backend)
+{
+    switch (backend)
+    {
+        case Backend::Mmap: return "mmap";
+        case Backend::PreadThread: return "pread-thread";
+        case Backend::IoUring: return "io_uring";
+    }
+    return "unknown";
+}
@@ -0,0 +1,327 @@
+#include "concurrent_order_view.h"
+
+#include <thread>
+#include <vector>
+
+// ============================================================================
+// Seqlock Slot Table
+// ============================================================================
+
+// Two slots per cache line
+struct ConcurrentOrderView::Slot
+{
+    std::atomic<uint32_t> seq{0};  // Odd while the writer is inside the slot
+    std::atomic<uint64_t> key;
+    std::atomic<uint64_t> a{0};
+    std::atomic<uint64_t> b{0};
+};
+
+static_assert(sizeof(std::atomic<uint64_t>) == 8, "Slot layout assumes lock-free 64-bit atomics");
+
+class ConcurrentOrderView::Table
+{
+   public:
+    static constexpr uint64_t EMPTY = ~0ULL;
+    static constexpr size_t NPOS = ~size_t{0};
+
+    explicit Table(size_t max_entries)
+    {
+        size_t capacity = 16;
+        while (capacity * 3 / 4 < max_entries) capacity <<= 1;
+        slots_ = std::vector<Slot>(capacity);
+        for (auto& slot : slots_) slot.key.store(EMPTY, std::memory_order_relaxed);
+        mask_ = capacity - 1;
+        limit_ = capacity * 3 / 4;
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+    size_t size() const { return size_; }
+
+    size_t home(uint64_t key) const
+    {
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> 20) & mask_;
+    }
+
+    Slot& at(size_t index) { return slots_[index]; }
+    const Slot& at(size_t index) const { return slots_[index]; }
+
+    // ---- Writer ----
+    size_t find(uint64_t key) const
+    {
+        for (size_t i = home(key);; i = (i + 1) & mask_)
+        {
+            uint64_t k = slots_[i].key.load(std::memory_order_relaxed);
+            if (k == key) return i;
+            if (k == EMPTY) return NPOS;
+        }
+    }
+
+    // First empty slot on key's probe chain; NPOS at the load limit
+    size_t claim(uint64_t key) const
+    {
+        if (size_ >= limit_) return NPOS;
+        size_t i = home(key);
+        while (slots_[i].key.load(std::memory_order_relaxed) != EMPTY) i = (i + 1) & mask_;
+        return i;
+    }
+
+    void begin_write(size_t index)
+    {
+        Slot& slot = slots_[index];
+        slot.seq.store(slot.seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void end_write(size_t index)
+    {
+        Slot& slot = slots_[index];
+        slot.seq.store(slot.seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    void insert(size_t index, uint64_t key, uint64_t a, uint64_t b)
+    {
+        Slot& slot = slots_[index];
+        slot.a.store(a, std::memory_order_relaxed);
+        slot.b.store(b, std::memory_order_relaxed);
+        slot.key.store(key, std::memory_order_relaxed);
+        ++size_;
+    }
+
+    // Backward-shift deletion; caller holds the structure window open
+    void erase(size_t hole)
+    {
+        for (size_t j = (hole + 1) & mask_;; j = (j + 1) & mask_)
+        {
+            uint64_t k = slots_[j].key.load(std::memory_order_relaxed);
+            if (k == EMPTY) break;
+
+            // Entry at j may fill the hole only if its home is not in (hole, j]
+            size_t h = home(k);
+            bool stays = (hole <= j) ? (hole < h && h <= j) : (hole < h || h <= j);
+            if (stays) continue;
+
+            Slot& dst = slots_[hole];
+            dst.key.store(k, std::memory_order_relaxed);
+            dst.a.store(slots_[j].a.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            dst.b.store(slots_[j].b.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            hole = j;
+        }
+        slots_[hole].key.store(EMPTY, std::memory_order_relaxed);
+        --size_;
+    }
+
+    // ---- Reader ----
+    // Probe for key; on hit returns the slot index and the even seq it was read
+    // under. Slots seen mid-write are re-read. Caller validates structure_seq.
+    size_t probe(uint64_t key, uint32_t& seq_out, uint64_t& a, uint64_t& b, size_t& retries) const
+    {
+        for (size_t i = home(key);; i = (i + 1) & mask_)
+        {
+            const Slot& slot = slots_[i];
+            while (true)
+            {
+                uint32_t s1 = slot.seq.load(std::memory_order_acquire);
+                if (s1 & 1)
+                {
+                    ++retries;
+                    std::this_thread::yield();
+                    continue;
+                }
+                uint64_t k = slot.key.load(std::memory_order_relaxed);
+                a = slot.a.load(std::memory_order_relaxed);
+                b = slot.b.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.seq.load(std::memory_order_relaxed) != s1)
+                {
+                    ++retries;
+                    continue;
+                }
+                if (k == key)
+                {
+                    seq_out = s1;
+                    return i;
+                }
+                if (k == EMPTY) return NPOS;
+                break;  // Another key - next slot
+            }
+        }
+    }
+
+   private:
+    std::vector<Slot> slots_;
+    size_t mask_ = 0;
+    size_t limit_ = 0;
+    size_t size_ = 0;  // Writer-owned
+};
+
+// ============================================================================
+// ConcurrentOrderView Implementation
+// ============================================================================
+
+ConcurrentOrderView::ConcurrentOrderView(size_t max_orders, size_t max_levels)
+    : orders_(std::make_unique<Table>(max_orders)), levels_(std::make_unique<Table>(max_levels))
+{
+}
+
+ConcurrentOrderView::~ConcurrentOrderView() = default;
+
+size_t ConcurrentOrderView::order_capacity() const
+{
+    return orders_->capacity() * 3 / 4;
+}
+
+void ConcurrentOrderView::adjust_level(char side, uint32_t price, int64_t quantity_delta,
+                                       int32_t order_delta)
+{
+    uint64_t key = level_key(side, price);
+    size_t index = levels_->find(key);
+
+    if (index == Table::NPOS)
+    {
+        if (quantity_delta <= 0 && order_delta <= 0) return;
+        index = levels_->claim(key);
+        if (index == Table::NPOS)
+        {
+            writer_stats_.insert_failures++;
+            return;
+        }
+        levels_->begin_write(index);
+        levels_->insert(index, key, static_cast<uint64_t>(quantity_delta),
+                        static_cast<uint64_t>(order_delta));
+        levels_->end_write(index);
+        writer_stats_.levels = levels_->size();
+        return;
+    }
+
+    Slot& slot = levels_->at(index);
+    uint64_t quantity = slot.a.load(std::memory_order_relaxed) + static_cast<uint64_t>(quantity_delta);
+    uint64_t orders = slot.b.load(std::memory_order_relaxed) + static_cast<uint64_t>(order_delta);
+
+    if (orders == 0)
+    {
+        levels_->erase(index);  // Only from on_remove, inside the structure window
+        writer_stats_.levels = levels_->size();
+        return;
+    }
+
+    levels_->begin_write(index);
+    slot.a.store(quantity, std::memory_order_relaxed);
+    slot.b.store(orders, std::memory_order_relaxed);
+    levels_->end_write(index);
+}
+
+void ConcurrentOrderView::on_add(uint64_t order_id, char side, uint32_t price, uint32_t quantity)
+{
+    size_t index = orders_->claim(order_id);
+    if (index == Table::NPOS)
+    {
+        writer_stats_.insert_failures++;
+        return;
+    }
+
+    // Level update sits inside the order's window so readers see them together
+    orders_->begin_write(index);
+    orders_->insert(index, order_id, (static_cast<uint64_t>(price) << 32) | quantity,
+                    static_cast<uint8_t>(side));
+    adjust_level(side, price, quantity, 1);
+    orders_->end_write(index);
+    writer_stats_.orders = orders_->size();
+}
+
+void ConcurrentOrderView::on_reduce(uint64_t order_id, uint32_t remaining)
+{
+    size_t index = orders_->find(order_id);
+    if (index == Table::NPOS) return;
+
+    Slot& slot = orders_->at(index);
+    uint64_t a = slot.a.load(std::memory_order_relaxed);
+    uint32_t price = static_cast<uint32_t>(a >> 32);
+    uint32_t quantity = static_cast<uint32_t>(a);
+    char side = static_cast<char>(slot.b.load(std::memory_order_relaxed));
+
+    orders_->begin_write(index);
+    slot.a.store((static_cast<uint64_t>(price) << 32) | remaining, std::memory_order_relaxed);
+    adjust_level(side, price, static_cast<int64_t>(remaining) - static_cast<int64_t>(quantity), 0);
+    orders_->end_write(index);
+}
+
+void ConcurrentOrderView::on_remove(uint64_t order_id)
+{
+    size_t index = orders_->find(order_id);
+    if (index == Table::NPOS) return;
+
+    const Slot& slot = orders_->at(index);
+    uint64_t a = slot.a.load(std::memory_order_relaxed);
+    char side = static_cast<char>(slot.b.load(std::memory_order_relaxed));
+
+    // Erases move slots - every in-flight read restarts
+    uint64_t seq = structure_seq_.load(std::memory_order_relaxed);
+    structure_seq_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    adjust_level(side, static_cast<uint32_t>(a >> 32), -static_cast<int64_t>(static_cast<uint32_t>(a)),
+                 -1);
+    orders_->erase(index);
+
+    structure_seq_.store(seq + 2, std::memory_order_release);
+    writer_stats_.orders = orders_->size();
+}
+
+bool ConcurrentOrderView::find(uint64_t order_id, OrderSnapshot& out) const
+{
+    size_t retries = 0;
+    return find(order_id, out, retries);
+}
+
+bool ConcurrentOrderView::find(uint64_t order_id, OrderSnapshot& out, size_t& retries) const
+{
+    while (true)
+    {
+        uint64_t g1 = structure_seq_.load(std::memory_order_acquire);
+        if (g1 & 1)
+        {
+            ++retries;
+            std::this_thread::yield();
+            continue;
+        }
+
+        uint32_t order_seq = 0;
+        uint64_t a = 0;
+        uint64_t b = 0;
+        size_t index = orders_->probe(order_id, order_seq, a, b, retries);
+
+        OrderSnapshot snap;
+        if (index != Table::NPOS)
+        {
+            snap.order_id = order_id;
+            snap.price = static_cast<uint32_t>(a >> 32);
+            snap.quantity = static_cast<uint32_t>(a);
+            snap.side = static_cast<char>(b);
+
+            uint32_t level_seq = 0;
+            uint64_t level_qty = 0;
+            uint64_t level_orders = 0;
+            if (levels_->probe(level_key(snap.side, snap.price), level_seq, level_qty, level_orders,
+                               retries) != Table::NPOS)
+            {
+                snap.level_quantity = level_qty;
+                snap.level_orders = static_cast<uint32_t>(level_orders);
+            }
+        }
+
+        // The order slot must not have changed while its level was read, and
+        // nothing may have been shifted during the probes
+        std::atomic_thread_fence(std::memory_order_acquire);
+        bool order_stable = index == Table::NPOS ||
+                            orders_->at(index).seq.load(std::memory_order_relaxed) == order_seq;
+        if (!order_stable || structure_seq_.load(std::memory_order_relaxed) != g1)
+        {
+            ++retries;
+            continue;
+        }
+
+        if (index == Table::NPOS) return false;
+        out = snap;
+        return true;
+    }
+}
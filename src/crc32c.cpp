@@ -0,0 +1,60 @@
+#include "crc32c.h"
+
+namespace
+{
+
+constexpr uint32_t POLY = 0x82F63B78;  // Castagnoli, reflected
+
+// tables[k][b]: CRC of byte b followed by k zero bytes
+struct Tables
+{
+    uint32_t t[8][256];
+
+    Tables() : t()
+    {
+        for (uint32_t b = 0; b < 256; ++b)
+        {
+            uint32_t crc = b;
+            for (int bit = 0; bit < 8; ++bit) crc = (crc >> 1) ^ (POLY & (0u - (crc & 1)));
+            t[0][b] = crc;
+        }
+        for (uint32_t b = 0; b < 256; ++b)
+        {
+            for (int k = 1; k < 8; ++k) t[k][b] = (t[k - 1][b] >> 8) ^ t[0][t[k - 1][b] & 0xFF];
+        }
+    }
+};
+
+const Tables& tables()
+{
+    static const Tables instance;
+    return instance;
+}
+
+}  // namespace
+
+uint32_t Crc32c::compute_table(const uint8_t* data, size_t length, uint32_t seed)
+{
+    const auto& t = tables().t;
+    uint32_t crc = ~seed;
+
+    // Slicing-by-8: one table lookup per byte, eight independent per step
+    for (; length >= 8; data += 8, length -= 8)
+    {
+        uint32_t lo = crc ^ (static_cast<uint32_t>(data[0]) | static_cast<uint32_t>(data[1]) << 8 |
+                             static_cast<uint32_t>(data[2]) << 16 | static_cast<uint32_t>(data[3]) << 24);
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+              t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+    }
+    for (; length > 0; ++data, --length) crc = (crc >> 8) ^ t[0][(crc ^ *data) & 0xFF];
+    return ~crc;
+}
+
+const char* Crc32c::isa()
+{
+#if defined(__SSE4_2__)
+    return "sse4.2";
+#else
+    return "table";
+#endif
+}
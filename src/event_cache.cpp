@@ -0,0 +1,186 @@
+#include "event_cache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ============================================================================
+// Event Cache File Format
+// ============================================================================
+
+namespace
+{
+constexpr char CACHE_MAGIC[8] = {'O', 'B', 'E', 'V', 'C', 'A', 'C', 'H'};
+// v2: 40-byte records with Stock Locate. v3: the former padding holds the
+// 'F' MPID; v2 writers left it uninitialized, so v2 files are rejected (and
+// rebuilt by the caller) rather than replayed with garbage MPIDs. v4: 48-byte
+// records with the Stock field, so locate-less feeds route from the cache.
+constexpr uint32_t CACHE_VERSION = 4;
+
+// 24-byte header keeps the records that follow 8-byte aligned for mmap
+struct CacheFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t count;
+};
+
+static_assert(sizeof(CacheFileHeader) == 24, "Header layout is part of the file format");
+
+bool header_valid(const CacheFileHeader& header)
+{
+    return std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 &&
+           header.version == CACHE_VERSION && header.record_size == sizeof(CachedEvent);
+}
+}  // namespace
+
+// ============================================================================
+// EventCache Implementation
+// ============================================================================
+
+EventCache::~EventCache()
+{
+    unmap();
+}
+
+void EventCache::append(const ITCHParser::ParseResult& result)
+{
+    // Appending to a mapped cache copies it into owned memory first
+    if (mapped_)
+    {
+        std::vector<CachedEvent> owned(mapped_, mapped_ + mapped_count_);
+        unmap();
+        events_ = std::move(owned);
+    }
+    events_.push_back(CachedEvent::from_result(result));
+}
+
+void EventCache::clear()
+{
+    unmap();
+    events_.clear();
+}
+
+bool EventCache::save(const std::string& path) const
+{
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file)
+    {
+        std::cerr << "[ERROR] Could not open event cache for writing: " << path << "\n";
+        return false;
+    }
+
+    CacheFileHeader header{};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.record_size = sizeof(CachedEvent);
+    header.count = size();
+
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    if (ok && header.count > 0)
+    {
+        ok = std::fwrite(data(), sizeof(CachedEvent), size(), file) == size();
+    }
+    ok = (std::fclose(file) == 0) && ok;
+
+    if (!ok)
+    {
+        std::cerr << "[ERROR] Short write while saving event cache: " << path << "\n";
+    }
+    return ok;
+}
+
+bool EventCache::load(const std::string& path)
+{
+    clear();
+
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        std::cerr << "[ERROR] Could not open event cache: " << path << "\n";
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(CacheFileHeader))
+    {
+        std::cerr << "[ERROR] Event cache too small: " << path << "\n";
+        ::close(fd);
+        return false;
+    }
+
+    size_t length = static_cast<size_t>(st.st_size);
+    void* base = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // Mapping stays valid after close
+    if (base == MAP_FAILED)
+    {
+        std::cerr << "[ERROR] mmap failed for event cache: " << path << "\n";
+        return false;
+    }
+
+    const auto* header = static_cast<const CacheFileHeader*>(base);
+    if (!header_valid(*header) ||
+        length < sizeof(CacheFileHeader) + header->count * sizeof(CachedEvent))
+    {
+        std::cerr << "[ERROR] Invalid or truncated event cache: " << path << "\n";
+        ::munmap(base, length);
+        return false;
+    }
+
+    // Replay walks the file front to back
+    ::madvise(base, length, MADV_SEQUENTIAL);
+
+    map_base_ = base;
+    map_length_ = length;
+    mapped_ = reinterpret_cast<const CachedEvent*>(static_cast<const uint8_t*>(base) +
+                                                   sizeof(CacheFileHeader));
+    mapped_count_ = header->count;
+    return true;
+#else
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file)
+    {
+        std::cerr << "[ERROR] Could not open event cache: " << path << "\n";
+        return false;
+    }
+
+    CacheFileHeader header{};
+    bool ok = std::fread(&header, sizeof(header), 1, file) == 1 && header_valid(header);
+    if (ok)
+    {
+        events_.resize(header.count);
+        ok = std::fread(events_.data(), sizeof(CachedEvent), header.count, file) == header.count;
+    }
+    std::fclose(file);
+
+    if (!ok)
+    {
+        std::cerr << "[ERROR] Invalid or truncated event cache: " << path << "\n";
+        events_.clear();
+    }
+    return ok;
+#endif
+}
+
+void EventCache::unmap()
+{
+#ifndef _WIN32
+    if (map_base_)
+    {
+        ::munmap(map_base_, map_length_);
+    }
+#endif
+    map_base_ = nullptr;
+    map_length_ = 0;
+    mapped_ = nullptr;
+    mapped_count_ = 0;
+}
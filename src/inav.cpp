@@ -0,0 +1,174 @@
+#include "inav.h"
+
+#include <algorithm>
+#include <thread>
+
+// One basket per cache line
+struct alignas(64) InavCalculator::Slot
+{
+    std::atomic<uint32_t> seq{0};  // Odd while the writer is inside the slot
+    std::atomic<uint32_t> creation_unit{0};
+    std::atomic<uint32_t> missing{0};
+    std::atomic<int64_t> value2{0};
+    std::atomic<uint64_t> version{0};
+};
+
+InavCalculator::InavCalculator(size_t symbols, size_t max_baskets)
+    : symbols_(std::min<size_t>(symbols, 65536)),
+      max_baskets_(max_baskets),
+      slots_(new Slot[max_baskets]),
+      mid2_(symbols_, 0),
+      member_begin_(symbols_ + 1, 0)
+{
+}
+
+InavCalculator::~InavCalculator() = default;
+
+uint32_t InavCalculator::add_basket(uint32_t creation_unit, int64_t cash)
+{
+    if (value2_.size() >= max_baskets_ || creation_unit == 0) return UINT32_MAX;
+
+    uint32_t basket = static_cast<uint32_t>(value2_.size());
+    value2_.push_back(2 * cash);
+    cash2_.push_back(2 * cash);
+    creation_unit_.push_back(creation_unit);
+    missing_.push_back(0);
+    version_.push_back(0);
+
+    publish(basket);
+    published_baskets_.store(basket + 1, std::memory_order_release);
+    return basket;
+}
+
+bool InavCalculator::add_constituent(uint32_t basket, uint16_t symbol, int64_t shares)
+{
+    if (basket >= value2_.size() || symbol >= symbols_) return false;
+
+    added_.push_back({symbol, Member{basket, shares}});
+    members_dirty_ = true;
+
+    if (mid2_[symbol] != 0)
+        value2_[basket] += shares * mid2_[symbol];
+    else
+        missing_[basket]++;
+    publish(basket);
+    return true;
+}
+
+void InavCalculator::rebuild_members()
+{
+    std::fill(member_begin_.begin(), member_begin_.end(), 0);
+    for (const auto& [symbol, member] : added_) member_begin_[symbol + 1]++;
+    for (size_t s = 0; s < symbols_; ++s) member_begin_[s + 1] += member_begin_[s];
+
+    members_.resize(added_.size());
+    std::vector<uint32_t> next(member_begin_.begin(), member_begin_.end() - 1);
+    for (const auto& [symbol, member] : added_) members_[next[symbol]++] = member;
+    members_dirty_ = false;
+}
+
+void InavCalculator::on_bbo(uint16_t symbol, const TopOfBook& top)
+{
+    if (symbol >= symbols_) return;
+
+    int64_t mid2;
+    if (top.bid_qty && top.ask_qty)
+        mid2 = static_cast<int64_t>(top.bid_price + top.ask_price);
+    else if (top.bid_qty || top.ask_qty)
+        mid2 = 2 * static_cast<int64_t>(top.bid_qty ? top.bid_price : top.ask_price);
+    else
+        return;
+
+    int64_t old = mid2_[symbol];
+    if (mid2 == old) return;  // Size-only change
+    mid2_[symbol] = mid2;
+    stats_.bbo_updates++;
+
+    if (members_dirty_) rebuild_members();
+    int64_t move = mid2 - old;
+    for (uint32_t i = member_begin_[symbol]; i < member_begin_[symbol + 1]; ++i)
+    {
+        const Member& m = members_[i];
+        value2_[m.basket] += m.shares * move;
+        if (old == 0) missing_[m.basket]--;
+        publish(m.basket);
+    }
+}
+
+size_t InavCalculator::recompute()
+{
+    std::vector<int64_t> fresh(cash2_);
+    std::vector<uint32_t> missing(value2_.size(), 0);
+    for (const auto& [symbol, member] : added_)
+    {
+        if (mid2_[symbol] != 0)
+            fresh[member.basket] += member.shares * mid2_[symbol];
+        else
+            missing[member.basket]++;
+    }
+
+    size_t corrected = 0;
+    for (uint32_t b = 0; b < value2_.size(); ++b)
+    {
+        if (fresh[b] == value2_[b] && missing[b] == missing_[b]) continue;
+        value2_[b] = fresh[b];
+        missing_[b] = missing[b];
+        publish(b);
+        corrected++;
+    }
+    stats_.recomputes++;
+    stats_.corrections += corrected;
+    return corrected;
+}
+
+void InavCalculator::publish(uint32_t basket)
+{
+    Slot& slot = slots_[basket];
+    uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+    slot.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.creation_unit.store(creation_unit_[basket], std::memory_order_relaxed);
+    slot.missing.store(missing_[basket], std::memory_order_relaxed);
+    slot.value2.store(value2_[basket], std::memory_order_relaxed);
+    slot.version.store(++version_[basket], std::memory_order_relaxed);
+
+    slot.seq.store(seq + 2, std::memory_order_release);
+    stats_.publishes++;
+}
+
+bool InavCalculator::read(uint32_t basket, Snapshot& out) const
+{
+    size_t retries = 0;
+    return read(basket, out, retries);
+}
+
+bool InavCalculator::read(uint32_t basket, Snapshot& out, size_t& retries) const
+{
+    if (basket >= published_baskets_.load(std::memory_order_acquire)) return false;
+
+    const Slot& slot = slots_[basket];
+    while (true)
+    {
+        uint32_t s1 = slot.seq.load(std::memory_order_acquire);
+        if (s1 & 1)
+        {
+            ++retries;
+            std::this_thread::yield();
+            continue;
+        }
+        Snapshot snap;
+        snap.creation_unit = slot.creation_unit.load(std::memory_order_relaxed);
+        snap.missing = slot.missing.load(std::memory_order_relaxed);
+        snap.value2 = slot.value2.load(std::memory_order_relaxed);
+        snap.version = slot.version.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) != s1)
+        {
+            ++retries;
+            continue;
+        }
+        out = snap;
+        return true;
+    }
+}
@@ -3,6 +3,7 @@
 #include <memory>
 #include <string>
 
+#include "message_builder.h"
 #include "orderbook.h"
 
 // Tee stream - writes to both cout and file
@@ -32,172 +33,6 @@ class TeeStream
     }
 };
 
-// Helper to build ITCH 5.0 messages
-class MessageBuilder
-{
-   public:
-    // Build Add Order (No MPID) - 'A' - 36 bytes
-    static std::vector<uint8_t> build_add_order(uint64_t order_id, uint32_t price,
-                                                uint32_t quantity, char side, uint64_t timestamp)
-    {
-        std::vector<uint8_t> msg;
-        msg.push_back('A');  // Message Type
-        
-        // Stock Locate (2 bytes) - use 0 for prototype
-        push_u16(msg, 0);
-        
-        // Tracking Number (2 bytes) - use 0 for prototype
-        push_u16(msg, 0);
-        
-        // Timestamp (6 bytes) - nanoseconds since midnight, little-endian
-        for (int i = 0; i < 6; ++i)
-        {
-            msg.push_back((timestamp >> (8 * i)) & 0xFF);
-        }
-        
-        // Order Reference Number (8 bytes)
-        push_u64(msg, order_id);
-        
-        // Buy/Sell Indicator (1 byte) - 'B' or 'S'
-        msg.push_back(side);
-        
-        // Shares (4 bytes)
-        push_u32(msg, quantity);
-        
-        // Stock (8 bytes) - right-padded with spaces, use "TEST    "
-        msg.push_back('T');
-        msg.push_back('E');
-        msg.push_back('S');
-        msg.push_back('T');
-        msg.push_back(' ');
-        msg.push_back(' ');
-        msg.push_back(' ');
-        msg.push_back(' ');
-        
-        // Price (4 bytes) - 4 decimal places
-        push_u32(msg, price);
-        
-        return msg;  // Total: 36 bytes
-    }
-
-    // Build Order Cancel - 'X' - 23 bytes
-    static std::vector<uint8_t> build_cancel_order(uint64_t order_id, uint32_t cancelled_shares = 0)
-    {
-        std::vector<uint8_t> msg;
-        msg.push_back('X');  // Message Type
-        
-        // Stock Locate (2 bytes)
-        push_u16(msg, 0);
-        
-        // Tracking Number (2 bytes)
-        push_u16(msg, 0);
-        
-        // Timestamp (6 bytes) - use current timestamp or 0
-        for (int i = 0; i < 6; ++i)
-        {
-            msg.push_back(0);
-        }
-        
-        // Order Reference Number (8 bytes)
-        push_u64(msg, order_id);
-        
-        // Cancelled Shares (4 bytes) - 0 means full cancel
-        push_u32(msg, cancelled_shares);
-        
-        return msg;  // Total: 23 bytes
-    }
-
-    // Build Order Executed - 'E' - 31 bytes
-    static std::vector<uint8_t> build_execute_order(uint64_t order_id, uint32_t quantity)
-    {
-        std::vector<uint8_t> msg;
-        msg.push_back('E');  // Message Type
-        
-        // Stock Locate (2 bytes)
-        push_u16(msg, 0);
-        
-        // Tracking Number (2 bytes)
-        push_u16(msg, 0);
-        
-        // Timestamp (6 bytes)
-        for (int i = 0; i < 6; ++i)
-        {
-            msg.push_back(0);
-        }
-        
-        // Order Reference Number (8 bytes)
-        push_u64(msg, order_id);
-        
-        // Executed Shares (4 bytes)
-        push_u32(msg, quantity);
-        
-        // Match Number (8 bytes) - use 0 for prototype
-        push_u64(msg, 0);
-        
-        return msg;  // Total: 31 bytes
-    }
-
-    // Build Order Replace - 'U' - 35 bytes
-    static std::vector<uint8_t> build_replace_order(uint64_t old_order_id, uint64_t new_order_id,
-                                                     uint32_t new_price, uint32_t new_quantity,
-                                                     uint64_t timestamp = 0)
-    {
-        std::vector<uint8_t> msg;
-        msg.push_back('U');  // Message Type
-        
-        // Stock Locate (2 bytes)
-        push_u16(msg, 0);
-        
-        // Tracking Number (2 bytes)
-        push_u16(msg, 0);
-        
-        // Timestamp (6 bytes)
-        for (int i = 0; i < 6; ++i)
-        {
-            msg.push_back((timestamp >> (8 * i)) & 0xFF);
-        }
-        
-        // Original Order Reference Number (8 bytes)
-        push_u64(msg, old_order_id);
-        
-        // New Order Reference Number (8 bytes)
-        push_u64(msg, new_order_id);
-        
-        // Shares (4 bytes)
-        push_u32(msg, new_quantity);
-        
-        // Price (4 bytes)
-        push_u32(msg, new_price);
-        
-        return msg;  // Total: 35 bytes
-    }
-
-   private:
-    static void push_u16(std::vector<uint8_t>& msg, uint16_t value)
-    {
-        for (int i = 0; i < 2; ++i)
-        {
-            msg.push_back((value >> (8 * i)) & 0xFF);
-        }
-    }
-    
-    static void push_u64(std::vector<uint8_t>& msg, uint64_t value)
-    {
-        for (int i = 0; i < 8; ++i)
-        {
-            msg.push_back((value >> (8 * i)) & 0xFF);
-        }
-    }
-
-    static void push_u32(std::vector<uint8_t>& msg, uint32_t value)
-    {
-        for (int i = 0; i < 4; ++i)
-        {
-            msg.push_back((value >> (8 * i)) & 0xFF);
-        }
-    }
-};
-
 int main()
 {
     // Create debug directory if it doesn't exist (one level up from executable)
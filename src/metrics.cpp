@@ -0,0 +1,466 @@
+#include "metrics.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+// ============================================================================
+// Storage
+// ============================================================================
+
+// One slab per recording thread; the alignment keeps slabs of different
+// threads off each other's cache lines
+struct alignas(64) MetricsRegistry::ThreadSlab
+{
+    struct HistogramCells
+    {
+        std::atomic<uint64_t> buckets[HISTOGRAM_BUCKETS];
+        std::atomic<uint64_t> count;
+        std::atomic<uint64_t> sum;
+    };
+
+    ThreadSlab()
+    {
+        for (auto& c : counters) c.store(0, std::memory_order_relaxed);
+        for (auto& h : histograms)
+        {
+            for (auto& b : h.buckets) b.store(0, std::memory_order_relaxed);
+            h.count.store(0, std::memory_order_relaxed);
+            h.sum.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<uint64_t> counters[MAX_COUNTERS];
+    HistogramCells histograms[MAX_HISTOGRAMS];
+};
+
+struct alignas(64) MetricsRegistry::GaugeCell
+{
+    std::atomic<int64_t> value{0};
+};
+
+// Single-writer increment: no locked RMW, readers see a torn-free value
+static inline void bump(std::atomic<uint64_t>& cell, uint64_t n)
+{
+    cell.store(cell.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+static std::atomic<uint64_t> next_registry_id{1};
+
+MetricsRegistry::MetricsRegistry()
+    : id_(next_registry_id.fetch_add(1, std::memory_order_relaxed)),
+      gauges_(new GaugeCell[MAX_GAUGES])
+{
+}
+
+MetricsRegistry::~MetricsRegistry() = default;
+
+// ============================================================================
+// Thread Slab Lookup
+// ============================================================================
+
+namespace
+{
+// Small per-thread cache of (registry id -> slab); ids are never reused
+struct SlabCacheEntry
+{
+    uint64_t registry_id = 0;
+    void* slab = nullptr;
+};
+constexpr size_t SLAB_CACHE_SIZE = 4;
+thread_local SlabCacheEntry slab_cache[SLAB_CACHE_SIZE];
+thread_local size_t slab_cache_next = 0;
+}  // namespace
+
+MetricsRegistry::ThreadSlab& MetricsRegistry::local_slab()
+{
+    for (const auto& entry : slab_cache)
+    {
+        if (entry.registry_id == id_) return *static_cast<ThreadSlab*>(entry.slab);
+    }
+    return register_thread();
+}
+
+// Cache miss: the thread's slab in this registry, created on first use
+MetricsRegistry::ThreadSlab& MetricsRegistry::register_thread()
+{
+    ThreadSlab* slab;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ThreadSlab*& owned = thread_slabs_[std::this_thread::get_id()];
+        if (!owned)
+        {
+            slabs_.push_back(std::make_unique<ThreadSlab>());
+            owned = slabs_.back().get();
+        }
+        slab = owned;
+    }
+    slab_cache[slab_cache_next] = SlabCacheEntry{id_, slab};
+    slab_cache_next = (slab_cache_next + 1) % SLAB_CACHE_SIZE;
+    return *slab;
+}
+
+// ============================================================================
+// Handles
+// ============================================================================
+
+void MetricsRegistry::Counter::inc(uint64_t n) const
+{
+    if (!registry_) return;
+    bump(registry_->local_slab().counters[index_], n);
+}
+
+void MetricsRegistry::Gauge::set(int64_t value) const
+{
+    if (!registry_) return;
+    registry_->gauges_[index_].value.store(value, std::memory_order_relaxed);
+}
+
+void MetricsRegistry::Gauge::add(int64_t delta) const
+{
+    if (!registry_) return;
+    registry_->gauges_[index_].value.fetch_add(delta, std::memory_order_relaxed);
+}
+
+void MetricsRegistry::Histogram::observe(uint64_t value) const
+{
+    if (!registry_) return;
+    auto& cells = registry_->local_slab().histograms[index_];
+    bump(cells.buckets[bucket_for(value)], 1);
+    bump(cells.count, 1);
+    bump(cells.sum, value);
+}
+
+// ============================================================================
+// Registration
+// ============================================================================
+
+MetricsRegistry::Counter MetricsRegistry::counter(const std::string& name, const std::string& help,
+                                                  const std::string& labels)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (counter_info_.size() >= MAX_COUNTERS) return Counter{};
+    counter_info_.push_back(MetricInfo{name, help, labels});
+    return Counter(this, static_cast<uint32_t>(counter_info_.size() - 1));
+}
+
+MetricsRegistry::Gauge MetricsRegistry::gauge(const std::string& name, const std::string& help,
+                                              const std::string& labels)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (gauge_info_.size() >= MAX_GAUGES) return Gauge{};
+    gauge_info_.push_back(MetricInfo{name, help, labels});
+    return Gauge(this, static_cast<uint32_t>(gauge_info_.size() - 1));
+}
+
+MetricsRegistry::Histogram MetricsRegistry::histogram(const std::string& name,
+                                                      const std::string& help,
+                                                      const std::string& labels)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (histogram_info_.size() >= MAX_HISTOGRAMS) return Histogram{};
+    histogram_info_.push_back(MetricInfo{name, help, labels});
+    return Histogram(this, static_cast<uint32_t>(histogram_info_.size() - 1));
+}
+
+// ============================================================================
+// Aggregated Reads
+// ============================================================================
+
+uint64_t MetricsRegistry::read(const Counter& counter) const
+{
+    if (counter.registry_ != this) return 0;
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t total = 0;
+    for (const auto& slab : slabs_)
+    {
+        total += slab->counters[counter.index_].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+int64_t MetricsRegistry::read(const Gauge& gauge) const
+{
+    if (gauge.registry_ != this) return 0;
+    return gauges_[gauge.index_].value.load(std::memory_order_relaxed);
+}
+
+MetricsRegistry::HistogramSnapshot MetricsRegistry::read(const Histogram& histogram) const
+{
+    HistogramSnapshot snap;
+    if (histogram.registry_ != this) return snap;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& slab : slabs_)
+    {
+        const auto& cells = slab->histograms[histogram.index_];
+        for (size_t b = 0; b < HISTOGRAM_BUCKETS; ++b)
+        {
+            snap.buckets[b] += cells.buckets[b].load(std::memory_order_relaxed);
+        }
+        snap.count += cells.count.load(std::memory_order_relaxed);
+        snap.sum += cells.sum.load(std::memory_order_relaxed);
+    }
+    return snap;
+}
+
+size_t MetricsRegistry::thread_slab_count() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return slabs_.size();
+}
+
+// ============================================================================
+// Prometheus Export
+// ============================================================================
+
+namespace
+{
+// Metric indices with each family's label sets together: the exposition
+// format allows one HELP/TYPE per family and its series must be contiguous,
+// but label sets of one name may be registered far apart (two bound fabrics)
+template <typename Info>
+std::vector<size_t> by_family(const std::vector<Info>& infos)
+{
+    std::vector<size_t> order(infos.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return infos[a].name < infos[b].name; });
+    return order;
+}
+
+// HELP/TYPE once per metric family (indices in by_family() order)
+void write_family_header(std::ostream& os, std::string& last_name, const std::string& name,
+                         const std::string& help, const char* type)
+{
+    if (name == last_name) return;
+    os << "# HELP " << name << " " << help << "\n";
+    os << "# TYPE " << name << " " << type << "\n";
+    last_name = name;
+}
+
+std::string with_labels(const std::string& name, const std::string& labels,
+                        const std::string& extra = "")
+{
+    std::string all = labels;
+    if (!extra.empty()) all += (all.empty() ? "" : ",") + extra;
+    return all.empty() ? name : name + "{" + all + "}";
+}
+}  // namespace
+
+void MetricsRegistry::write_prometheus(std::ostream& os) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string last_name;
+
+    for (size_t i : by_family(counter_info_))
+    {
+        const auto& info = counter_info_[i];
+        uint64_t total = 0;
+        for (const auto& slab : slabs_) total += slab->counters[i].load(std::memory_order_relaxed);
+        write_family_header(os, last_name, info.name, info.help, "counter");
+        os << with_labels(info.name, info.labels) << " " << total << "\n";
+    }
+
+    for (size_t i : by_family(gauge_info_))
+    {
+        const auto& info = gauge_info_[i];
+        write_family_header(os, last_name, info.name, info.help, "gauge");
+        os << with_labels(info.name, info.labels) << " "
+           << gauges_[i].value.load(std::memory_order_relaxed) << "\n";
+    }
+
+    for (size_t i : by_family(histogram_info_))
+    {
+        const auto& info = histogram_info_[i];
+        HistogramSnapshot snap;
+        for (const auto& slab : slabs_)
+        {
+            const auto& cells = slab->histograms[i];
+            for (size_t b = 0; b < HISTOGRAM_BUCKETS; ++b)
+            {
+                snap.buckets[b] += cells.buckets[b].load(std::memory_order_relaxed);
+            }
+            snap.count += cells.count.load(std::memory_order_relaxed);
+            snap.sum += cells.sum.load(std::memory_order_relaxed);
+        }
+
+        write_family_header(os, last_name, info.name, info.help, "histogram");
+        // Cumulative buckets up to the highest non-empty one, then +Inf
+        size_t top = 0;
+        for (size_t b = 0; b < HISTOGRAM_BUCKETS; ++b)
+        {
+            if (snap.buckets[b]) top = b;
+        }
+        uint64_t cumulative = 0;
+        for (size_t b = 0; b <= top; ++b)
+        {
+            cumulative += snap.buckets[b];
+            uint64_t upper = (b == 0) ? 0 : ((b >= 64) ? ~0ULL : (1ULL << b) - 1);
+            os << with_labels(info.name + "_bucket", info.labels,
+                              "le=\"" + std::to_string(upper) + "\"")
+               << " " << cumulative << "\n";
+        }
+        os << with_labels(info.name + "_bucket", info.labels, "le=\"+Inf\"") << " " << snap.count
+           << "\n";
+        os << with_labels(info.name + "_sum", info.labels) << " " << snap.sum << "\n";
+        os << with_labels(info.name + "_count", info.labels) << " " << snap.count << "\n";
+    }
+}
+
+bool MetricsRegistry::write_to_file(const std::string& path) const
+{
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::trunc);
+        if (!out.is_open()) return false;
+        write_prometheus(out);
+        if (!out.good()) return false;
+    }
+    return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+// ============================================================================
+// MetricsExporter Implementation
+// ============================================================================
+
+bool MetricsExporter::start_file(const std::string& path, std::chrono::milliseconds interval)
+{
+    if (thread_.joinable()) return false;
+    stop_.store(false, std::memory_order_relaxed);
+    thread_ = std::thread([this, path, interval] { file_loop(path, interval); });
+    return true;
+}
+
+void MetricsExporter::file_loop(std::string path, std::chrono::milliseconds interval)
+{
+    while (!stop_.load(std::memory_order_acquire))
+    {
+        if (registry_.write_to_file(path)) scrapes_.fetch_add(1, std::memory_order_relaxed);
+
+        // Sleep in short steps so stop() is prompt
+        auto deadline = std::chrono::steady_clock::now() + interval;
+        while (!stop_.load(std::memory_order_acquire) && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    registry_.write_to_file(path);  // Final snapshot
+}
+
+#ifndef _WIN32
+bool MetricsExporter::start_http(uint16_t port, const std::string& bind_address)
+{
+    if (thread_.joinable()) return false;
+
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    int one = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (::inet_pton(AF_INET, bind_address.c_str(), &addr.sin_addr) != 1 ||
+        ::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(fd, 8) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    socklen_t len = sizeof(addr);
+    ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+    listen_fd_ = fd;
+
+    stop_.store(false, std::memory_order_relaxed);
+    thread_ = std::thread([this] { serve_loop(); });
+    return true;
+}
+
+void MetricsExporter::serve_loop()
+{
+    while (!stop_.load(std::memory_order_acquire))
+    {
+        pollfd pfd{listen_fd_, POLLIN, 0};
+        if (::poll(&pfd, 1, 100) <= 0) continue;
+
+        int client = ::accept(listen_fd_, nullptr, nullptr);
+        if (client < 0) continue;
+
+        // Wait for the request in short polls, watching the stop flag
+        bool readable = false;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(CLIENT_TIMEOUT_MS);
+        while (!stop_.load(std::memory_order_acquire) && std::chrono::steady_clock::now() < deadline)
+        {
+            pollfd cfd{client, POLLIN, 0};
+            if (::poll(&cfd, 1, 100) > 0)
+            {
+                readable = true;
+                break;
+            }
+        }
+        if (!readable)
+        {
+            ::close(client);
+            continue;
+        }
+        timeval send_timeout{CLIENT_TIMEOUT_MS / 1000, (CLIENT_TIMEOUT_MS % 1000) * 1000};
+        ::setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &send_timeout, sizeof(send_timeout));
+
+        // Read the request head; any path other than /metrics gets 404
+        char request[1024];
+        ssize_t n = ::recv(client, request, sizeof(request) - 1, 0);
+        request[n > 0 ? n : 0] = '\0';
+        bool is_metrics = std::strncmp(request, "GET /metrics", 12) == 0;
+
+        std::ostringstream body;
+        if (is_metrics) registry_.write_prometheus(body);
+        std::string payload = body.str();
+
+        std::ostringstream response;
+        response << (is_metrics ? "HTTP/1.1 200 OK\r\n" : "HTTP/1.1 404 Not Found\r\n")
+                 << "Content-Type: text/plain; version=0.0.4\r\n"
+                 << "Content-Length: " << payload.size() << "\r\n"
+                 << "Connection: close\r\n\r\n"
+                 << payload;
+        std::string out = response.str();
+        size_t sent = 0;
+        while (sent < out.size())
+        {
+            ssize_t w = ::send(client, out.data() + sent, out.size() - sent, MSG_NOSIGNAL);
+            if (w <= 0) break;
+            sent += static_cast<size_t>(w);
+        }
+        ::close(client);
+        if (is_metrics) scrapes_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+#else
+bool MetricsExporter::start_http(uint16_t, const std::string&)
+{
+    return false;  // Use start_file() on Windows
+}
+
+void MetricsExporter::serve_loop() {}
+#endif
+
+void MetricsExporter::stop()
+{
+    stop_.store(true, std::memory_order_release);
+    if (thread_.joinable()) thread_.join();
+#ifndef _WIN32
+    if (listen_fd_ >= 0) ::close(listen_fd_);
+#endif
+    listen_fd_ = -1;
+}
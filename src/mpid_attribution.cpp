@@ -0,0 +1,112 @@
+#include "mpid_attribution.h"
+
+#include <algorithm>
+#include <utility>
+
+// ============================================================================
+// MPID Interning
+// ============================================================================
+
+uint16_t MpidAttribution::intern(uint32_t code)
+{
+    auto it = ids_.find(code);
+    if (it != ids_.end()) return it->second;
+    if (codes_.size() > MAX_MPIDS) return NONE;
+
+    uint16_t id = static_cast<uint16_t>(codes_.size());
+    codes_.push_back(code);
+    ids_.emplace(code, id);
+    return id;
+}
+
+std::string MpidAttribution::name(uint16_t mpid) const
+{
+    uint32_t c = code(mpid);
+    std::string out;
+    for (int i = 0; i < 4 && c; ++i, c >>= 8)
+    {
+        char ch = static_cast<char>(c & 0xFF);
+        if (ch != ' ') out.push_back(ch);
+    }
+    return out;
+}
+
+// ============================================================================
+// Level Maintenance
+// ============================================================================
+
+void MpidAttribution::on_add(uint16_t mpid, Side side, uint32_t price, uint64_t quantity,
+                             bool creates_level)
+{
+    if (mpid == NONE) return;
+
+    auto [it, inserted] = levels_.try_emplace(key(side, price));
+    Level& level = it->second;
+    if (inserted && creates_level) level.setter = mpid;
+
+    auto& shares = level.shares;
+    size_t i = 0;
+    while (i < shares.size() && shares[i].mpid != mpid) ++i;
+    if (i == shares.size()) shares.push_back(MpidShare{mpid, 0, 0});
+
+    shares[i].orders++;
+    shares[i].quantity += quantity;
+
+    // Grew - move towards the front
+    while (i > 0 && shares[i - 1].quantity < shares[i].quantity)
+    {
+        std::swap(shares[i - 1], shares[i]);
+        --i;
+    }
+}
+
+void MpidAttribution::on_reduce(uint16_t mpid, Side side, uint32_t price, uint64_t quantity,
+                                bool order_removed)
+{
+    if (mpid == NONE) return;
+
+    auto it = levels_.find(key(side, price));
+    if (it == levels_.end()) return;
+    auto& shares = it->second.shares;
+
+    size_t i = 0;
+    while (i < shares.size() && shares[i].mpid != mpid) ++i;
+    if (i == shares.size()) return;
+
+    shares[i].quantity -= std::min(quantity, shares[i].quantity);
+    if (order_removed) shares[i].orders--;
+
+    if (shares[i].orders == 0)
+    {
+        shares.erase(shares.begin() + static_cast<std::ptrdiff_t>(i));
+        return;  // The entry (and its setter) stays until the book level goes
+    }
+
+    // Shrank - move towards the back
+    while (i + 1 < shares.size() && shares[i + 1].quantity > shares[i].quantity)
+    {
+        std::swap(shares[i + 1], shares[i]);
+        ++i;
+    }
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+size_t MpidAttribution::top(Side side, uint32_t price, size_t n, MpidShare* out) const
+{
+    auto it = levels_.find(key(side, price));
+    if (it == levels_.end()) return 0;
+
+    const auto& shares = it->second.shares;
+    size_t count = std::min(n, shares.size());
+    std::copy(shares.begin(), shares.begin() + static_cast<std::ptrdiff_t>(count), out);
+    return count;
+}
+
+uint16_t MpidAttribution::setter(Side side, uint32_t price) const
+{
+    auto it = levels_.find(key(side, price));
+    return it == levels_.end() ? NONE : it->second.setter;
+}
@@ -0,0 +1,149 @@
+#include "mpsc_fabric.h"
+
+#include <algorithm>
+
+// ============================================================================
+// Lane Layout
+// ============================================================================
+
+// Byte depth is derived from two single-writer counters, so neither side
+// needs a read-modify-write: producer owns bytes_written, consumer bytes_read.
+struct MpscFabric::Lane
+{
+    explicit Lane(size_t slots) : ring(slots) {}
+
+    SpscRing<Chunk> ring;
+
+    // Producer-owned
+    alignas(64) std::atomic<size_t> bytes_written{0};
+    std::atomic<size_t> chunks_written{0};
+    std::atomic<size_t> backpressure_events{0};
+    std::atomic<size_t> bytes_dropped{0};
+    std::atomic<size_t> max_depth{0};
+
+    // Consumer-owned
+    alignas(64) std::atomic<size_t> bytes_read{0};
+    std::atomic<size_t> chunks_read{0};
+};
+
+// Single-writer update: relaxed store, no locked instruction
+static inline void bump(std::atomic<size_t>& cell, size_t n)
+{
+    cell.store(cell.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+// ============================================================================
+// MpscFabric Implementation
+// ============================================================================
+
+MpscFabric::MpscFabric() : MpscFabric(Config{}) {}
+
+MpscFabric::MpscFabric(const Config& config) : lane_depth_bytes_(config.lane_depth_bytes)
+{
+    size_t producers = std::max<size_t>(config.producers, 1);
+    for (size_t i = 0; i < producers; ++i)
+    {
+        lanes_.push_back(std::make_unique<Lane>(config.lane_slots));
+    }
+}
+
+MpscFabric::~MpscFabric() = default;
+
+bool MpscFabric::write_chunk(size_t producer, const Chunk& chunk)
+{
+    Lane& lane = *lanes_[producer];
+    size_t written = lane.bytes_written.load(std::memory_order_relaxed);
+    size_t depth = written - lane.bytes_read.load(std::memory_order_acquire);
+
+    // Byte depth or slot count exhausted - TREADY = 0
+    if (depth + chunk.size() > lane_depth_bytes_ || !lane.ring.try_push(chunk))
+    {
+        bump(lane.backpressure_events, 1);
+        bump(lane.bytes_dropped, chunk.size());
+        return false;
+    }
+
+    lane.bytes_written.store(written + chunk.size(), std::memory_order_release);
+    bump(lane.chunks_written, 1);
+    if (depth + chunk.size() > lane.max_depth.load(std::memory_order_relaxed))
+    {
+        lane.max_depth.store(depth + chunk.size(), std::memory_order_relaxed);
+    }
+    return true;
+}
+
+bool MpscFabric::read_chunk(Chunk& out)
+{
+    size_t producer;
+    return read_chunk(out, producer);
+}
+
+bool MpscFabric::read_chunk(Chunk& out, size_t& producer_out)
+{
+    const size_t n = lanes_.size();
+    for (size_t i = 0; i < n; ++i)
+    {
+        size_t index = cursor_ + i;
+        if (index >= n) index -= n;
+
+        Lane& lane = *lanes_[index];
+        if (!lane.ring.try_pop(out)) continue;
+
+        lane.bytes_read.store(lane.bytes_read.load(std::memory_order_relaxed) + out.size(),
+                              std::memory_order_release);
+        bump(lane.chunks_read, 1);
+
+        // Next call starts at the following lane - one chunk per lane per turn
+        cursor_ = (index + 1 == n) ? 0 : index + 1;
+        producer_out = index;
+        return true;
+    }
+    return false;
+}
+
+bool MpscFabric::empty() const
+{
+    for (const auto& lane : lanes_)
+    {
+        if (!lane->ring.empty()) return false;
+    }
+    return true;
+}
+
+size_t MpscFabric::depth_bytes(size_t producer) const
+{
+    const Lane& lane = *lanes_[producer];
+    return lane.bytes_written.load(std::memory_order_acquire) -
+           lane.bytes_read.load(std::memory_order_acquire);
+}
+
+MpscFabric::LaneStats MpscFabric::get_lane_stats(size_t producer) const
+{
+    const Lane& lane = *lanes_[producer];
+    LaneStats stats;
+    stats.chunks_written = lane.chunks_written.load(std::memory_order_relaxed);
+    stats.chunks_read = lane.chunks_read.load(std::memory_order_relaxed);
+    stats.backpressure_events = lane.backpressure_events.load(std::memory_order_relaxed);
+    stats.total_bytes_written = lane.bytes_written.load(std::memory_order_relaxed);
+    stats.total_bytes_dropped = lane.bytes_dropped.load(std::memory_order_relaxed);
+    stats.total_bytes_read = lane.bytes_read.load(std::memory_order_relaxed);
+    stats.max_depth_reached = lane.max_depth.load(std::memory_order_relaxed);
+    return stats;
+}
+
+MpscFabric::LaneStats MpscFabric::get_total_stats() const
+{
+    LaneStats total;
+    for (size_t i = 0; i < lanes_.size(); ++i)
+    {
+        LaneStats s = get_lane_stats(i);
+        total.chunks_written += s.chunks_written;
+        total.chunks_read += s.chunks_read;
+        total.backpressure_events += s.backpressure_events;
+        total.total_bytes_written += s.total_bytes_written;
+        total.total_bytes_dropped += s.total_bytes_dropped;
+        total.total_bytes_read += s.total_bytes_read;
+        total.max_depth_reached = std::max(total.max_depth_reached, s.max_depth_reached);
+    }
+    return total;
+}
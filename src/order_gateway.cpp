@@ -0,0 +1,307 @@
+#include "order_gateway.h"
+
+#include <chrono>
+#include <cstring>
+#include <new>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+static uint64_t steady_now_ns()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+// ============================================================================
+// ShmOrderRing
+// ============================================================================
+
+ShmOrderRing::ShmOrderRing(size_t frames)
+{
+    size_t rounded = 2;
+    while (rounded < frames) rounded <<= 1;
+    mask_ = rounded - 1;
+
+#ifndef _WIN32
+    mapping_bytes_ = sizeof(Header) + rounded * FRAME_SIZE;
+    void* base = ::mmap(nullptr, mapping_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) return;
+    mapping_ = base;
+    header_ = new (base) Header{};
+    header_->head.store(0, std::memory_order_relaxed);
+    header_->tail.store(0, std::memory_order_relaxed);
+    frames_ = static_cast<uint8_t*>(base) + sizeof(Header);
+#endif
+}
+
+ShmOrderRing::~ShmOrderRing()
+{
+#ifndef _WIN32
+    if (mapping_) ::munmap(mapping_, mapping_bytes_);
+#endif
+}
+
+bool ShmOrderRing::send(const uint8_t* data, size_t length)
+{
+    if (!header_ || length > MAX_PAYLOAD) return false;
+
+    uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+    if (tail - head_cache_ > mask_)
+    {
+        head_cache_ = header_->head.load(std::memory_order_acquire);
+        if (tail - head_cache_ > mask_)
+        {
+            full_events_++;
+            return false;
+        }
+    }
+
+    uint8_t* frame = frames_ + (tail & mask_) * FRAME_SIZE;
+    frame[0] = static_cast<uint8_t>(length);
+    frame[1] = static_cast<uint8_t>(length >> 8);
+    std::memcpy(frame + 2, data, length);
+    header_->tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+size_t ShmOrderRing::receive(uint8_t* out)
+{
+    if (!header_) return 0;
+
+    uint64_t head = header_->head.load(std::memory_order_relaxed);
+    if (head == tail_cache_)
+    {
+        tail_cache_ = header_->tail.load(std::memory_order_acquire);
+        if (head == tail_cache_) return 0;
+    }
+
+    const uint8_t* frame = frames_ + (head & mask_) * FRAME_SIZE;
+    size_t length = frame[0] | (static_cast<size_t>(frame[1]) << 8);
+    std::memcpy(out, frame + 2, length);
+    header_->head.store(head + 1, std::memory_order_release);
+    return length;
+}
+
+// ============================================================================
+// LoopbackOrderSession
+// ============================================================================
+
+#ifndef _WIN32
+bool LoopbackOrderSession::connect(uint16_t port, const std::string& host)
+{
+    close();
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (::inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1 ||
+        ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    fd_ = fd;
+    return true;
+}
+
+void LoopbackOrderSession::close()
+{
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+}
+
+bool LoopbackOrderSession::send(const uint8_t* data, size_t length)
+{
+    if (fd_ < 0 || length > OuchEncoder::MAX_MESSAGE_SIZE) return false;
+
+    // SoupBinTCP: 2-byte big-endian length of (type + payload), type 'U'
+    uint8_t packet[3 + OuchEncoder::MAX_MESSAGE_SIZE];
+    packet[0] = static_cast<uint8_t>((length + 1) >> 8);
+    packet[1] = static_cast<uint8_t>(length + 1);
+    packet[2] = 'U';
+    std::memcpy(packet + 3, data, length);
+
+    size_t total = length + 3;
+    size_t sent = 0;
+    while (sent < total)
+    {
+        ssize_t w = ::send(fd_, packet + sent, total - sent, MSG_NOSIGNAL);
+        if (w <= 0)
+        {
+            send_errors_++;
+            return false;
+        }
+        sent += static_cast<size_t>(w);
+    }
+    return true;
+}
+#else
+bool LoopbackOrderSession::connect(uint16_t, const std::string&) { return false; }
+void LoopbackOrderSession::close() {}
+bool LoopbackOrderSession::send(const uint8_t*, size_t) { return false; }
+#endif
+
+// ============================================================================
+// LocalExchange
+// ============================================================================
+
+#ifndef _WIN32
+bool LocalExchange::listen(uint16_t port, const std::string& bind_address)
+{
+    if (thread_.joinable() || listen_fd_ >= 0) return false;
+
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    int one = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (::inet_pton(AF_INET, bind_address.c_str(), &addr.sin_addr) != 1 ||
+        ::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(fd, 1) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    socklen_t len = sizeof(addr);
+    ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+    listen_fd_ = fd;
+    return true;
+}
+#else
+bool LocalExchange::listen(uint16_t, const std::string&)
+{
+    return false;
+}
+#endif
+
+bool LocalExchange::start()
+{
+    if (thread_.joinable() || (!ring_ && listen_fd_ < 0)) return false;
+    stop_.store(false, std::memory_order_relaxed);
+    thread_ = std::thread([this] { run(); });
+    return true;
+}
+
+void LocalExchange::stop()
+{
+    stop_.store(true, std::memory_order_release);
+    if (thread_.joinable()) thread_.join();
+#ifndef _WIN32
+    if (client_fd_ >= 0) ::close(client_fd_);
+    if (listen_fd_ >= 0) ::close(listen_fd_);
+#endif
+    client_fd_ = -1;
+    listen_fd_ = -1;
+}
+
+LocalExchange::Stats LocalExchange::get_stats() const
+{
+    return stats_;
+}
+
+void LocalExchange::handle(const uint8_t* data, size_t length, uint64_t recv_ns)
+{
+    OuchMessage msg;
+    if (!OuchDecoder::parse(data, length, msg))
+    {
+        stats_.malformed++;
+        return;
+    }
+    if (msg.type == 'O') stats_.enters++;
+    else if (msg.type == 'U') stats_.replaces++;
+    else stats_.cancels++;
+
+    if (callback_) callback_(msg, recv_ns);
+    messages_.fetch_add(1, std::memory_order_release);
+}
+
+void LocalExchange::drain_stream(uint64_t recv_ns)
+{
+    size_t offset = 0;
+    while (stream_.size() - offset >= 2)
+    {
+        size_t length = (static_cast<size_t>(stream_[offset]) << 8) | stream_[offset + 1];
+        if (stream_.size() - offset - 2 < length) break;
+
+        const uint8_t* packet = stream_.data() + offset + 2;
+        if (length == 0) stats_.malformed++;
+        else if (packet[0] == 'U') handle(packet + 1, length - 1, recv_ns);
+        // Other SoupBinTCP packet types (heartbeats, logout) carry no orders
+        offset += 2 + length;
+    }
+    stream_.erase(stream_.begin(), stream_.begin() + static_cast<std::ptrdiff_t>(offset));
+}
+
+void LocalExchange::run()
+{
+    uint8_t frame[ShmOrderRing::MAX_PAYLOAD];
+    while (!stop_.load(std::memory_order_acquire))
+    {
+        bool progress = false;
+        if (ring_)
+        {
+            while (size_t n = ring_->receive(frame))
+            {
+                handle(frame, n, steady_now_ns());
+                progress = true;
+            }
+        }
+
+#ifndef _WIN32
+        if (listen_fd_ >= 0)
+        {
+            // With a ring attached the socket is polled without blocking
+            pollfd pfd{client_fd_ >= 0 ? client_fd_ : listen_fd_, POLLIN, 0};
+            if (::poll(&pfd, 1, ring_ ? 0 : 50) > 0)
+            {
+                if (client_fd_ < 0)
+                {
+                    client_fd_ = ::accept(listen_fd_, nullptr, nullptr);
+                    if (client_fd_ >= 0)
+                    {
+                        int one = 1;
+                        ::setsockopt(client_fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                    }
+                }
+                else
+                {
+                    uint8_t buffer[4096];
+                    ssize_t n = ::recv(client_fd_, buffer, sizeof(buffer), 0);
+                    uint64_t now = steady_now_ns();
+                    if (n <= 0)
+                    {
+                        ::close(client_fd_);  // Session ended; accept the next one
+                        client_fd_ = -1;
+                        stream_.clear();
+                    }
+                    else
+                    {
+                        stream_.insert(stream_.end(), buffer, buffer + n);
+                        drain_stream(now);
+                        progress = true;
+                    }
+                }
+            }
+        }
+#endif
+
+        if (!progress && ring_) std::this_thread::yield();
+    }
+}
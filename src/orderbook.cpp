@@ -1,5 +1,10 @@
 #include "orderbook.h"
 
+#include "event_cache.h"
+#include "subscription_filter.h"
+
+#include <algorithm>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
 
@@ -8,11 +13,12 @@
 // ============================================================================
 
 // Helper function to get message length by type
-static size_t get_itch_message_length(char msg_type)
+size_t ITCHParser::message_length(char msg_type)
 {
     switch (msg_type)
     {
         case 'A': return ITCHParser::ADD_MSG_SIZE;
+        case 'F': return ITCHParser::ADD_MPID_MSG_SIZE;
         case 'X': return ITCHParser::CANCEL_MSG_SIZE;
         case 'E': return ITCHParser::EXECUTE_MSG_SIZE;
         case 'U': return ITCHParser::REPLACE_MSG_SIZE;
@@ -20,14 +26,16 @@ static size_t get_itch_message_length(char msg_type)
     }
 }
 
-// Helper to skip common ITCH header: Stock Locate (2) + Tracking Number (2)
-static void skip_itch_header(size_t& offset)
+// Helper to read common ITCH header: Stock Locate (2) + Tracking Number (2)
+static uint16_t read_itch_header(const uint8_t* buffer, size_t& offset)
 {
-    offset += 4;  // Skip to timestamp
+    uint16_t locate = static_cast<uint16_t>(buffer[offset] | (buffer[offset + 1] << 8));
+    offset += 4;  // Skip Tracking Number to timestamp
+    return locate;
 }
 
 // Helper to read 6-byte timestamp
-static uint64_t read_timestamp(const std::vector<uint8_t>& buffer, size_t& offset)
+static uint64_t read_timestamp(const uint8_t* buffer, size_t& offset)
 {
     uint64_t timestamp = 0;
     for (int i = 0; i < 6; ++i)
@@ -38,7 +46,7 @@ static uint64_t read_timestamp(const std::vector<uint8_t>& buffer, size_t& offse
     return timestamp;
 }
 
-uint64_t ITCHParser::read_u64(const std::vector<uint8_t>& buf, size_t& offset) const
+uint64_t ITCHParser::read_u64(const uint8_t* buf, size_t& offset) const
 {
     uint64_t value = 0;
     for (int i = 0; i < 8; ++i)
@@ -49,7 +57,7 @@ uint64_t ITCHParser::read_u64(const std::vector<uint8_t>& buf, size_t& offset) c
     return value;
 }
 
-uint32_t ITCHParser::read_u32(const std::vector<uint8_t>& buf, size_t& offset) const
+uint32_t ITCHParser::read_u32(const uint8_t* buf, size_t& offset) const
 {
     uint32_t value = 0;
     for (int i = 0; i < 4; ++i)
@@ -62,11 +70,16 @@ uint32_t ITCHParser::read_u32(const std::vector<uint8_t>& buf, size_t& offset) c
 
 std::optional<ITCHParser::ParseResult> ITCHParser::parse_one(const std::vector<uint8_t>& buffer) const
 {
-    if (buffer.empty())
+    return parse_one(buffer.data(), buffer.size());
+}
+
+std::optional<ITCHParser::ParseResult> ITCHParser::parse_one(const uint8_t* buffer, size_t length) const
+{
+    if (length == 0)
         return std::nullopt;  // No data available
 
     char msg_type = static_cast<char>(buffer[0]);
-    size_t expected_length = get_itch_message_length(msg_type);
+    size_t expected_length = message_length(msg_type);
     
     // Unknown message type
     if (expected_length == 0)
@@ -78,32 +91,50 @@ std::optional<ITCHParser::ParseResult> ITCHParser::parse_one(const std::vector<u
     }
     
     // Incomplete message - need more data
-    if (buffer.size() < expected_length)
+    if (length < expected_length)
         return std::nullopt;
     
-    ParseResult result{0, false, 0, 0, 0, 0, 0, 0, 0};
+    ParseResult result{0, false, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
     size_t offset = 1;  // Skip message type byte
 
     // Add Order (No MPID Attribution): 'A' - 36 bytes
     if (msg_type == 'A')
     {
         result.type = 'A';
-        skip_itch_header(offset);           // Skip Locate + Tracking
+        result.locate = read_itch_header(buffer, offset);  // Locate, skip Tracking
         result.timestamp = read_timestamp(buffer, offset);
         result.order_id = read_u64(buffer, offset);
         result.side = static_cast<char>(buffer[offset++]);
         result.quantity = read_u32(buffer, offset);
-        offset += 8;                        // Skip Stock symbol
+        std::memcpy(&result.stock, buffer + offset, 8);  // Stock, raw (SymbolTable::key)
+        offset += 8;
         result.price = read_u32(buffer, offset);
         result.bytes_consumed = ADD_MSG_SIZE;
         result.valid = true;
         return result;
     }
+    // Add Order with MPID Attribution: 'F' - 40 bytes ('A' layout + Attribution)
+    else if (msg_type == 'F')
+    {
+        result.type = 'F';
+        result.locate = read_itch_header(buffer, offset);  // Locate, skip Tracking
+        result.timestamp = read_timestamp(buffer, offset);
+        result.order_id = read_u64(buffer, offset);
+        result.side = static_cast<char>(buffer[offset++]);
+        result.quantity = read_u32(buffer, offset);
+        std::memcpy(&result.stock, buffer + offset, 8);  // Stock, raw (SymbolTable::key)
+        offset += 8;
+        result.price = read_u32(buffer, offset);
+        result.mpid = read_u32(buffer, offset);  // Raw ASCII, first char in the low byte
+        result.bytes_consumed = ADD_MPID_MSG_SIZE;
+        result.valid = true;
+        return result;
+    }
     // Order Cancel: 'X' - 23 bytes
     else if (msg_type == 'X')
     {
         result.type = 'X';
-        skip_itch_header(offset);           // Skip Locate + Tracking
+        result.locate = read_itch_header(buffer, offset);  // Locate, skip Tracking
         offset += 6;                        // Skip Timestamp
         result.order_id = read_u64(buffer, offset);
         result.quantity = read_u32(buffer, offset);  // Cancelled shares
@@ -115,7 +146,7 @@ std::optional<ITCHParser::ParseResult> ITCHParser::parse_one(const std::vector<u
     else if (msg_type == 'E')
     {
         result.type = 'E';
-        skip_itch_header(offset);           // Skip Locate + Tracking
+        result.locate = read_itch_header(buffer, offset);  // Locate, skip Tracking
         offset += 6;                        // Skip Timestamp
         result.order_id = read_u64(buffer, offset);
         result.quantity = read_u32(buffer, offset);
@@ -128,7 +159,7 @@ std::optional<ITCHParser::ParseResult> ITCHParser::parse_one(const std::vector<u
     else if (msg_type == 'U')
     {
         result.type = 'U';
-        skip_itch_header(offset);           // Skip Locate + Tracking
+        result.locate = read_itch_header(buffer, offset);  // Locate, skip Tracking
         result.timestamp = read_timestamp(buffer, offset);
         result.order_id = read_u64(buffer, offset);      // Original order
         result.new_order_id = read_u64(buffer, offset);  // New order
@@ -150,6 +181,13 @@ OrderBook::OrderBook(DataFabric& fabric) : fabric_(fabric) {}
 
 void OrderBook::process()
 {
+    if (adaptive_)
+    {
+        process_adaptive();
+        flush_batch();
+        return;
+    }
+
     // 1) Drain all chunks from fabric into message buffer
     DataFabric::Chunk chunk;
     while (fabric_.read_chunk(chunk))
@@ -164,10 +202,164 @@ void OrderBook::process()
                   << " bytes). Likely truncated frame or connection issue. Clearing buffer.\n";
         message_buffer_.clear();
         error_stats_.buffer_overflows++;
+        metrics_.buffer_overflows.inc();
         return;
     }
 
     // 3) Parse complete messages from buffer
+    drain_message_buffer();
+    flush_batch();
+}
+
+void OrderBook::bind_metrics(MetricsRegistry& registry, const std::string& labels)
+{
+    metrics_.messages =
+        registry.counter("orderbook_messages_total", "Decoded messages applied to the book", labels);
+    metrics_.filtered_messages = registry.counter(
+        "orderbook_filtered_messages_total", "Messages dropped by the subscription filter", labels);
+    metrics_.unknown_message_types = registry.counter(
+        "orderbook_unknown_message_types_total", "Bytes skipped as unknown message types", labels);
+    metrics_.buffer_overflows = registry.counter(
+        "orderbook_buffer_overflows_total", "Message buffer resets after overflow", labels);
+    metrics_.incomplete_messages = registry.counter(
+        "orderbook_incomplete_messages_total", "Parses that waited for more bytes", labels);
+    metrics_.invalid_operations = registry.counter(
+        "orderbook_invalid_operations_total", "Cancels/executes/replaces of unknown orders", labels);
+    metrics_.off_grid_prices = registry.counter(
+        "orderbook_off_grid_prices_total", "Adds/replaces rejected for off-grid prices", labels);
+}
+
+size_t OrderBook::process_some(size_t max_chunks)
+{
+    DataFabric::Chunk chunk;
+    size_t consumed = 0;
+    while (consumed < max_chunks && fabric_.read_chunk(chunk))
+    {
+        ++consumed;
+        message_buffer_.insert(message_buffer_.end(), chunk.begin(), chunk.end());
+
+        if (message_buffer_.size() > ITCHParser::MAX_BUFFER_SIZE)
+        {
+            std::cerr << "[ERROR] Buffer overflow detected (" << message_buffer_.size()
+                      << " bytes). Likely truncated frame or connection issue. Clearing buffer.\n";
+            message_buffer_.clear();
+            error_stats_.buffer_overflows++;
+            metrics_.buffer_overflows.inc();
+            continue;
+        }
+
+        drain_message_buffer();
+    }
+    flush_batch();
+    return consumed;
+}
+
+void OrderBook::enable_adaptive(const AdaptiveConfig& config)
+{
+    adaptive_config_ = config;
+    if (adaptive_config_.low_latency_batch == 0) adaptive_config_.low_latency_batch = 1;
+    if (adaptive_config_.pressure_batch == 0) adaptive_config_.pressure_batch = 1;
+    adaptive_ = true;
+}
+
+void OrderBook::disable_adaptive()
+{
+    adaptive_ = false;
+    pressure_mode_ = false;
+    deferring_ = false;
+    flush_deferred();
+}
+
+// One batch per call: the caller's loop gets control back between batches
+void OrderBook::process_adaptive()
+{
+    // Mode follows the fabric's edge-triggered pressure flag
+    bool pressure = fabric_.under_pressure();
+    if (pressure && !pressure_mode_)
+    {
+        adaptive_stats_.pressure_episodes++;
+        deferring_ = adaptive_config_.defer_callbacks;
+    }
+    else if (!pressure && pressure_mode_)
+    {
+        deferring_ = false;
+        flush_deferred();
+    }
+    pressure_mode_ = pressure;
+
+    size_t batch = pressure ? adaptive_config_.pressure_batch : adaptive_config_.low_latency_batch;
+    if (process_some(batch) > 0)
+    {
+        if (pressure) adaptive_stats_.pressure_batches++;
+        else adaptive_stats_.low_latency_batches++;
+        if (deferred_.size() >= adaptive_config_.max_deferred) flush_deferred();
+    }
+
+    // Fabric drained - nothing left to protect, release the backlog
+    if (fabric_.empty() && !fabric_.under_pressure())
+    {
+        pressure_mode_ = false;
+        deferring_ = false;
+        flush_deferred();
+    }
+}
+
+void OrderBook::set_batch_listener(BatchCallback cb, size_t max_batch)
+{
+    flush_batch();
+    batch_listener_ = std::move(cb);
+    max_batch_ = max_batch ? max_batch : 1;
+    batch_.reset(batch_listener_ ? new BookEvent[max_batch_] : nullptr);
+}
+
+void OrderBook::flush_batch()
+{
+    if (batch_size_ == 0) return;
+    batch_listener_(batch_.get(), batch_size_);
+    batch_size_ = 0;
+}
+
+void OrderBook::emit(char type, const Order& order)
+{
+    if (batch_listener_)
+    {
+        BookEvent& event = batch_[batch_size_++];
+        event.order_id = order.order_id;
+        event.timestamp = order.timestamp;
+        event.price = order.price;
+        event.quantity = order.quantity;
+        event.type = type;
+        event.side = order.side;
+        event.mpid = order.mpid;
+        if (batch_size_ == max_batch_) flush_batch();
+    }
+
+    if (!callback_) return;
+    if (!deferring_)
+    {
+        callback_(type, order);
+        return;
+    }
+    deferred_.emplace_back(type, order);
+    deferred_.back().second.book_info = nullptr;  // May not outlive the flush
+    adaptive_stats_.callbacks_deferred++;
+    if (deferred_.size() > adaptive_stats_.max_deferred_backlog)
+    {
+        adaptive_stats_.max_deferred_backlog = deferred_.size();
+    }
+}
+
+void OrderBook::flush_deferred()
+{
+    for (const auto& [type, order] : deferred_)
+    {
+        if (callback_) callback_(type, order);
+    }
+    deferred_.clear();
+}
+
+void OrderBook::drain_message_buffer()
+{
     while (true)
     {
         auto result_opt = parser_.parse_one(message_buffer_);
@@ -179,7 +371,7 @@ void OrderBook::process()
             if (!message_buffer_.empty())
             {
                 char msg_type = static_cast<char>(message_buffer_[0]);
-                size_t expected_len = get_itch_message_length(msg_type);
+                size_t expected_len = ITCHParser::message_length(msg_type);
                 
                 if (expected_len == 0)
                 {
@@ -189,12 +381,14 @@ void OrderBook::process()
                               << std::dec << "\n";
                     message_buffer_.erase(message_buffer_.begin());
                     error_stats_.unknown_message_types++;
+                    metrics_.unknown_message_types.inc();
                     continue;
                 }
                 else
                 {
                     // Incomplete message - wait for more data
                     error_stats_.incomplete_messages++;
+                    metrics_.incomplete_messages.inc();
                 }
             }
             break;
@@ -205,6 +399,7 @@ void OrderBook::process()
         if (!result.valid || result.bytes_consumed == 0)
             break;
 
+        if (recorder_) recorder_->append(result);
         handle_message(result);
 
         // Remove processed bytes from buffer
@@ -213,8 +408,102 @@ void OrderBook::process()
     }
 }
 
+void OrderBook::process_bytes(const uint8_t* data, size_t length)
+{
+    size_t offset = 0;
+
+    // 1) Complete a message left over from the previous block
+    while (!message_buffer_.empty() && offset < length)
+    {
+        size_t expected_len = ITCHParser::message_length(static_cast<char>(message_buffer_[0]));
+        if (expected_len == 0)
+        {
+            drain_message_buffer();  // Skips unknown bytes, counts errors
+            continue;
+        }
+        if (message_buffer_.size() < expected_len)
+        {
+            size_t take = std::min(expected_len - message_buffer_.size(), length - offset);
+            message_buffer_.insert(message_buffer_.end(), data + offset, data + offset + take);
+            offset += take;
+        }
+        drain_message_buffer();
+    }
+
+    // 2) Parse in place - no copy into message_buffer_
+    while (offset < length)
+    {
+        char msg_type = static_cast<char>(data[offset]);
+        size_t expected_len = ITCHParser::message_length(msg_type);
+
+        if (expected_len == 0)
+        {
+            std::cerr << "[ERROR] Skipping unknown message type byte: 0x" << std::hex
+                      << static_cast<int>(static_cast<uint8_t>(msg_type)) << std::dec << "\n";
+            error_stats_.unknown_message_types++;
+            metrics_.unknown_message_types.inc();
+            ++offset;
+            continue;
+        }
+
+        if (length - offset < expected_len)
+        {
+            // 3) Message spans the block boundary - carry the tail over
+            message_buffer_.insert(message_buffer_.end(), data + offset, data + length);
+            error_stats_.incomplete_messages++;
+            metrics_.incomplete_messages.inc();
+            break;
+        }
+
+        auto result_opt = parser_.parse_one(data + offset, length - offset);
+        if (!result_opt.has_value()) break;
+
+        if (recorder_) recorder_->append(*result_opt);
+        handle_message(*result_opt);
+        offset += expected_len;
+    }
+    flush_batch();
+}
+
+size_t OrderBook::replay(const EventCache& cache)
+{
+    const CachedEvent* events = cache.data();
+    const size_t count = cache.size();
+    for (size_t i = 0; i < count; ++i)
+    {
+        handle_message(events[i].to_result());
+    }
+    flush_batch();
+    return count;
+}
+
+bool OrderBook::set_tick_grid(const TickGrid* grid)
+{
+    if (!orders_.empty() || (grid && !grid->valid())) return false;
+    tick_grid_ = grid;
+    book_.setDenseKeys(grid != nullptr);
+    return true;
+}
+
+bool OrderBook::to_book_price(uint32_t price, uint32_t& key)
+{
+    if (!tick_grid_)
+    {
+        key = price;
+        return true;
+    }
+    if (tick_grid_->to_tick(price, key)) return true;
+
+    error_stats_.off_grid_prices++;
+    metrics_.off_grid_prices.inc();
+    return false;
+}
+
 bool OrderBook::add_order(const Order& order)
 {
+    uint32_t price_key;
+    if (!to_book_price(order.price, price_key)) return false;
+
     auto [it, inserted] = orders_.emplace(order.order_id, order);
     if (!inserted) return false;
 
@@ -224,16 +513,26 @@ bool OrderBook::add_order(const Order& order)
     // Convert char side to Side enum
     Side book_side = (order.side == 'B' || order.side == 'b') ? Side::Bid : Side::Ask;
     
+    // Attributed orders note whether they open the level (who sets the price)
+    if (order.mpid)
+    {
+        bool creates_level = !book_.hasLevel(book_side, price_key);
+        attribution_.on_add(order.mpid, book_side, price_key, order.quantity, creates_level);
+    }
+
     // Add to price-level book
-    book_.onAdd(order.order_id, book_side, order.price, order.quantity, info);
+    book_.onAdd(order.order_id, book_side, price_key, order.quantity, info);
     
     // Link Order to OrderInfo
     it->second.book_info = &info;
 
-    if (callback_)
+    if (concurrent_view_)
     {
-        callback_('A', order);
+        concurrent_view_->on_add(order.order_id, book_side == Side::Bid ? 'B' : 'S', order.price,
+                                 order.quantity);
     }
+
+    emit('A', order);
     return true;
 }
 
@@ -243,6 +542,7 @@ bool OrderBook::cancel_order(uint64_t order_id)
     if (it == orders_.end())
     {
         error_stats_.invalid_operations++;
+        metrics_.invalid_operations.inc();
         return false;
     }
 
@@ -250,12 +550,20 @@ bool OrderBook::cancel_order(uint64_t order_id)
     auto info_it = order_info_.find(order_id);
     if (info_it != order_info_.end())
     {
+        const OrderInfo& info = info_it->second;
+        if (it->second.mpid)
+        {
+            attribution_.on_reduce(it->second.mpid, info.side, info.price, info.quantity, true);
+        }
         book_.onCancel(order_id, info_it->second);
+        level_left(info.side, info.price);
         order_info_.erase(info_it);
     }
 
+    if (concurrent_view_) concurrent_view_->on_remove(order_id);
+
     it->second.active = false;
-    if (callback_) callback_('X', it->second);
+    emit('X', it->second);
 
     // Cleanup
     orders_.erase(it);
@@ -268,6 +576,7 @@ bool OrderBook::execute_order(uint64_t order_id, uint32_t quantity)
     if (it == orders_.end() || !it->second.active || it->second.quantity < quantity)
     {
         error_stats_.invalid_operations++;
+        metrics_.invalid_operations.inc();
         return false;
     }
 
@@ -280,11 +589,26 @@ bool OrderBook::execute_order(uint64_t order_id, uint32_t quantity)
     auto info_it = order_info_.find(order_id);
     if (info_it != order_info_.end())
     {
+        if (it->second.mpid)
+        {
+            attribution_.on_reduce(it->second.mpid, info_it->second.side, info_it->second.price,
+                                   quantity, fully_filled);
+        }
         book_.onExecute(order_id, info_it->second, quantity);
-        if (fully_filled) order_info_.erase(info_it);
+        if (fully_filled)
+        {
+            level_left(info_it->second.side, info_it->second.price);
+            order_info_.erase(info_it);
+        }
+    }
+
+    if (concurrent_view_)
+    {
+        if (fully_filled) concurrent_view_->on_remove(order_id);
+        else concurrent_view_->on_reduce(order_id, it->second.quantity);
     }
 
-    if (callback_) callback_('E', it->second);
+    emit('E', it->second);
 
     // Cleanup if fully filled
     if (fully_filled) orders_.erase(it);
@@ -298,29 +622,49 @@ bool OrderBook::replace_order(uint64_t old_order_id, uint64_t new_order_id, uint
     if (it == orders_.end() || !it->second.active)
     {
         error_stats_.invalid_operations++;
+        metrics_.invalid_operations.inc();
         return false;
     }
 
-    // Save original order data
+    // Validate the new price before touching the old order
+    uint32_t price_key;
+    if (!to_book_price(new_price, price_key)) return false;
+
+    // Save original order data (the new order keeps the attribution)
     char side = it->second.side;
     uint64_t timestamp = it->second.timestamp;
+    uint16_t mpid = it->second.mpid;
+
+    // Triggers/BBO see the replace as one update
+    book_.beginUpdate();
 
     // Get OrderInfo for bid/ask processor
     auto info_it = order_info_.find(old_order_id);
     if (info_it != order_info_.end())
     {
+        if (mpid)
+        {
+            attribution_.on_reduce(mpid, info_it->second.side, info_it->second.price,
+                                   info_it->second.quantity, true);
+        }
         book_.onCancel(old_order_id, info_it->second);
+        level_left(info_it->second.side, info_it->second.price);
         order_info_.erase(info_it);
     }
 
     // Remove old order
     orders_.erase(it);
+    if (concurrent_view_) concurrent_view_->on_remove(old_order_id);
 
     // Add new order with new reference number
     Order new_order(new_order_id, new_price, new_quantity, side, timestamp);
+    new_order.mpid = mpid;
     auto [new_it, inserted] = orders_.emplace(new_order_id, new_order);
     if (!inserted)
+    {
+        book_.endUpdate();
         return false;
+    }
 
     // Create OrderInfo for bid/ask processor
     OrderInfo& info = order_info_[new_order_id];
@@ -328,17 +672,27 @@ bool OrderBook::replace_order(uint64_t old_order_id, uint64_t new_order_id, uint
     // Convert char side to Side enum
     Side book_side = (side == 'B' || side == 'b') ? Side::Bid : Side::Ask;
     
+    if (mpid)
+    {
+        bool creates_level = !book_.hasLevel(book_side, price_key);
+        attribution_.on_add(mpid, book_side, price_key, new_quantity, creates_level);
+    }
+
     // Add to price-level book
-    book_.onAdd(new_order_id, book_side, new_price, new_quantity, info);
+    book_.onAdd(new_order_id, book_side, price_key, new_quantity, info);
     
     // Link Order to OrderInfo
     new_it->second.book_info = &info;
 
-    if (callback_)
+    if (concurrent_view_)
     {
-        callback_('U', new_it->second);
+        concurrent_view_->on_add(new_order_id, book_side == Side::Bid ? 'B' : 'S', new_price,
+                                 new_quantity);
     }
 
+    book_.endUpdate();
+    emit('U', new_it->second);
+
     return true;
 }
 
@@ -350,6 +704,24 @@ const Order* OrderBook::find_order(uint64_t order_id) const
     return &it->second;
 }
 
+void OrderBook::reserve(size_t orders, size_t levels)
+{
+    orders_.reserve(orders);
+    order_info_.reserve(orders);
+    book_.reserve(orders, levels);
+}
+
+void OrderBook::enable_concurrent_reads(size_t max_orders)
+{
+    concurrent_view_ = std::make_unique<ConcurrentOrderView>(max_orders);
+    for (const auto& [id, order] : orders_)
+    {
+        if (!order.active) continue;
+        bool bid = (order.side == 'B' || order.side == 'b');
+        concurrent_view_->on_add(id, bid ? 'B' : 'S', order.price, order.quantity);
+    }
+}
+
 size_t OrderBook::get_active_order_count() const
 {
     size_t count = 0;
@@ -363,11 +735,24 @@ size_t OrderBook::get_active_order_count() const
 
 void OrderBook::handle_message(const ITCHParser::ParseResult& result)
 {
+    if (filter_ && !filter_->accept(result))
+    {
+        metrics_.filtered_messages.inc();
+        return;
+    }
+    metrics_.messages.inc();
+
     if (result.type == 'A')
     {
         Order order(result.order_id, result.price, result.quantity, result.side, result.timestamp);
         add_order(order);
     }
+    else if (result.type == 'F')  // 'F' = Add with MPID Attribution
+    {
+        Order order(result.order_id, result.price, result.quantity, result.side, result.timestamp);
+        order.mpid = attribution_.intern(result.mpid);
+        add_order(order);
+    }
     else if (result.type == 'X')  // 'X' = Cancel per ITCH 5.0 spec
     {
         cancel_order(result.order_id);
@@ -404,20 +789,107 @@ void OrderBook::print_orders(std::ostream& os) const
 
 bool OrderBook::get_best_bid(uint64_t& price_out, uint64_t& qty_out) const
 {
-    return book_.getBestBid(price_out, qty_out);
+    if (!book_.getBestBid(price_out, qty_out)) return false;
+    price_out = from_book_price(price_out);
+    return true;
 }
 
 bool OrderBook::get_best_ask(uint64_t& price_out, uint64_t& qty_out) const
 {
-    return book_.getBestAsk(price_out, qty_out);
+    if (!book_.getBestAsk(price_out, qty_out)) return false;
+    price_out = from_book_price(price_out);
+    return true;
+}
+
+uint64_t OrderBook::get_level_quantity(Side side, uint32_t price) const
+{
+    uint32_t key;
+    return trigger_key(price, key) ? book_.getLevelQuantity(side, key) : 0;
+}
+
+// ============================================================================
+// Triggers and BBO Callback
+// ============================================================================
+
+void OrderBook::set_trigger_callback(TriggerCallback cb)
+{
+    if (!cb)
+    {
+        book_.triggers().set_callback(nullptr);
+        return;
+    }
+    book_.triggers().set_callback([this, cb = std::move(cb)](const TriggerIndex::Fired& fired) {
+        TriggerIndex::Fired raw = fired;
+        if (fired.kind != TriggerIndex::Kind::SpreadAbove)
+        {
+            raw.price = static_cast<uint32_t>(from_book_price(fired.price));
+        }
+        cb(raw);
+    });
+}
+
+uint32_t OrderBook::add_best_price_trigger(Side side, uint32_t price, uint64_t tag)
+{
+    uint32_t key;
+    return trigger_key(price, key) ? book_.addBestPriceTrigger(side, key, tag) : 0;
+}
+
+uint32_t OrderBook::add_level_size_trigger(Side side, uint32_t price, uint64_t below_qty, uint64_t tag)
+{
+    uint32_t key;
+    return trigger_key(price, key) ? book_.addLevelSizeTrigger(side, key, below_qty, tag) : 0;
+}
+
+uint32_t OrderBook::add_spread_trigger(int64_t above, uint64_t tag)
+{
+    return book_.addSpreadTrigger(above, tag);
+}
+
+TriggerIndex::Stats OrderBook::get_trigger_stats() const
+{
+    const TriggerIndex* triggers = book_.findTriggers();
+    return triggers ? triggers->get_stats() : TriggerIndex::Stats{};
+}
+
+void OrderBook::set_bbo_callback(BboCallback cb)
+{
+    if (!cb)
+    {
+        book_.setBboCallback(nullptr);
+        return;
+    }
+    book_.setBboCallback([this, cb = std::move(cb)](const TopOfBook& top) {
+        TopOfBook raw = top;
+        if (raw.bid_qty) raw.bid_price = from_book_price(raw.bid_price);
+        if (raw.ask_qty) raw.ask_price = from_book_price(raw.ask_price);
+        cb(raw);
+    });
+}
+
+size_t OrderBook::get_top_mpids(Side side, size_t n, MpidAttribution::MpidShare* out,
+                                uint64_t* touch_price_out) const
+{
+    uint64_t price, qty;
+    bool has_touch = (side == Side::Bid) ? book_.getBestBid(price, qty) : book_.getBestAsk(price, qty);
+    if (!has_touch) return 0;
+
+    if (touch_price_out) *touch_price_out = from_book_price(price);
+    return attribution_.top(side, static_cast<uint32_t>(price), n, out);
+}
+
+uint16_t OrderBook::get_touch_setter(Side side) const
+{
+    uint64_t price, qty;
+    bool has_touch = (side == Side::Bid) ? book_.getBestBid(price, qty) : book_.getBestAsk(price, qty);
+    return has_touch ? attribution_.setter(side, static_cast<uint32_t>(price)) : MpidAttribution::NONE;
 }
 
 bool OrderBook::get_spread(uint64_t& spread_out) const
 {
     uint64_t bid_price, bid_qty, ask_price, ask_qty;
     
-    if (!book_.getBestBid(bid_price, bid_qty)) return false;
-    if (!book_.getBestAsk(ask_price, ask_qty)) return false;
+    if (!get_best_bid(bid_price, bid_qty)) return false;
+    if (!get_best_ask(ask_price, ask_qty)) return false;
     
     if (ask_price <= bid_price) return false;  // Crossed market
     
@@ -430,5 +902,10 @@ OrderBook::MarketDepth OrderBook::get_depth(size_t levels) const
     MarketDepth depth;
     depth.bids = book_.getTopKBids(levels);
     depth.asks = book_.getTopKAsks(levels);
+    if (tick_grid_)
+    {
+        for (auto& level : depth.bids) level.first = from_book_price(level.first);
+        for (auto& level : depth.asks) level.first = from_book_price(level.first);
+    }
     return depth;
 }
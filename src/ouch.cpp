@@ -0,0 +1,199 @@
+#include "ouch.h"
+
+#include <cstring>
+
+// ============================================================================
+// Field helpers
+// ============================================================================
+
+namespace
+{
+
+inline uint8_t* put_u32(uint8_t* p, uint32_t v)
+{
+    p[0] = static_cast<uint8_t>(v >> 24);
+    p[1] = static_cast<uint8_t>(v >> 16);
+    p[2] = static_cast<uint8_t>(v >> 8);
+    p[3] = static_cast<uint8_t>(v);
+    return p + 4;
+}
+
+inline uint32_t get_u32(const uint8_t* p)
+{
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+inline uint8_t* put_bytes(uint8_t* p, const char* src, size_t n)
+{
+    std::memcpy(p, src, n);
+    return p + n;
+}
+
+// Left-justified, space padded; stops at the terminator
+void pad_alpha(char* dst, const char* src, size_t n)
+{
+    bool ended = false;
+    for (size_t i = 0; i < n; ++i)
+    {
+        ended = ended || src[i] == '\0';
+        dst[i] = ended ? ' ' : src[i];
+    }
+}
+
+}  // namespace
+
+OuchSymbol::OuchSymbol(const char* symbol)
+{
+    pad_alpha(bytes, symbol, sizeof(bytes));
+}
+
+// ============================================================================
+// Encoder
+// ============================================================================
+
+OuchEncoder::OuchEncoder(const char* firm, const char* token_prefix)
+{
+    pad_alpha(firm_, firm, sizeof(firm_));
+
+    prefix_len_ = std::strlen(token_prefix);
+    if (prefix_len_ > 6) prefix_len_ = 6;
+    std::memcpy(token_, token_prefix, prefix_len_);
+    std::memset(token_ + prefix_len_, '0', TOKEN_SIZE - prefix_len_);
+    std::memset(last_token_, ' ', TOKEN_SIZE);
+    advance_token();  // First token ends in ...0001
+}
+
+void OuchEncoder::advance_token()
+{
+    // Decimal increment from the right; wraps to all zeros after 10^digits - 1
+    for (size_t i = TOKEN_SIZE; i-- > prefix_len_;)
+    {
+        if (token_[i] != '9')
+        {
+            ++token_[i];
+            return;
+        }
+        token_[i] = '0';
+    }
+}
+
+size_t OuchEncoder::enter_order(uint8_t* out, char side, uint32_t shares, const OuchSymbol& stock,
+                                uint32_t price, uint32_t time_in_force, char display, char capacity)
+{
+    std::memcpy(last_token_, token_, TOKEN_SIZE);
+    advance_token();
+    issued_++;
+
+    uint8_t* p = out;
+    *p++ = 'O';
+    p = put_bytes(p, last_token_, TOKEN_SIZE);  // Order Token
+    *p++ = static_cast<uint8_t>(side);          // Buy/Sell Indicator
+    p = put_u32(p, shares);
+    p = put_bytes(p, stock.bytes, sizeof(stock.bytes));
+    p = put_u32(p, price);
+    p = put_u32(p, time_in_force);
+    p = put_bytes(p, firm_, sizeof(firm_));
+    *p++ = static_cast<uint8_t>(display);
+    *p++ = static_cast<uint8_t>(capacity);
+    *p++ = 'N';          // Intermarket Sweep Eligibility
+    p = put_u32(p, 0);   // Minimum Quantity
+    *p++ = 'N';          // Cross Type: continuous market
+    *p++ = ' ';          // Customer Type: firm default
+    return static_cast<size_t>(p - out);  // ENTER_ORDER_SIZE
+}
+
+size_t OuchEncoder::replace_order(uint8_t* out, const char* existing_token, uint32_t shares, uint32_t price,
+                                  uint32_t time_in_force, char display)
+{
+    std::memcpy(last_token_, token_, TOKEN_SIZE);
+    advance_token();
+    issued_++;
+
+    uint8_t* p = out;
+    *p++ = 'U';
+    p = put_bytes(p, existing_token, TOKEN_SIZE);
+    p = put_bytes(p, last_token_, TOKEN_SIZE);  // Replacement Order Token
+    p = put_u32(p, shares);
+    p = put_u32(p, price);
+    p = put_u32(p, time_in_force);
+    *p++ = static_cast<uint8_t>(display);
+    *p++ = 'N';         // Intermarket Sweep Eligibility
+    p = put_u32(p, 0);  // Minimum Quantity
+    return static_cast<size_t>(p - out);  // REPLACE_ORDER_SIZE
+}
+
+size_t OuchEncoder::cancel_order(uint8_t* out, const char* token, uint32_t shares)
+{
+    uint8_t* p = out;
+    *p++ = 'X';
+    p = put_bytes(p, token, TOKEN_SIZE);
+    p = put_u32(p, shares);
+    return static_cast<size_t>(p - out);  // CANCEL_ORDER_SIZE
+}
+
+// ============================================================================
+// Decoder
+// ============================================================================
+
+size_t OuchDecoder::message_size(char type)
+{
+    switch (type)
+    {
+        case 'O':
+            return OuchEncoder::ENTER_ORDER_SIZE;
+        case 'U':
+            return OuchEncoder::REPLACE_ORDER_SIZE;
+        case 'X':
+            return OuchEncoder::CANCEL_ORDER_SIZE;
+        default:
+            return 0;
+    }
+}
+
+bool OuchDecoder::parse(const uint8_t* data, size_t length, OuchMessage& out)
+{
+    if (length == 0) return false;
+    size_t size = message_size(static_cast<char>(data[0]));
+    if (size == 0 || length < size) return false;
+
+    constexpr size_t T = OuchEncoder::TOKEN_SIZE;
+    out.type = static_cast<char>(data[0]);
+    std::memcpy(out.token, data + 1, T);
+
+    if (out.type == 'O')
+    {
+        out.side = static_cast<char>(data[1 + T]);
+        out.shares = get_u32(data + 2 + T);
+        std::memcpy(out.stock, data + 6 + T, sizeof(out.stock));
+        out.price = get_u32(data + 14 + T);
+        out.time_in_force = get_u32(data + 18 + T);
+        std::memcpy(out.firm, data + 22 + T, sizeof(out.firm));
+    }
+    else if (out.type == 'U')
+    {
+        std::memcpy(out.replacement_token, data + 1 + T, T);
+        out.shares = get_u32(data + 1 + 2 * T);
+        out.price = get_u32(data + 5 + 2 * T);
+        out.time_in_force = get_u32(data + 9 + 2 * T);
+    }
+    else
+    {
+        out.shares = get_u32(data + 1 + T);
+    }
+    return true;
+}
+
+uint64_t OuchDecoder::token_number(const char* token)
+{
+    // Trailing digits only, so any prefix is skipped
+    size_t start = OuchEncoder::TOKEN_SIZE;
+    while (start > 0 && token[start - 1] >= '0' && token[start - 1] <= '9') --start;
+
+    uint64_t value = 0;
+    for (size_t i = start; i < OuchEncoder::TOKEN_SIZE; ++i)
+    {
+        value = value * 10 + static_cast<uint64_t>(token[i] - '0');
+    }
+    return value;
+}
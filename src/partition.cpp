@@ -0,0 +1,806 @@
+#include "partition.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+static uint64_t now_ns()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+// ============================================================================
+// Wire format
+// ============================================================================
+//
+// Frame kinds. Integers are little-endian like the feed; no field holds an
+// address, so frames can cross hosts unchanged.
+//   Data          coordinator -> partition  whole ITCH messages
+//   Release       coordinator -> partition  u16 locate
+//   Handoff       both directions           u16 locate, u8 first, orders
+//   StatsRequest  coordinator -> partition  empty
+//   Shutdown      coordinator -> partition  empty
+//   Released      partition -> coordinator  u16 locate
+//   StatsReply    partition -> coordinator  PartitionStats as u64 fields
+
+namespace
+{
+
+enum FrameKind : uint8_t
+{
+    FRAME_DATA = 1,
+    FRAME_RELEASE = 2,
+    FRAME_HANDOFF = 3,
+    FRAME_STATS_REQUEST = 4,
+    FRAME_SHUTDOWN = 5,
+    FRAME_RELEASED = 6,
+    FRAME_STATS_REPLY = 7,
+    FRAME_WRAP = 0xFF  // Shared-memory ring padding, never delivered
+};
+
+constexpr size_t HANDOFF_HEADER = 3;
+constexpr size_t HANDOFF_RECORD = 25;  // id 8, price 4, qty 4, timestamp 8, side 1
+constexpr size_t STATS_FIELDS = 10;
+
+void put_u16(uint8_t* p, uint16_t v)
+{
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+uint16_t get_u16(const uint8_t* p)
+{
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+void put_le(uint8_t* p, uint64_t v, size_t bytes)
+{
+    for (size_t i = 0; i < bytes; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+uint64_t get_le(const uint8_t* p, size_t bytes)
+{
+    uint64_t v = 0;
+    for (size_t i = 0; i < bytes; ++i) v |= static_cast<uint64_t>(p[i]) << (8 * i);
+    return v;
+}
+
+void encode_stats(const PartitionCoordinator::PartitionStats& s, uint8_t* out)
+{
+    const uint64_t fields[STATS_FIELDS] = {static_cast<uint64_t>(s.pid), s.messages, s.bytes, s.frames,
+                                           s.symbols, s.orders, s.invalid, s.handoffs_out,
+                                           s.handoffs_in, s.digest};
+    for (size_t i = 0; i < STATS_FIELDS; ++i) put_le(out + 8 * i, fields[i], 8);
+}
+
+PartitionCoordinator::PartitionStats decode_stats(const uint8_t* in)
+{
+    PartitionCoordinator::PartitionStats s;
+    s.pid = static_cast<int64_t>(get_le(in, 8));
+    s.messages = get_le(in + 8, 8);
+    s.bytes = get_le(in + 16, 8);
+    s.frames = get_le(in + 24, 8);
+    s.symbols = get_le(in + 32, 8);
+    s.orders = get_le(in + 40, 8);
+    s.invalid = get_le(in + 48, 8);
+    s.handoffs_out = get_le(in + 56, 8);
+    s.handoffs_in = get_le(in + 64, 8);
+    s.digest = get_le(in + 72, 8);
+    return s;
+}
+
+// Retry until the peer makes room (it is always draining)
+void send_blocking(PartitionLink& link, uint8_t kind, const uint8_t* data, size_t length)
+{
+    for (size_t spins = 0; !link.send(kind, data, length); ++spins)
+    {
+        if (spins > 64) std::this_thread::yield();
+    }
+}
+
+}  // namespace
+
+// ============================================================================
+// ShmPartitionLink
+// ============================================================================
+
+// Ring header; the byte area follows it in the mapping
+struct ShmPartitionLink::Ring
+{
+    alignas(64) std::atomic<uint64_t> head;  // Consumer-owned
+    alignas(64) std::atomic<uint64_t> tail;  // Producer-owned
+    alignas(64) uint64_t capacity;
+
+    uint8_t* bytes() { return reinterpret_cast<uint8_t*>(this + 1); }
+};
+
+ShmPartitionLink::ShmPartitionLink(size_t ring_bytes)
+{
+    size_t capacity = 64 * 1024;  // Holds several MAX_FRAME records
+    while (capacity < ring_bytes) capacity <<= 1;
+
+#ifndef _WIN32
+    size_t ring_span = sizeof(Ring) + capacity;
+    mapping_bytes_ = 2 * ring_span;
+    void* base = ::mmap(nullptr, mapping_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) return;
+    mapping_ = base;
+
+    uint8_t* p = static_cast<uint8_t*>(base);
+    down_ = new (p) Ring{};
+    up_ = new (p + ring_span) Ring{};
+    for (Ring* r : {down_, up_})
+    {
+        r->head.store(0, std::memory_order_relaxed);
+        r->tail.store(0, std::memory_order_relaxed);
+        r->capacity = capacity;
+    }
+#endif
+}
+
+ShmPartitionLink::~ShmPartitionLink()
+{
+#ifndef _WIN32
+    if (mapping_) ::munmap(mapping_, mapping_bytes_);
+#endif
+}
+
+ShmPartitionLink::Ring& ShmPartitionLink::outbound()
+{
+    return end_ == End::Coordinator ? *down_ : *up_;
+}
+
+ShmPartitionLink::Ring& ShmPartitionLink::inbound()
+{
+    return end_ == End::Coordinator ? *up_ : *down_;
+}
+
+bool ShmPartitionLink::send(uint8_t kind, const uint8_t* data, size_t length)
+{
+    if (!mapping_ || length > MAX_FRAME) return false;
+
+    Ring& ring = outbound();
+    const uint64_t capacity = ring.capacity;
+    const uint64_t need = (8 + length + 7) & ~uint64_t{7};
+
+    uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+    uint64_t offset = tail & (capacity - 1);
+    uint64_t pad = (offset + need > capacity) ? capacity - offset : 0;
+
+    if (tail + pad + need - head_cache_ > capacity)
+    {
+        head_cache_ = ring.head.load(std::memory_order_acquire);
+        if (tail + pad + need - head_cache_ > capacity) return false;
+    }
+
+    uint8_t* bytes = ring.bytes();
+    if (pad)
+    {
+        bytes[offset + 4] = FRAME_WRAP;
+        tail += pad;
+        offset = 0;
+    }
+    put_le(bytes + offset, length, 4);
+    bytes[offset + 4] = kind;
+    std::memcpy(bytes + offset + 8, data, length);
+    ring.tail.store(tail + need, std::memory_order_release);
+    return true;
+}
+
+bool ShmPartitionLink::receive(uint8_t& kind, uint8_t* out, size_t& length)
+{
+    if (!mapping_) return false;
+
+    Ring& ring = inbound();
+    const uint64_t capacity = ring.capacity;
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+
+    while (true)
+    {
+        if (tail_cache_ <= head)
+        {
+            tail_cache_ = ring.tail.load(std::memory_order_acquire);
+            if (tail_cache_ == head) return false;
+        }
+
+        uint64_t offset = head & (capacity - 1);
+        const uint8_t* record = ring.bytes() + offset;
+        if (record[4] == FRAME_WRAP)
+        {
+            head += capacity - offset;
+            ring.head.store(head, std::memory_order_release);
+            continue;
+        }
+
+        length = static_cast<size_t>(get_le(record, 4));
+        kind = record[4];
+        std::memcpy(out, record + 8, length);
+        ring.head.store(head + ((8 + length + 7) & ~uint64_t{7}), std::memory_order_release);
+        return true;
+    }
+}
+
+// ============================================================================
+// SocketPartitionLink
+// ============================================================================
+
+#ifndef _WIN32
+SocketPartitionLink::SocketPartitionLink()
+{
+    if (::socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fd_) != 0)
+    {
+        fd_[0] = fd_[1] = -1;
+    }
+}
+
+SocketPartitionLink::~SocketPartitionLink()
+{
+    for (int fd : fd_)
+    {
+        if (fd >= 0) ::close(fd);
+    }
+}
+
+void SocketPartitionLink::bind(End end)
+{
+    int keep = (end == End::Coordinator) ? 0 : 1;
+    if (fd_[1 - keep] >= 0) ::close(fd_[1 - keep]);
+    fd_[1 - keep] = -1;
+    own_ = fd_[keep];
+}
+
+bool SocketPartitionLink::send(uint8_t kind, const uint8_t* data, size_t length)
+{
+    if (own_ < 0 || length > MAX_FRAME) return false;
+
+    // One datagram per frame: kind byte, then the payload
+    iovec parts[2];
+    parts[0].iov_base = &kind;
+    parts[0].iov_len = 1;
+    parts[1].iov_base = const_cast<uint8_t*>(data);
+    parts[1].iov_len = length;
+    msghdr msg{};
+    msg.msg_iov = parts;
+    msg.msg_iovlen = 2;
+    return ::sendmsg(own_, &msg, MSG_DONTWAIT | MSG_NOSIGNAL) == static_cast<ssize_t>(length + 1);
+}
+
+bool SocketPartitionLink::receive(uint8_t& kind, uint8_t* out, size_t& length)
+{
+    if (own_ < 0) return false;
+
+    iovec parts[2];
+    parts[0].iov_base = &kind;
+    parts[0].iov_len = 1;
+    parts[1].iov_base = out;
+    parts[1].iov_len = MAX_FRAME;
+    msghdr msg{};
+    msg.msg_iov = parts;
+    msg.msg_iovlen = 2;
+    ssize_t n = ::recvmsg(own_, &msg, MSG_DONTWAIT);
+    if (n <= 0) return false;
+    length = static_cast<size_t>(n - 1);
+    return true;
+}
+#else
+SocketPartitionLink::SocketPartitionLink() = default;
+SocketPartitionLink::~SocketPartitionLink() = default;
+void SocketPartitionLink::bind(End) {}
+bool SocketPartitionLink::send(uint8_t, const uint8_t*, size_t) { return false; }
+bool SocketPartitionLink::receive(uint8_t&, uint8_t*, size_t&) { return false; }
+#endif
+
+// ============================================================================
+// Partition process
+// ============================================================================
+
+namespace
+{
+
+// A symbol's book; the fabric is unused (messages arrive pre-decoded)
+struct SymbolBook
+{
+    DataFabric fabric{0};
+    OrderBook book{fabric};
+};
+
+class PartitionWorker
+{
+   public:
+    explicit PartitionWorker(PartitionLink& link) : link_(link), books_(PartitionCoordinator::MAX_LOCATES)
+    {
+        frame_.resize(PartitionLink::MAX_FRAME);
+#ifndef _WIN32
+        stats_.pid = ::getpid();
+#endif
+    }
+
+    // Until Shutdown
+    void run()
+    {
+        size_t idle = 0;
+        while (true)
+        {
+            uint8_t kind = 0;
+            size_t length = 0;
+            if (!link_.receive(kind, frame_.data(), length))
+            {
+                if (++idle > 64) std::this_thread::yield();
+                continue;
+            }
+            idle = 0;
+            stats_.frames++;
+
+            switch (kind)
+            {
+                case FRAME_DATA:
+                    apply(frame_.data(), length);
+                    break;
+                case FRAME_RELEASE:
+                    release(get_u16(frame_.data()));
+                    break;
+                case FRAME_HANDOFF:
+                    adopt(frame_.data(), length);
+                    break;
+                case FRAME_STATS_REQUEST:
+                    reply_stats();
+                    break;
+                case FRAME_SHUTDOWN:
+                    return;
+                default:
+                    stats_.invalid++;
+                    break;
+            }
+        }
+    }
+
+   private:
+    OrderBook& book(uint16_t locate)
+    {
+        auto& slot = books_[locate];
+        if (!slot) slot = std::make_unique<SymbolBook>();
+        return slot->book;
+    }
+
+    void apply(const uint8_t* data, size_t length)
+    {
+        stats_.bytes += length;
+        size_t offset = 0;
+        while (offset < length)
+        {
+            auto msg = parser_.parse_one(data + offset, length - offset);
+            if (!msg)
+            {
+                stats_.invalid += length - offset;
+                return;
+            }
+            book(msg->locate).handle_message(*msg);
+            stats_.messages++;
+            offset += msg->bytes_consumed;
+        }
+    }
+
+    // Live orders out level by level in queue order, then drop the book
+    void release(uint16_t locate)
+    {
+        std::vector<Order> orders;
+        if (books_[locate])
+        {
+            books_[locate]->book.for_each_queued([&](const Order& o) { orders.push_back(o); });
+            books_[locate].reset();
+        }
+
+        uint8_t out[PartitionLink::MAX_FRAME];
+        constexpr size_t PER_FRAME = (PartitionLink::MAX_FRAME - HANDOFF_HEADER) / HANDOFF_RECORD;
+        size_t sent = 0;
+        do  // At least one frame, so an empty book still moves
+        {
+            size_t count = std::min(PER_FRAME, orders.size() - sent);
+            put_u16(out, locate);
+            out[2] = (sent == 0) ? 1 : 0;
+            uint8_t* p = out + HANDOFF_HEADER;
+            for (size_t i = 0; i < count; ++i, p += HANDOFF_RECORD)
+            {
+                const Order& o = orders[sent + i];
+                put_le(p, o.order_id, 8);
+                put_le(p + 8, o.price, 4);
+                put_le(p + 12, o.quantity, 4);
+                put_le(p + 16, o.timestamp, 8);
+                p[24] = static_cast<uint8_t>(o.side);
+            }
+            send_blocking(link_, FRAME_HANDOFF, out, static_cast<size_t>(p - out));
+            sent += count;
+        } while (sent < orders.size());
+
+        uint8_t released[2];
+        put_u16(released, locate);
+        send_blocking(link_, FRAME_RELEASED, released, sizeof(released));
+        stats_.handoffs_out++;
+    }
+
+    void adopt(const uint8_t* data, size_t length)
+    {
+        if (length < HANDOFF_HEADER || (length - HANDOFF_HEADER) % HANDOFF_RECORD != 0)
+        {
+            stats_.invalid++;
+            return;
+        }
+        uint16_t locate = get_u16(data);
+        if (data[2]) stats_.handoffs_in++;
+        OrderBook& target = book(locate);
+        for (const uint8_t* p = data + HANDOFF_HEADER; p < data + length; p += HANDOFF_RECORD)
+        {
+            Order order(get_le(p, 8), static_cast<uint32_t>(get_le(p + 8, 4)),
+                        static_cast<uint32_t>(get_le(p + 12, 4)), static_cast<char>(p[24]), get_le(p + 16, 8));
+            if (!target.add_order(order)) stats_.invalid++;
+        }
+    }
+
+    void reply_stats()
+    {
+        stats_.symbols = 0;
+        stats_.orders = 0;
+        stats_.digest = 0;
+        for (size_t locate = 0; locate < books_.size(); ++locate)
+        {
+            if (!books_[locate]) continue;
+            const OrderBook& b = books_[locate]->book;
+            stats_.symbols++;
+            stats_.orders += b.get_active_order_count();
+            stats_.digest += PartitionCoordinator::book_digest(static_cast<uint16_t>(locate), b);
+        }
+        uint8_t out[8 * STATS_FIELDS];
+        encode_stats(stats_, out);
+        send_blocking(link_, FRAME_STATS_REPLY, out, sizeof(out));
+    }
+
+    PartitionLink& link_;
+    std::vector<std::unique_ptr<SymbolBook>> books_;  // Indexed by locate
+    ITCHParser parser_;
+    std::vector<uint8_t> frame_;
+    PartitionCoordinator::PartitionStats stats_;
+};
+
+}  // namespace
+
+// ============================================================================
+// PartitionCoordinator
+// ============================================================================
+
+PartitionCoordinator::PartitionCoordinator() : PartitionCoordinator(Config{}) {}
+
+PartitionCoordinator::PartitionCoordinator(const Config& config)
+    : config_(config), route_(MAX_LOCATES, 0), transit_(MAX_LOCATES, NO_TRANSIT)
+{
+    if (config_.partitions == 0) config_.partitions = 1;
+    frame_.resize(PartitionLink::MAX_FRAME);
+}
+
+PartitionCoordinator::~PartitionCoordinator()
+{
+    stop();
+}
+
+bool PartitionCoordinator::start()
+{
+#ifndef _WIN32
+    if (running_) return true;
+
+    links_.clear();
+    for (size_t p = 0; p < config_.partitions; ++p)
+    {
+        if (config_.transport == Transport::SharedMemory)
+            links_.push_back(std::make_unique<ShmPartitionLink>(config_.ring_bytes));
+        else
+            links_.push_back(std::make_unique<SocketPartitionLink>());
+        if (!links_.back()->valid())
+        {
+            std::cerr << "[ERROR] Partition link " << p << " could not be created\n";
+            links_.clear();
+            return false;
+        }
+    }
+
+    std::cout.flush();
+    std::cerr.flush();
+    pids_.assign(links_.size(), 0);
+    for (size_t p = 0; p < links_.size(); ++p)
+    {
+        pid_t pid = ::fork();
+        if (pid < 0)
+        {
+            std::cerr << "[ERROR] fork failed for partition " << p << "\n";
+            running_ = true;  // Reap whatever started
+            pids_.resize(p);
+            links_.resize(p);
+            stop();
+            return false;
+        }
+        if (pid == 0)
+        {
+            links_[p]->bind(PartitionLink::End::Partition);
+            PartitionWorker(*links_[p]).run();
+            ::_exit(0);  // Skip the parent's destructors and atexit handlers
+        }
+        links_[p]->bind(PartitionLink::End::Coordinator);
+        pids_[p] = pid;
+    }
+
+    pending_.assign(links_.size(), {});
+    for (auto& frame : pending_) frame.reserve(PartitionLink::MAX_FRAME);
+    for (size_t locate = 0; locate < MAX_LOCATES; ++locate)
+    {
+        route_[locate] = static_cast<uint16_t>(locate % links_.size());
+    }
+    running_ = true;
+    return true;
+#else
+    std::cerr << "[ERROR] PartitionCoordinator requires POSIX fork()\n";
+    return false;
+#endif
+}
+
+void PartitionCoordinator::stop()
+{
+#ifndef _WIN32
+    if (!running_) return;
+    while (!transits_.empty()) poll();
+    flush();
+    for (size_t p = 0; p < links_.size(); ++p) send_frame(p, FRAME_SHUTDOWN, nullptr, 0);
+    for (int64_t pid : pids_) ::waitpid(static_cast<pid_t>(pid), nullptr, 0);
+    pids_.clear();
+    running_ = false;
+#endif
+}
+
+void PartitionCoordinator::route(const uint8_t* data, size_t length)
+{
+    size_t offset = 0;
+    while (offset < length)
+    {
+        size_t size = ITCHParser::message_length(static_cast<char>(data[offset]));
+        if (size == 0 || offset + size > length)
+        {
+            stats_.unroutable++;  // No way to find the next boundary
+            return;
+        }
+
+        uint16_t locate = get_u16(data + offset + 1);
+        if (transit_[locate] != NO_TRANSIT)
+        {
+            for (Transit& t : transits_)
+            {
+                if (t.locate != locate) continue;
+                t.stash.insert(t.stash.end(), data + offset, data + offset + size);
+                break;
+            }
+            stats_.stashed++;
+        }
+        else
+        {
+            append(route_[locate], data + offset, size);
+        }
+        stats_.routed++;
+        offset += size;
+    }
+}
+
+void PartitionCoordinator::append(size_t partition, const uint8_t* msg, size_t length)
+{
+    auto& frame = pending_[partition];
+    if (frame.size() + length > PartitionLink::MAX_FRAME) flush_partition(partition);
+    frame.insert(frame.end(), msg, msg + length);
+}
+
+void PartitionCoordinator::flush_partition(size_t partition)
+{
+    auto& frame = pending_[partition];
+    if (frame.empty()) return;
+    send_frame(partition, FRAME_DATA, frame.data(), frame.size());
+    frame.clear();
+}
+
+void PartitionCoordinator::flush()
+{
+    for (size_t p = 0; p < pending_.size(); ++p) flush_partition(p);
+}
+
+void PartitionCoordinator::send_frame(size_t partition, uint8_t kind, const uint8_t* data, size_t length)
+{
+    // A full channel means the partition is behind; take in its replies
+    // while waiting so neither side blocks on the other. They are handled
+    // later by poll(), never from inside a send.
+    for (size_t spins = 0; !links_[partition]->send(kind, data, length); ++spins)
+    {
+        stats_.send_retries++;
+        drain();
+        if (spins > 64) std::this_thread::yield();
+    }
+}
+
+bool PartitionCoordinator::reassign(uint16_t locate, size_t partition)
+{
+    if (!running_ || partition >= links_.size() || route_[locate] == partition || transit_[locate] != NO_TRANSIT)
+    {
+        return false;
+    }
+
+    size_t old = route_[locate];
+    transit_[locate] = static_cast<uint16_t>(partition);
+    transits_.push_back(Transit{locate, now_ns(), {}});
+
+    // Behind everything already routed to the old owner
+    flush_partition(old);
+    uint8_t payload[2];
+    put_u16(payload, locate);
+    send_frame(old, FRAME_RELEASE, payload, sizeof(payload));
+    return true;
+}
+
+void PartitionCoordinator::drain()
+{
+    for (size_t p = 0; p < links_.size(); ++p)
+    {
+        uint8_t kind = 0;
+        size_t length = 0;
+        while (links_[p]->receive(kind, frame_.data(), length))
+        {
+            inbox_.push_back(Reply{p, kind, std::vector<uint8_t>(frame_.begin(), frame_.begin() + length)});
+        }
+    }
+}
+
+void PartitionCoordinator::poll()
+{
+    drain();
+    if (handling_) return;
+
+    // Handling can send, and sending can drain more replies onto the queue
+    handling_ = true;
+    while (!inbox_.empty())
+    {
+        Reply reply = std::move(inbox_.front());
+        inbox_.pop_front();
+        handle_reply(reply.partition, reply.kind, reply.data.data(), reply.data.size());
+    }
+    handling_ = false;
+}
+
+void PartitionCoordinator::handle_reply(size_t partition, uint8_t kind, const uint8_t* data, size_t length)
+{
+    switch (kind)
+    {
+        case FRAME_HANDOFF:
+        {
+            uint16_t locate = get_u16(data);
+            if (transit_[locate] != NO_TRANSIT) send_frame(transit_[locate], FRAME_HANDOFF, data, length);
+            break;
+        }
+        case FRAME_RELEASED:
+        {
+            uint16_t locate = get_u16(data);
+            auto it = std::find_if(transits_.begin(), transits_.end(),
+                                   [locate](const Transit& t) { return t.locate == locate; });
+            if (it == transits_.end()) break;
+
+            Transit done = std::move(*it);
+            transits_.erase(it);
+            size_t target = transit_[locate];
+            route_[locate] = static_cast<uint16_t>(target);
+            transit_[locate] = NO_TRANSIT;
+
+            // The stash follows the handoff frames already sent to the target
+            for (size_t offset = 0; offset < done.stash.size();)
+            {
+                size_t size = ITCHParser::message_length(static_cast<char>(done.stash[offset]));
+                append(target, done.stash.data() + offset, size);
+                offset += size;
+            }
+
+            uint64_t pause = now_ns() - done.start_ns;
+            stats_.reassignments++;
+            stats_.total_pause_ns += pause;
+            stats_.max_pause_ns = std::max(stats_.max_pause_ns, pause);
+            break;
+        }
+        case FRAME_STATS_REPLY:
+            if (length == 8 * STATS_FIELDS && partition < replies_.size())
+            {
+                replies_[partition] = decode_stats(data);
+                replies_pending_--;
+            }
+            break;
+        default:
+            std::cerr << "[ERROR] Unexpected frame kind " << static_cast<int>(kind) << " from partition "
+                      << partition << "\n";
+            break;
+    }
+}
+
+PartitionCoordinator::Stats PartitionCoordinator::collect_stats()
+{
+    Stats result;
+    if (!running_) return result;
+
+    // Settle moves first so every book is counted exactly once
+    for (size_t spins = 0; !transits_.empty(); ++spins)
+    {
+        poll();
+        if (spins > 64) std::this_thread::yield();
+    }
+    flush();
+
+    replies_.assign(links_.size(), PartitionStats{});
+    replies_pending_ = links_.size();
+    for (size_t p = 0; p < links_.size(); ++p) send_frame(p, FRAME_STATS_REQUEST, nullptr, 0);
+    for (size_t spins = 0; replies_pending_ > 0; ++spins)
+    {
+        poll();
+        if (spins > 64) std::this_thread::yield();
+    }
+
+    result = stats_;
+    result.partitions = replies_;
+    for (const PartitionStats& s : replies_)
+    {
+        result.total.messages += s.messages;
+        result.total.bytes += s.bytes;
+        result.total.frames += s.frames;
+        result.total.symbols += s.symbols;
+        result.total.orders += s.orders;
+        result.total.invalid += s.invalid;
+        result.total.handoffs_out += s.handoffs_out;
+        result.total.handoffs_in += s.handoffs_in;
+        result.total.digest += s.digest;
+    }
+    return result;
+}
+
+uint64_t PartitionCoordinator::book_digest(uint16_t locate, const OrderBook& book)
+{
+    // splitmix64 finalizer
+    auto mix = [](uint64_t h, uint64_t v) {
+        h += v + 0x9E3779B97F4A7C15ULL;
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+        return h ^ (h >> 31);
+    };
+
+    uint64_t bid = 0, bid_qty = 0, ask = 0, ask_qty = 0;
+    book.get_best_bid(bid, bid_qty);
+    book.get_best_ask(ask, ask_qty);
+    uint64_t h = locate;
+    for (uint64_t v : {bid, bid_qty, ask, ask_qty, static_cast<uint64_t>(book.get_active_order_count())})
+    {
+        h = mix(h, v);
+    }
+
+    // Each order's place in its level's queue; summed, so the order levels
+    // are visited in does not matter
+    uint64_t queues = 0;
+    char side = 0;
+    uint32_t price = 0;
+    uint64_t position = 0;
+    book.for_each_queued([&](const Order& o) {
+        if (o.side != side || o.price != price) position = 0;
+        side = o.side;
+        price = o.price;
+        uint64_t level = (static_cast<uint64_t>(static_cast<uint8_t>(side)) << 32) | price;
+        queues += mix(mix(mix(level, position++), o.order_id), o.quantity);
+    });
+    return mix(h, queues);
+}
@@ -0,0 +1,96 @@
+#include "portfolio.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
+namespace
+{
+
+// Sum of q x m, |q| x m and c over n positions
+Portfolio::Totals sum_positions(const double* q, const double* m, const double* c, size_t n)
+{
+    Portfolio::Totals t;
+    size_t i = 0;
+#ifdef __AVX__
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    __m256d net = _mm256_setzero_pd();
+    __m256d gross = _mm256_setzero_pd();
+    __m256d cost = _mm256_setzero_pd();
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256d qv = _mm256_loadu_pd(q + i);
+        __m256d mv = _mm256_loadu_pd(m + i);
+        net = _mm256_add_pd(net, _mm256_mul_pd(qv, mv));
+        gross = _mm256_add_pd(gross, _mm256_mul_pd(_mm256_andnot_pd(sign, qv), mv));
+        cost = _mm256_add_pd(cost, _mm256_loadu_pd(c + i));
+    }
+    alignas(32) double lanes[3][4];
+    _mm256_store_pd(lanes[0], net);
+    _mm256_store_pd(lanes[1], gross);
+    _mm256_store_pd(lanes[2], cost);
+    t.net_value = (lanes[0][0] + lanes[0][1]) + (lanes[0][2] + lanes[0][3]);
+    t.gross_value = (lanes[1][0] + lanes[1][1]) + (lanes[1][2] + lanes[1][3]);
+    t.cost = (lanes[2][0] + lanes[2][1]) + (lanes[2][2] + lanes[2][3]);
+#endif
+    for (; i < n; ++i)
+    {
+        t.net_value += q[i] * m[i];
+        t.gross_value += std::fabs(q[i]) * m[i];
+        t.cost += c[i];
+    }
+    return t;
+}
+
+}  // namespace
+
+Portfolio::Portfolio(size_t symbols)
+    : symbols_(std::min<size_t>(symbols, 65536)),
+      qty_(symbols_, 0.0),
+      mark_(symbols_, 0.0),
+      cost_(symbols_, 0.0)
+{
+}
+
+void Portfolio::adjust(size_t s, double new_qty, double cost_change)
+{
+    double m = mark_[s];
+    totals_.net_value += (new_qty - qty_[s]) * m;
+    totals_.gross_value += (std::fabs(new_qty) - std::fabs(qty_[s])) * m;
+    totals_.cost += cost_change;
+    qty_[s] = new_qty;
+    cost_[s] += cost_change;
+}
+
+void Portfolio::on_fill(uint16_t symbol, char side, uint32_t qty, uint32_t price)
+{
+    if (symbol >= symbols_) return;
+    const size_t s = symbol;
+    if (mark_[s] == 0) mark_[s] = price;  // Unmarked: nothing held yet, totals unaffected
+    double q = side == 'B' ? static_cast<double>(qty) : -static_cast<double>(qty);
+    adjust(s, qty_[s] + q, q * price);
+    stats_.fills++;
+}
+
+void Portfolio::set_position(uint16_t symbol, int64_t qty, double avg_price)
+{
+    if (symbol >= symbols_) return;
+    const size_t s = symbol;
+    if (mark_[s] == 0) mark_[s] = avg_price;
+    double q = static_cast<double>(qty);
+    adjust(s, q, q * avg_price - cost_[s]);
+}
+
+double Portfolio::recompute()
+{
+    Totals fresh = sum_positions(qty_.data(), mark_.data(), cost_.data(), symbols_);
+    double drift = std::fabs(totals_.pnl() - fresh.pnl());
+    totals_ = fresh;
+    stats_.recomputes++;
+    stats_.last_drift = drift;
+    stats_.max_drift = std::max(stats_.max_drift, drift);
+    return drift;
+}
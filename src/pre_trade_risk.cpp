@@ -0,0 +1,99 @@
+#include "pre_trade_risk.h"
+
+#include <algorithm>
+
+PreTradeRisk::PreTradeRisk(size_t symbols)
+    : symbols_(std::min<size_t>(symbols, 65536)),
+      band_bps_(symbols_),
+      band_lo_(symbols_, 1),  // lo > hi: no reference until the first BBO
+      band_hi_(symbols_, 0),
+      max_qty_(symbols_),
+      max_notional_(symbols_),
+      max_position_(symbols_),
+      position_(symbols_, 0),
+      open_buy_(symbols_, 0),
+      open_sell_(symbols_, 0),
+      rate_tat_(symbols_, 0),
+      rate_interval_(symbols_),
+      rate_tolerance_(symbols_),
+      halted_(symbols_, 0)
+{
+    for (size_t s = 0; s < symbols_; ++s) set_limits(static_cast<uint16_t>(s), RiskLimits{});
+}
+
+void PreTradeRisk::set_limits(uint16_t symbol, const RiskLimits& limits)
+{
+    if (symbol >= symbols_) return;
+    band_bps_[symbol] = limits.band_bps;
+    max_qty_[symbol] = limits.max_order_qty;
+    max_notional_[symbol] = limits.max_notional;
+    max_position_[symbol] = limits.max_position;
+
+    uint64_t rate = std::max<uint32_t>(limits.orders_per_second, 1);
+    rate_interval_[symbol] = 1000000000ull / rate;
+    rate_tolerance_[symbol] = rate_interval_[symbol] * (std::max<uint32_t>(limits.burst, 1) - 1);
+}
+
+void PreTradeRisk::set_halted(uint16_t symbol, bool halted)
+{
+    if (symbol < symbols_) halted_[symbol] = halted ? 1 : 0;
+}
+
+void PreTradeRisk::halt_all(bool halted)
+{
+    std::fill(halted_.begin(), halted_.end(), halted ? 1 : 0);
+}
+
+void PreTradeRisk::on_bbo(uint16_t symbol, const TopOfBook& top)
+{
+    if (symbol >= symbols_) return;
+
+    // A one-sided book references the side it has
+    uint64_t bid = top.bid_qty ? top.bid_price : top.ask_price;
+    uint64_t ask = top.ask_qty ? top.ask_price : top.bid_price;
+    if (!top.bid_qty && !top.ask_qty)
+    {
+        band_lo_[symbol] = 1;
+        band_hi_[symbol] = 0;
+        return;
+    }
+
+    uint64_t bps = band_bps_[symbol];
+    uint64_t below = bid * bps / 10000;
+    uint64_t above = ask * bps / 10000;
+    band_lo_[symbol] = static_cast<uint32_t>(bid > below ? bid - below : 0);
+    band_hi_[symbol] = static_cast<uint32_t>(std::min<uint64_t>(ask + above, UINT32_MAX));
+}
+
+void PreTradeRisk::on_fill(uint16_t symbol, char side, uint32_t qty)
+{
+    if (symbol >= symbols_) return;
+    if (side == 'B')
+    {
+        open_buy_[symbol] -= qty;
+        position_[symbol] += qty;
+    }
+    else
+    {
+        open_sell_[symbol] -= qty;
+        position_[symbol] -= qty;
+    }
+}
+
+void PreTradeRisk::on_done(uint16_t symbol, char side, uint32_t leaves_qty)
+{
+    if (symbol >= symbols_) return;
+    (side == 'B' ? open_buy_[symbol] : open_sell_[symbol]) -= leaves_qty;
+}
+
+uint32_t PreTradeRisk::reject_unknown()
+{
+    stats_.checks++;
+    count(RISK_UNKNOWN_SYMBOL);
+    return RISK_UNKNOWN_SYMBOL;
+}
+
+void PreTradeRisk::count(uint32_t flags)
+{
+    for (size_t i = 0; i < REJECT_REASONS; ++i) stats_.rejects[i] += (flags >> i) & 1;
+}
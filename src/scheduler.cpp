@@ -0,0 +1,137 @@
+#include "scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+
+// ============================================================================
+// CooperativeScheduler Implementation
+// ============================================================================
+
+static uint64_t now_ns()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+size_t CooperativeScheduler::add_feed(const std::string& name, DataFabric& fabric, OrderBook& book)
+{
+    Task task;
+    task.name = name;
+    task.fabric = &fabric;
+    task.book = &book;
+    task.last_visit_ns = now_ns();
+    tasks_.push_back(std::move(task));
+    return tasks_.size() - 1;
+}
+
+size_t CooperativeScheduler::add_task(const std::string& name, TaskFn fn)
+{
+    Task task;
+    task.name = name;
+    task.fn = std::move(fn);
+    task.last_visit_ns = now_ns();
+    tasks_.push_back(std::move(task));
+    return tasks_.size() - 1;
+}
+
+size_t CooperativeScheduler::run_once()
+{
+    size_t total_work = 0;
+    uint64_t pass_start = now_ns();  // One clock read stamps every idle visit
+    ++passes_;
+
+    for (auto& task : tasks_)
+    {
+        if (task.done) continue;
+
+        // Fast path: empty fabric, nothing to do
+        if (task.fabric && task.fabric->empty())
+        {
+            task.stats.idle_polls++;
+            task.last_visit_ns = pass_start;
+            continue;
+        }
+
+        uint64_t start = now_ns();
+        size_t work = 0;
+        TaskStatus status;
+        if (task.fabric)
+        {
+            work = task.book->process_some(config_.chunk_budget);
+            status = task.fabric->empty() ? TaskStatus::Idle : TaskStatus::Yield;
+        }
+        else
+        {
+            status = task.fn(config_.chunk_budget, work);
+        }
+        uint64_t end = now_ns();
+
+        if (work == 0)
+        {
+            task.stats.idle_polls++;
+        }
+        else
+        {
+            uint64_t wait = start > task.last_visit_ns ? start - task.last_visit_ns : 0;
+            uint64_t run = end - start;
+            task.stats.slices++;
+            task.stats.work_units += work;
+            task.stats.run_ns += run;
+            task.stats.max_run_ns = std::max(task.stats.max_run_ns, run);
+            task.stats.total_wait_ns += wait;
+            task.stats.max_wait_ns = std::max(task.stats.max_wait_ns, wait);
+            if (status == TaskStatus::Yield) task.stats.budget_yields++;
+        }
+
+        task.last_visit_ns = end;
+        task.done = (status == TaskStatus::Done);
+        total_work += work;
+    }
+
+    if (total_work == 0)
+    {
+        idle_passes_++;
+        if (idle_callback_) idle_callback_();
+    }
+    return total_work;
+}
+
+size_t CooperativeScheduler::run_until_idle()
+{
+    size_t total_work = 0;
+    while (size_t work = run_once())
+    {
+        total_work += work;
+    }
+    return total_work;
+}
+
+void CooperativeScheduler::reset_stats()
+{
+    uint64_t now = now_ns();
+    for (auto& task : tasks_)
+    {
+        task.stats = TaskStats{};
+        task.last_visit_ns = now;
+    }
+    passes_ = 0;
+    idle_passes_ = 0;
+}
+
+double CooperativeScheduler::fairness_index() const
+{
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    size_t n = 0;
+    for (const auto& task : tasks_)
+    {
+        if (task.stats.budget_yields == 0) continue;
+        double x = static_cast<double>(task.stats.work_units);
+        sum += x;
+        sum_sq += x * x;
+        ++n;
+    }
+    if (n == 0 || sum_sq == 0.0) return 1.0;
+    return (sum * sum) / (static_cast<double>(n) * sum_sq);
+}
@@ -0,0 +1,415 @@
+#include "sharded_engine.h"
+
+#include <algorithm>
+#include <chrono>
+
+// ============================================================================
+// Internal Structures
+// ============================================================================
+
+static uint64_t now_ns()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+// A symbol's book; the fabric is unused (messages arrive pre-decoded)
+struct ShardedEngine::SymbolBook
+{
+    DataFabric fabric{0};
+    OrderBook book{fabric};
+};
+
+// Handoff slot for one symbol moving between workers
+struct ShardedEngine::Migration
+{
+    uint16_t locate = 0;
+    uint64_t start_ns = 0;
+    std::atomic<SymbolBook*> book{nullptr};  // Published by the old owner
+    std::atomic<bool> complete{false};       // Set by the new owner once caught up
+};
+
+struct ShardedEngine::WorkItem
+{
+    enum class Kind : uint8_t { Message, Release, Adopt };
+
+    Kind kind = Kind::Message;
+    Migration* migration = nullptr;
+    ITCHParser::ParseResult msg{};
+};
+
+struct ShardedEngine::Worker
+{
+    // Symbol adopted but whose book has not arrived yet
+    struct Pending
+    {
+        Migration* migration;
+        Migration* forward = nullptr;  // Released again before the book arrived
+        std::vector<ITCHParser::ParseResult> stash;
+    };
+
+    explicit Worker(size_t queue_capacity)
+        : queue(queue_capacity), books(MAX_LOCATES), in_transit(MAX_LOCATES, 0)
+    {
+    }
+
+    SpscRing<WorkItem> queue;
+    std::thread thread;
+
+    // Worker-owned state
+    std::vector<std::unique_ptr<SymbolBook>> books;  // Indexed by locate
+    std::vector<uint8_t> in_transit;
+    std::vector<Pending> pending;
+    uint64_t messages = 0;
+    MigrationStats migration_stats;
+
+    // Router publishes pushed, worker publishes applied; flush() compares
+    uint64_t pushed = 0;
+    alignas(64) std::atomic<uint64_t> applied{0};
+    std::atomic<size_t> pending_count{0};
+};
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+ShardedEngine::ShardedEngine() : ShardedEngine(Config{}) {}
+
+ShardedEngine::ShardedEngine(const Config& config)
+    : config_(config), route_(MAX_LOCATES), window_counts_(MAX_LOCATES, 0)
+{
+    if (config_.workers == 0) config_.workers = 1;
+    for (size_t i = 0; i < config_.workers; ++i)
+    {
+        workers_.push_back(std::make_unique<Worker>(config_.queue_capacity));
+    }
+    for (size_t locate = 0; locate < MAX_LOCATES; ++locate)
+    {
+        route_[locate] = static_cast<uint16_t>(locate % config_.workers);
+    }
+}
+
+ShardedEngine::~ShardedEngine()
+{
+    stop();
+}
+
+void ShardedEngine::start()
+{
+    if (running_) return;
+    stop_.store(false, std::memory_order_relaxed);
+    for (auto& worker : workers_)
+    {
+        Worker* w = worker.get();
+        w->thread = std::thread([this, w] { worker_loop(*w); });
+    }
+    running_ = true;
+}
+
+void ShardedEngine::stop()
+{
+    if (!running_) return;
+    flush();
+    stop_.store(true, std::memory_order_release);
+    for (auto& worker : workers_)
+    {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+    running_ = false;
+}
+
+// ============================================================================
+// Router Side
+// ============================================================================
+
+void ShardedEngine::push(size_t worker, const WorkItem& item)
+{
+    Worker& w = *workers_[worker];
+    while (!w.queue.try_push(item))
+    {
+        std::this_thread::yield();  // Backpressure from a saturated worker
+    }
+    ++w.pushed;
+}
+
+void ShardedEngine::route(const ITCHParser::ParseResult& msg)
+{
+    if (window_counts_[msg.locate]++ == 0) active_locates_.push_back(msg.locate);
+    ++window_total_;
+
+    WorkItem item;
+    item.msg = msg;
+    push(route_[msg.locate], item);
+}
+
+bool ShardedEngine::migrate(uint16_t locate, size_t target_worker)
+{
+    if (target_worker >= workers_.size()) return false;
+    size_t from = route_[locate];
+    if (from == target_worker) return false;
+
+    // Reclaim slots of migrations that have finished
+    migrations_.erase(std::remove_if(migrations_.begin(), migrations_.end(),
+                                     [](const std::unique_ptr<Migration>& m) {
+                                         return m->complete.load(std::memory_order_acquire);
+                                     }),
+                      migrations_.end());
+
+    migrations_.push_back(std::make_unique<Migration>());
+    Migration* migration = migrations_.back().get();
+    migration->locate = locate;
+    migration->start_ns = now_ns();
+
+    WorkItem release;
+    release.kind = WorkItem::Kind::Release;
+    release.migration = migration;
+    release.msg.locate = locate;
+
+    WorkItem adopt = release;
+    adopt.kind = WorkItem::Kind::Adopt;
+
+    // Sequence boundary: nothing for this symbol is routed between these
+    push(from, release);
+    push(target_worker, adopt);
+    route_[locate] = static_cast<uint16_t>(target_worker);
+    return true;
+}
+
+bool ShardedEngine::rebalance()
+{
+    if (window_total_ < config_.min_window_messages) return false;
+
+    // One move at a time - loads measured mid-migration are misleading
+    for (const auto& m : migrations_)
+    {
+        if (!m->complete.load(std::memory_order_acquire)) return false;
+    }
+
+    std::vector<uint64_t> load(workers_.size(), 0);
+    for (uint16_t locate : active_locates_)
+    {
+        load[route_[locate]] += window_counts_[locate];
+    }
+
+    size_t busiest = static_cast<size_t>(std::max_element(load.begin(), load.end()) - load.begin());
+    size_t idlest = static_cast<size_t>(std::min_element(load.begin(), load.end()) - load.begin());
+    double mean = static_cast<double>(window_total_) / static_cast<double>(workers_.size());
+
+    bool moved = false;
+    if (busiest != idlest && static_cast<double>(load[busiest]) > config_.imbalance_threshold * mean)
+    {
+        // Pick the symbol whose move minimises the larger of the two resulting loads
+        uint64_t best_peak = load[busiest];
+        int best_locate = -1;
+        for (uint16_t locate : active_locates_)
+        {
+            if (route_[locate] != busiest) continue;
+            uint64_t rate = window_counts_[locate];
+            uint64_t peak = std::max(load[busiest] - rate, load[idlest] + rate);
+            if (peak < best_peak)
+            {
+                best_peak = peak;
+                best_locate = locate;
+            }
+        }
+        if (best_locate >= 0)
+        {
+            moved = migrate(static_cast<uint16_t>(best_locate), idlest);
+        }
+    }
+
+    // Start a fresh rate window
+    for (uint16_t locate : active_locates_) window_counts_[locate] = 0;
+    active_locates_.clear();
+    window_total_ = 0;
+    return moved;
+}
+
+void ShardedEngine::flush()
+{
+    for (auto& worker : workers_)
+    {
+        while (worker->applied.load(std::memory_order_acquire) != worker->pushed ||
+               worker->pending_count.load(std::memory_order_acquire) != 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+// ============================================================================
+// Worker Side
+// ============================================================================
+
+void ShardedEngine::worker_loop(Worker& worker)
+{
+    constexpr size_t BATCH = 256;
+    WorkItem item;
+
+    while (true)
+    {
+        bool did_work = false;
+        for (size_t i = 0; i < BATCH && worker.queue.try_pop(item); ++i)
+        {
+            handle_item(worker, item);
+            worker.applied.store(worker.applied.load(std::memory_order_relaxed) + 1,
+                                 std::memory_order_release);
+            did_work = true;
+        }
+
+        if (!worker.pending.empty()) did_work |= poll_pending(worker);
+
+        if (!did_work)
+        {
+            if (stop_.load(std::memory_order_acquire) && worker.queue.empty() &&
+                worker.pending.empty())
+            {
+                break;
+            }
+            std::this_thread::yield();
+        }
+    }
+}
+
+void ShardedEngine::apply(Worker& worker, const ITCHParser::ParseResult& msg)
+{
+    auto& slot = worker.books[msg.locate];
+    if (!slot) slot = std::make_unique<SymbolBook>();
+    slot->book.handle_message(msg);
+    ++worker.messages;
+}
+
+void ShardedEngine::handle_item(Worker& worker, const WorkItem& item)
+{
+    uint16_t locate = item.msg.locate;
+
+    switch (item.kind)
+    {
+        case WorkItem::Kind::Message:
+            if (worker.in_transit[locate])
+            {
+                for (auto& p : worker.pending)
+                {
+                    if (p.migration->locate == locate && !p.forward)
+                    {
+                        p.stash.push_back(item.msg);
+                        break;
+                    }
+                }
+                worker.migration_stats.messages_stashed++;
+            }
+            else
+            {
+                apply(worker, item.msg);
+            }
+            break;
+
+        case WorkItem::Kind::Release:
+            if (worker.in_transit[locate])
+            {
+                // Book still on its way here - pass it on once it lands
+                for (auto& p : worker.pending)
+                {
+                    if (p.migration->locate == locate && !p.forward)
+                    {
+                        p.forward = item.migration;
+                        break;
+                    }
+                }
+            }
+            else
+            {
+                auto& slot = worker.books[locate];
+                if (!slot) slot = std::make_unique<SymbolBook>();
+                item.migration->book.store(slot.release(), std::memory_order_release);
+            }
+            break;
+
+        case WorkItem::Kind::Adopt:
+            worker.in_transit[locate] = 1;
+            worker.pending.push_back(Worker::Pending{item.migration, nullptr, {}});
+            worker.pending_count.fetch_add(1, std::memory_order_relaxed);
+            poll_pending(worker);
+            break;
+    }
+}
+
+bool ShardedEngine::poll_pending(Worker& worker)
+{
+    bool progressed = false;
+
+    // In arrival order, so chained migrations of one symbol resolve in sequence
+    for (size_t i = 0; i < worker.pending.size();)
+    {
+        auto& p = worker.pending[i];
+        SymbolBook* arrived = p.migration->book.load(std::memory_order_acquire);
+        if (!arrived)
+        {
+            ++i;
+            continue;
+        }
+
+        uint16_t locate = p.migration->locate;
+        worker.books[locate].reset(arrived);
+        for (const auto& msg : p.stash) apply(worker, msg);
+
+        uint64_t pause = now_ns() - p.migration->start_ns;
+        auto& stats = worker.migration_stats;
+        stats.migrations++;
+        stats.total_pause_ns += pause;
+        stats.max_pause_ns = std::max(stats.max_pause_ns, pause);
+        stats.last_pause_ns = pause;
+
+        Migration* forward = p.forward;
+        p.migration->complete.store(true, std::memory_order_release);
+        worker.pending.erase(worker.pending.begin() + static_cast<std::ptrdiff_t>(i));
+
+        // Another pending entry for the same symbol (adopted again after a forward)?
+        bool still_in_transit = false;
+        for (const auto& other : worker.pending)
+        {
+            still_in_transit |= (other.migration->locate == locate);
+        }
+        worker.in_transit[locate] = still_in_transit ? 1 : 0;
+
+        if (forward)
+        {
+            forward->book.store(worker.books[locate].release(), std::memory_order_release);
+        }
+
+        worker.pending_count.fetch_sub(1, std::memory_order_release);
+        progressed = true;
+    }
+    return progressed;
+}
+
+// ============================================================================
+// Queries (after flush)
+// ============================================================================
+
+const OrderBook* ShardedEngine::find_book(uint16_t locate) const
+{
+    const auto& slot = workers_[route_[locate]]->books[locate];
+    return slot ? &slot->book : nullptr;
+}
+
+uint64_t ShardedEngine::worker_messages(size_t worker) const
+{
+    return workers_[worker]->messages;
+}
+
+ShardedEngine::MigrationStats ShardedEngine::get_migration_stats() const
+{
+    MigrationStats total;
+    for (const auto& worker : workers_)
+    {
+        const auto& s = worker->migration_stats;
+        total.migrations += s.migrations;
+        total.total_pause_ns += s.total_pause_ns;
+        total.max_pause_ns = std::max(total.max_pause_ns, s.max_pause_ns);
+        total.messages_stashed += s.messages_stashed;
+        if (s.last_pause_ns) total.last_pause_ns = s.last_pause_ns;
+    }
+    return total;
+}
@@ -0,0 +1,26 @@
+#include "subscription_filter.h"
+
+// ============================================================================
+// SubscriptionFilter Implementation
+// ============================================================================
+
+void SubscriptionFilter::mark_dropped(uint64_t order_id)
+{
+    uint64_t page = order_id / PAGE_BITS;
+    if (page >= MAX_PAGES)
+    {
+        overflow_.insert(order_id);
+        stats_.overflow_ids = overflow_.size();
+        return;
+    }
+
+    if (page >= pages_.size()) pages_.resize(page + 1);
+    if (!pages_[page])
+    {
+        pages_[page] = std::make_unique<uint64_t[]>(PAGE_BITS / 64);  // Zeroed
+        stats_.bitmap_pages++;
+    }
+
+    uint64_t bit = order_id % PAGE_BITS;
+    pages_[page][bit >> 6] |= 1ULL << (bit & 63);
+}
@@ -0,0 +1,125 @@
+#include "symbol_table.h"
+
+uint64_t SymbolTable::key(const char* symbol)
+{
+    uint8_t padded[8];
+    bool ended = false;
+    for (size_t i = 0; i < sizeof(padded); ++i)
+    {
+        ended = ended || symbol[i] == '\0';
+        padded[i] = ended ? ' ' : static_cast<uint8_t>(symbol[i]);
+    }
+    return key(padded);
+}
+
+SymbolTable::SymbolTable(size_t expected_symbols)
+{
+    size_t groups = 2;
+    while (groups * GROUP < 2 * expected_symbols) groups <<= 1;
+    rebuild(groups);
+}
+
+const char* SymbolTable::probe_isa()
+{
+#if defined(__AVX512F__)
+    return "avx512";
+#elif defined(__AVX2__)
+    return "avx2";
+#else
+    return "scalar";
+#endif
+}
+
+uint16_t SymbolTable::intern(uint64_t key)
+{
+    if (key == 0) return NONE;
+    uint16_t id = find(key);
+    if (id != NONE) return id;
+    if (keys_.size() > MAX_SYMBOLS) return NONE;
+
+    id = static_cast<uint16_t>(keys_.size());
+    keys_.push_back(key);
+    if (2 * size() > groups_.size() * GROUP)
+        rebuild(groups_.size() * 2);  // Re-places every key, this one included
+    else
+        place(key, id);
+    return id;
+}
+
+std::string SymbolTable::name(uint16_t id) const
+{
+    uint64_t k = key_of(id);
+    uint8_t bytes[8];
+    std::memcpy(bytes, &k, sizeof(bytes));
+    std::string out;
+    for (uint8_t b : bytes)
+    {
+        if (b == ' ' || b == 0) break;
+        out.push_back(static_cast<char>(b));
+    }
+    return out;
+}
+
+void SymbolTable::rebuild(size_t groups)
+{
+    groups_.assign(groups, Group{});
+    ids_.assign(groups * GROUP, NONE);
+    shift_ = 64;
+    for (size_t g = groups; g > 1; g >>= 1) --shift_;
+    for (size_t id = 1; id < keys_.size(); ++id) place(keys_[id], static_cast<uint16_t>(id));
+}
+
+void SymbolTable::place(uint64_t key, uint16_t id)
+{
+    size_t group = static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> shift_);
+    while (true)
+    {
+        Group& g = groups_[group];
+        for (size_t i = 0; i < GROUP; ++i)
+        {
+            if (g.keys[i] != 0) continue;
+            g.keys[i] = key;
+            ids_[group * GROUP + i] = id;
+            return;
+        }
+        group = (group + 1) & (groups_.size() - 1);
+    }
+}
+
+// ============================================================================
+// OrderSymbols Implementation
+// ============================================================================
+
+void OrderSymbols::on_add(uint64_t order_id, uint16_t symbol, uint32_t quantity)
+{
+    orders_[order_id] = Entry{quantity, symbol};
+}
+
+uint16_t OrderSymbols::on_cancel(uint64_t order_id)
+{
+    auto it = orders_.find(order_id);
+    if (it == orders_.end()) return SymbolTable::NONE;
+    uint16_t symbol = it->second.symbol;
+    orders_.erase(it);
+    return symbol;
+}
+
+// An over-execute still routes (the book rejects it) and leaves the entry as is
+uint16_t OrderSymbols::on_execute(uint64_t order_id, uint32_t quantity)
+{
+    auto it = orders_.find(order_id);
+    if (it == orders_.end()) return SymbolTable::NONE;
+    uint16_t symbol = it->second.symbol;
+    if (quantity == it->second.quantity)
+        orders_.erase(it);
+    else if (quantity < it->second.quantity)
+        it->second.quantity -= quantity;
+    return symbol;
+}
+
+uint16_t OrderSymbols::on_replace(uint64_t old_order_id, uint64_t new_order_id, uint32_t quantity)
+{
+    uint16_t symbol = on_cancel(old_order_id);
+    if (symbol != SymbolTable::NONE) on_add(new_order_id, symbol, quantity);
+    return symbol;
+}
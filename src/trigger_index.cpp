@@ -0,0 +1,167 @@
+#include "trigger_index.h"
+
+#include <algorithm>
+
+// ============================================================================
+// Registration
+// ============================================================================
+
+uint32_t TriggerIndex::arm(const Entry& entry)
+{
+    uint32_t id = next_id_++;
+    entries_.emplace(id, entry);
+    stats_.registered = entries_.size();
+    return id;
+}
+
+uint32_t TriggerIndex::add_best_price(Side side, uint32_t price, uint64_t tag)
+{
+    uint32_t id = arm(Entry{Kind::BestPrice, side, price, 0, tag});
+    best_[static_cast<size_t>(side)].emplace(rank(side, price), id);
+    return id;
+}
+
+uint32_t TriggerIndex::add_level_size_below(Side side, uint32_t price, uint64_t threshold, uint64_t tag)
+{
+    uint32_t id = arm(Entry{Kind::LevelSizeBelow, side, price, static_cast<int64_t>(threshold), tag});
+    auto& bucket = levels_[level_key(side, price)];
+    auto pos = std::upper_bound(bucket.begin(), bucket.end(), std::make_pair(threshold, id));
+    bucket.insert(pos, {threshold, id});
+    return id;
+}
+
+uint32_t TriggerIndex::add_spread_above(int64_t threshold, uint64_t tag)
+{
+    uint32_t id = arm(Entry{Kind::SpreadAbove, Side::Bid, 0, threshold, tag});
+    spread_.emplace(threshold, id);
+    return id;
+}
+
+bool TriggerIndex::remove(uint32_t id)
+{
+    auto it = entries_.find(id);
+    if (it == entries_.end()) return false;
+    const Entry& entry = it->second;
+
+    switch (entry.kind)
+    {
+        case Kind::BestPrice:
+        {
+            auto& map = best_[static_cast<size_t>(entry.side)];
+            auto range = map.equal_range(rank(entry.side, entry.price));
+            for (auto m = range.first; m != range.second; ++m)
+            {
+                if (m->second == id)
+                {
+                    map.erase(m);
+                    break;
+                }
+            }
+            break;
+        }
+        case Kind::SpreadAbove:
+        {
+            auto range = spread_.equal_range(entry.threshold);
+            for (auto m = range.first; m != range.second; ++m)
+            {
+                if (m->second == id)
+                {
+                    spread_.erase(m);
+                    break;
+                }
+            }
+            break;
+        }
+        case Kind::LevelSizeBelow:
+        {
+            auto bucket = levels_.find(level_key(entry.side, entry.price));
+            auto& v = bucket->second;
+            v.erase(std::find(v.begin(), v.end(),
+                              std::make_pair(static_cast<uint64_t>(entry.threshold), id)));
+            if (v.empty()) levels_.erase(bucket);
+            break;
+        }
+    }
+
+    entries_.erase(it);
+    stats_.registered = entries_.size();
+    stats_.removed++;
+    return true;
+}
+
+// ============================================================================
+// Evaluation
+// ============================================================================
+
+void TriggerIndex::fire(uint32_t id, Kind kind, Side side, uint32_t price, int64_t value)
+{
+    auto it = entries_.find(id);
+    pending_.push_back(Fired{id, it->second.tag, kind, side, price, value});
+    entries_.erase(it);
+}
+
+void TriggerIndex::deliver()
+{
+    if (pending_.empty()) return;
+    stats_.registered = entries_.size();
+    stats_.fired += pending_.size();
+
+    // Callbacks may re-enter (register, remove, or even trigger evaluation)
+    std::vector<Fired> batch;
+    batch.swap(pending_);
+    if (callback_)
+    {
+        for (const Fired& fired : batch) callback_(fired);
+    }
+    if (pending_.empty())
+    {
+        batch.clear();
+        pending_.swap(batch);  // Keep the capacity
+    }
+}
+
+void TriggerIndex::on_best_price(Side side, uint32_t best)
+{
+    auto& map = best_[static_cast<size_t>(side)];
+    if (map.empty()) return;
+    stats_.evaluations++;
+
+    // Satisfied: rank(trigger) <= rank(best), i.e. the head of the map
+    auto end = map.upper_bound(rank(side, best));
+    if (end == map.begin()) return;
+    for (auto it = map.begin(); it != end; ++it)
+    {
+        fire(it->second, Kind::BestPrice, side, best, 0);
+    }
+    map.erase(map.begin(), end);
+}
+
+void TriggerIndex::on_spread(int64_t spread)
+{
+    if (spread_.empty()) return;
+    stats_.evaluations++;
+
+    auto end = spread_.lower_bound(spread);  // Thresholds < spread
+    if (end == spread_.begin()) return;
+    for (auto it = spread_.begin(); it != end; ++it)
+    {
+        fire(it->second, Kind::SpreadAbove, Side::Bid, 0, spread);
+    }
+    spread_.erase(spread_.begin(), end);
+}
+
+void TriggerIndex::on_level(Side side, uint32_t price, uint64_t total)
+{
+    auto bucket = levels_.find(level_key(side, price));
+    if (bucket == levels_.end()) return;
+    stats_.evaluations++;
+
+    auto& v = bucket->second;
+    if (v.back().first <= total) return;
+    while (!v.empty() && v.back().first > total)
+    {
+        fire(v.back().second, Kind::LevelSizeBelow, side, price, static_cast<int64_t>(total));
+        v.pop_back();
+    }
+    if (v.empty()) levels_.erase(bucket);
+}
@@ -0,0 +1,164 @@
+#include "warmup.h"
+
+#include <chrono>
+
+#include "message_builder.h"
+
+// ============================================================================
+// BookWarmer Implementation
+// ============================================================================
+
+static uint64_t now_ns()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+BookWarmer::BookWarmer() : BookWarmer(Config{}) {}
+
+BookWarmer::BookWarmer(const Config& config) : config_(config), shadow_(fabric_)
+{
+    if (config_.orders == 0) config_.orders = 1;
+    if (config_.tick == 0) config_.tick = 1;
+    if (config_.levels * config_.tick >= config_.mid_price) config_.levels = config_.mid_price / config_.tick - 1;
+    if (config_.levels == 0) config_.levels = 1;
+    build_script();
+}
+
+void BookWarmer::warm_up(OrderBook* live)
+{
+    uint64_t start = now_ns();
+    if (live && config_.reserve_orders > 0) live->reserve(config_.reserve_orders, config_.reserve_levels);
+
+    size_t messages = config_.warm_up_cycles * script_.size();
+    feed(messages);
+    if (live) touch(*live);
+
+    stats_.warm_up_messages += messages;
+    stats_.warm_up_ns += now_ns() - start;
+    last_run_ns_ = now_ns();
+}
+
+bool BookWarmer::keep_warm(const OrderBook* live)
+{
+    uint64_t start = now_ns();
+    if (start - last_run_ns_ < config_.keep_warm_interval_ns)
+    {
+        stats_.keep_warm_skipped++;
+        return false;
+    }
+
+    feed(config_.keep_warm_messages);
+    if (live) touch(*live);
+
+    last_run_ns_ = now_ns();
+    stats_.keep_warm_runs++;
+    stats_.keep_warm_messages += config_.keep_warm_messages;
+    stats_.keep_warm_ns += last_run_ns_ - start;
+    return true;
+}
+
+void BookWarmer::feed(size_t messages)
+{
+    for (size_t i = 0; i < messages; ++i)
+    {
+        fabric_.write_chunk(script_[cursor_]);
+        shadow_.process();
+        if (++cursor_ == script_.size()) cursor_ = 0;
+    }
+    const OrderBook::ErrorStats& errors = shadow_.get_error_stats();
+    stats_.shadow_errors = errors.invalid_operations + errors.off_grid_prices;
+}
+
+// The live book's market data path: touch prices, level sizes, spread
+void BookWarmer::touch(const OrderBook& live)
+{
+    uint64_t price = 0;
+    uint64_t qty = 0;
+    uint64_t sum = 0;
+    if (live.get_best_bid(price, qty)) sum += price + live.get_level_quantity(Side::Bid, static_cast<uint32_t>(price));
+    if (live.get_best_ask(price, qty)) sum += price + live.get_level_quantity(Side::Ask, static_cast<uint32_t>(price));
+    if (live.get_spread(price)) sum += price;
+    touched_ += sum;
+}
+
+// Build-up, churn at a steady population, tear-down to an empty book
+void BookWarmer::build_script()
+{
+    struct Resting
+    {
+        uint64_t id;
+        uint32_t qty;
+        char side;
+    };
+
+    uint64_t rng = config_.seed ? config_.seed : 0x9E3779B97F4A7C15ULL;
+    auto below = [&rng](uint64_t bound) {
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        return static_cast<uint32_t>(rng % bound);
+    };
+    auto level_price = [this, &below](char side) {
+        uint32_t offset = config_.tick * (1 + below(config_.levels));
+        return side == 'B' ? config_.mid_price - offset : config_.mid_price + offset;
+    };
+
+    std::vector<Resting> live;
+    live.reserve(config_.orders);
+    uint64_t next_id = 1;
+    uint64_t timestamp = 14400000000000ULL;  // 04:00:00, pre-market
+
+    auto add = [&]() {
+        char side = below(2) ? 'B' : 'S';
+        uint32_t qty = 100 * (1 + below(10));
+        timestamp += 1 + below(500);
+        if (below(8) == 0)
+            script_.push_back(MessageBuilder::build_add_order_mpid(next_id, level_price(side), qty, side, timestamp, "WARM"));
+        else
+            script_.push_back(MessageBuilder::build_add_order(next_id, level_price(side), qty, side, timestamp));
+        live.push_back(Resting{next_id++, qty, side});
+    };
+
+    while (live.size() < config_.orders) add();
+
+    for (size_t op = 0; op < 2 * config_.orders; ++op)
+    {
+        size_t pick = below(live.size());
+        Resting& order = live[pick];
+        uint32_t roll = below(100);
+        timestamp += 1 + below(500);
+
+        if (roll < 35 && order.qty > 100)
+        {
+            script_.push_back(MessageBuilder::build_execute_order(order.id, 100));
+            order.qty -= 100;
+            continue;
+        }
+        if (roll < 70)
+        {
+            script_.push_back(MessageBuilder::build_replace_order(order.id, next_id, level_price(order.side),
+                                                                  order.qty, timestamp));
+            order.id = next_id++;
+            continue;
+        }
+
+        // Cancel or execute in full, then refill to keep the population
+        if (roll < 85)
+            script_.push_back(MessageBuilder::build_cancel_order(order.id));
+        else
+            script_.push_back(MessageBuilder::build_execute_order(order.id, order.qty));
+        live[pick] = live.back();
+        live.pop_back();
+        add();
+    }
+
+    while (!live.empty())
+    {
+        size_t pick = below(live.size());
+        script_.push_back(MessageBuilder::build_cancel_order(live[pick].id));
+        live[pick] = live.back();
+        live.pop_back();
+    }
+}